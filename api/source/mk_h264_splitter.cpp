@@ -11,6 +11,7 @@
 #include "mk_h264_splitter.h"
 #include "Http/HttpRequestSplitter.h"
 #include "Extension/Factory.h"
+#include "Extension/StartCode.h"
 
 using namespace mediakit;
 
@@ -58,17 +59,19 @@ ssize_t H264Splitter::onRecvHeader(const char *data, size_t len) {
 }
 
 const char *H264Splitter::onSearchPacketTail(const char *data, size_t len) {
-    for (size_t i = 2; len > 2 && i < len - 2; ++i) {
-        //判断0x00 00 01
-        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
-            if (i > 0 && data[i - 1] == 0) {
-                //找到0x00 00 00 01
-                return data + i - 1;
-            }
-            return data + i;
-        }
+    if (len <= 4) {
+        return nullptr;
     }
-    return nullptr;
+    //跳过本帧的起始码，查找0x00 00 01
+    auto pos = findStartCode(data + 2, data + len);
+    if (!pos) {
+        return nullptr;
+    }
+    if (pos[-1] == 0) {
+        //找到0x00 00 00 01
+        return pos - 1;
+    }
+    return pos;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
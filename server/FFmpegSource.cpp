@@ -12,6 +12,7 @@
 #include "Common/config.h"
 #include "Common/MediaSource.h"
 #include "Common/MultiMediaSourceMuxer.h"
+#include "Codec/Transcode.h"
 #include "Util/File.h"
 #include "System.h"
 #include "Thread/WorkThreadPool.h"
@@ -28,6 +29,11 @@ const string kCmd = FFmpeg_FIELD"cmd";
 const string kLog = FFmpeg_FIELD"log";
 const string kSnap = FFmpeg_FIELD"snap";
 const string kRestartSec = FFmpeg_FIELD"restart_sec";
+const string kSnapInProcess = FFmpeg_FIELD"snap_in_process";
+const string kSnapWorkers = FFmpeg_FIELD"snap_workers";
+const string kSnapDecodeThreads = FFmpeg_FIELD"snap_decode_threads";
+const string kSnapThreadType = FFmpeg_FIELD"snap_thread_type";
+const string kSnapQScale = FFmpeg_FIELD"snap_qscale";
 
 onceToken token([]() {
 #ifdef _WIN32
@@ -42,6 +48,11 @@ onceToken token([]() {
     mINI::Instance()[kCmd] = "%s -re -i %s -c:a aac -strict -2 -ar 44100 -ab 48k -c:v libx264 -f flv %s";
     mINI::Instance()[kSnap] = "%s -i %s -y -f mjpeg -frames:v 1 -an %s";
     mINI::Instance()[kRestartSec] = 0;
+    mINI::Instance()[kSnapInProcess] = 1;
+    mINI::Instance()[kSnapWorkers] = 2;
+    mINI::Instance()[kSnapDecodeThreads] = 2;
+    mINI::Instance()[kSnapThreadType] = "slice";
+    mINI::Instance()[kSnapQScale] = 5;
 });
 }
 
@@ -347,3 +358,193 @@ void FFmpegSnap::makeSnap(const string &play_url, const string &save_path, float
         cb(success, (!success && !log_file.empty()) ? File::loadFile(log_file) : "");
     });
 }
+
+#if defined(ENABLE_FFMPEG)
+
+struct FFmpegSnapService::SnapTask {
+    Track::Ptr track;
+    vector<Frame::Ptr> frames;
+    string save_path;
+    FFmpegSnap::onSnap cb;
+};
+
+// 同一编码格式一次最多批量处理的截图个数，防止其他编码格式的请求等待太久
+static constexpr size_t kMaxSnapBatch = 32;
+
+static int getSnapThreadType() {
+    GET_CONFIG(string, thread_type, FFmpeg::kSnapThreadType);
+    if (thread_type == "slice") {
+        return FF_THREAD_SLICE;
+    }
+    if (thread_type == "frame") {
+        return FF_THREAD_FRAME;
+    }
+    return 0;
+}
+
+FFmpegSnapService &FFmpegSnapService::Instance() {
+    static FFmpegSnapService s_instance;
+    return s_instance;
+}
+
+FFmpegSnapService::FFmpegSnapService() {
+    GET_CONFIG(uint32_t, workers, FFmpeg::kSnapWorkers);
+    for (size_t i = 0; i < MAX(workers, 1u); ++i) {
+        _threads.emplace_back([this, i]() { run(i); });
+    }
+}
+
+FFmpegSnapService::~FFmpegSnapService() {
+    {
+        lock_guard<mutex> lck(_mtx);
+        _exit = true;
+    }
+    _cond.notify_all();
+    for (auto &th : _threads) {
+        th.join();
+    }
+}
+
+bool FFmpegSnapService::makeSnap(const string &play_url, const string &save_path, float timeout_sec, const FFmpegSnap::onSnap &cb) {
+    MediaInfo info(play_url);
+    if (!is_local_ip(info.host)) {
+        return false;
+    }
+    auto src = MediaSource::find(info.vhost, info.app, info.stream);
+    auto muxer = src ? src->getMuxer() : nullptr;
+    if (!muxer) {
+        return false;
+    }
+    Track::Ptr video;
+    for (auto &track : src->getTracks(true)) {
+        if (track->getTrackType() == TrackVideo) {
+            video = track->clone();
+            break;
+        }
+    }
+    if (!video) {
+        return false;
+    }
+
+    // 超时与截图完成只回调一次
+    auto done = std::make_shared<atomic<bool> >(false);
+    // 超时任务只在poller线程中访问
+    auto timeout_task = std::make_shared<EventPoller::DelayTask::Ptr>();
+    auto poller = muxer->getOwnerPoller(MediaSource::NullMediaSource());
+    auto on_snap = [done, cb, timeout_task, poller](bool success, const string &err_msg) {
+        if (done->exchange(true)) {
+            return;
+        }
+        cb(success, err_msg);
+        // 取消超时任务，同时解除超时任务对本回调的引用
+        poller->async([timeout_task]() {
+            if (*timeout_task) {
+                (*timeout_task)->cancel();
+                *timeout_task = nullptr;
+            }
+        }, false);
+    };
+
+    weak_ptr<MultiMediaSourceMuxer> weak_muxer = muxer;
+    poller->async([weak_muxer, video, save_path, on_snap, timeout_task, timeout_sec, poller]() {
+        auto muxer = weak_muxer.lock();
+        if (!muxer) {
+            on_snap(false, "media source released");
+            return;
+        }
+        auto waiter_id = muxer->getKeyFrame([video, save_path, on_snap](const vector<Frame::Ptr> &frames) {
+            if (frames.empty()) {
+                on_snap(false, "media source has no video key frame");
+                return;
+            }
+            auto task = std::make_shared<SnapTask>();
+            task->track = video;
+            task->frames = frames;
+            task->save_path = save_path;
+            task->cb = on_snap;
+            FFmpegSnapService::Instance().addTask(std::move(task));
+        });
+        *timeout_task = poller->doDelayTask((uint64_t)(timeout_sec * 1000), [weak_muxer, waiter_id, on_snap]() {
+            on_snap(false, "wait key frame or decode snap timeout");
+            // 不再等待关键帧，否则该请求一直占用muxer并使其保持输入帧
+            auto muxer = weak_muxer.lock();
+            if (muxer && waiter_id) {
+                muxer->cancelKeyFrame(waiter_id);
+            }
+            return 0;
+        });
+    });
+    return true;
+}
+
+void FFmpegSnapService::addTask(std::shared_ptr<SnapTask> task) {
+    {
+        lock_guard<mutex> lck(_mtx);
+        _tasks.emplace_back(std::move(task));
+    }
+    _cond.notify_one();
+}
+
+static void decodeSnap(FFmpegDecoder::Ptr &decoder, const FFmpegSnapService::SnapTask &task) {
+    GET_CONFIG(int, decode_threads, FFmpeg::kSnapDecodeThreads);
+    GET_CONFIG(int, qscale, FFmpeg::kSnapQScale);
+    try {
+        if (!decoder) {
+            decoder = std::make_shared<FFmpegDecoder>(task.track, decode_threads, std::vector<std::string>(), getSnapThreadType());
+        }
+        FFmpegFrame::Ptr image;
+        decoder->setOnDecode([&image](const FFmpegFrame::Ptr &frame) {
+            if (!image) {
+                image = frame;
+            }
+        });
+        for (auto &frame : task.frames) {
+            decoder->inputFrame(frame, false, false);
+        }
+        // 输出解码器中缓存的帧，并重置解码器以便解码其他流的关键帧
+        decoder->flush();
+        decoder->setOnDecode(nullptr);
+        if (!image) {
+            task.cb(false, "decode key frame failed");
+            return;
+        }
+        auto ret = FFmpegUtils::saveFrame(image, task.save_path.data(), qscale);
+        task.cb(std::get<0>(ret), std::get<1>(ret));
+    } catch (std::exception &ex) {
+        // 解码器可能处于异常状态，下次重新创建
+        decoder = nullptr;
+        task.cb(false, ex.what());
+    }
+}
+
+void FFmpegSnapService::run(size_t index) {
+    setThreadName(("snap decoder " + to_string(index)).data());
+    // 每个线程按照编码格式缓存解码器，同一编码格式的截图复用解码器
+    unordered_map<int, FFmpegDecoder::Ptr> decoders;
+    while (true) {
+        vector<std::shared_ptr<SnapTask> > batch;
+        {
+            unique_lock<mutex> lck(_mtx);
+            _cond.wait(lck, [this]() { return _exit || !_tasks.empty(); });
+            if (_exit) {
+                return;
+            }
+            // 取出与队首编码格式相同的请求批量解码
+            auto codec = _tasks.front()->track->getCodecId();
+            for (auto it = _tasks.begin(); it != _tasks.end() && batch.size() < kMaxSnapBatch;) {
+                if ((*it)->track->getCodecId() == codec) {
+                    batch.emplace_back(std::move(*it));
+                    it = _tasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        auto &decoder = decoders[batch.front()->track->getCodecId()];
+        for (auto &task : batch) {
+            decodeSnap(decoder, *task);
+        }
+    }
+}
+
+#endif // ENABLE_FFMPEG
@@ -12,8 +12,11 @@
 #define FFMPEG_SOURCE_H
 
 #include <mutex>
+#include <deque>
+#include <thread>
 #include <memory>
 #include <functional>
+#include <condition_variable>
 #include "Process.h"
 #include "Util/TimeTicker.h"
 #include "Common/MediaSource.h"
@@ -21,6 +24,7 @@
 namespace FFmpeg {
     extern const std::string kSnap;
     extern const std::string kBin;
+    extern const std::string kSnapInProcess;
 }
 
 class FFmpegSnap {
@@ -38,6 +42,41 @@ private:
     ~FFmpegSnap() = delete;
 };
 
+#if defined(ENABLE_FFMPEG)
+/**
+ * 进程内截图服务，解码本服务器上的流最近的关键帧并编码为jpeg，避免每次截图都启动FFmpeg进程
+ * 所有截图共享一个解码线程池，同一编码格式的请求批量处理并复用解码器
+ */
+class FFmpegSnapService {
+public:
+    struct SnapTask;
+
+    static FFmpegSnapService &Instance();
+
+    /// 创建截图
+    /// \param play_url 播放url地址，必须为本服务器上的流
+    /// \param save_path 截图jpeg文件保存路径
+    /// \param timeout_sec 生成截图超时时间(等待关键帧与解码的总时间)
+    /// \param cb 生成截图成功与否回调
+    /// \return 流不在本服务器上或者没有视频时返回false，此时不触发回调
+    bool makeSnap(const std::string &play_url, const std::string &save_path, float timeout_sec, const FFmpegSnap::onSnap &cb);
+
+private:
+    FFmpegSnapService();
+    ~FFmpegSnapService();
+
+    void addTask(std::shared_ptr<SnapTask> task);
+    void run(size_t index);
+
+private:
+    bool _exit = false;
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    std::deque<std::shared_ptr<SnapTask> > _tasks;
+    std::vector<std::thread> _threads;
+};
+#endif // ENABLE_FFMPEG
+
 class FFmpegSource : public std::enable_shared_from_this<FFmpegSource> , public mediakit::MediaSourceEventInterceptor{
 public:
     using Ptr = std::shared_ptr<FFmpegSource>;
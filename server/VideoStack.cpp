@@ -29,101 +29,68 @@ Param::~Param()
         id, width, height, pixfmt);
 }
 
+static mediakit::YuvImage toYuvImage(const mediakit::FFmpegFrame::Ptr& frame)
+{
+    mediakit::YuvImage img;
+    auto f = frame->get();
+    img.format = f->format == AV_PIX_FMT_NV12 ? mediakit::YuvImage::NV12 : mediakit::YuvImage::I420;
+    img.width = f->width;
+    img.height = f->height;
+    for (int i = 0; i < 3; i++) {
+        img.data[i] = f->data[i];
+        img.linesize[i] = f->linesize[i];
+    }
+    return img;
+}
+
 Channel::Channel(const std::string& id, int width, int height, AVPixelFormat pixfmt)
     : _id(id)
     , _width(width)
     , _height(height)
     , _pixfmt(pixfmt)
 {
-    _tmp = std::make_shared<mediakit::FFmpegFrame>();
-
-    _tmp->get()->width = _width;
-    _tmp->get()->height = _height;
-    _tmp->get()->format = _pixfmt;
-
-    av_frame_get_buffer(_tmp->get(), 32);
-
-    memset(_tmp->get()->data[0], 0, _tmp->get()->linesize[0] * _height);
-    memset(_tmp->get()->data[1], 0, _tmp->get()->linesize[1] * _height / 2);
-    memset(_tmp->get()->data[2], 0, _tmp->get()->linesize[2] * _height / 2);
-
-    auto frame = VideoStackManager::Instance().getBgImg();
+    if (_pixfmt != AV_PIX_FMT_YUV420P && _pixfmt != AV_PIX_FMT_NV12) {
+        WarnL << "No support pixformat: " << av_get_pix_fmt_name(_pixfmt) << ", use yuv420p instead";
+        _pixfmt = AV_PIX_FMT_YUV420P;
+    }
     _sws = std::make_shared<mediakit::FFmpegSws>(_pixfmt, _width, _height);
-
-    _tmp = _sws->inputFrame(frame);
-}
-
-void Channel::addParam(const std::weak_ptr<Param>& p)
-{
-    std::lock_guard<std::recursive_mutex> lock(_mx);
-    _params.push_back(p);
+    // 收到画面前显示背景图片
+    onFrame(VideoStackManager::Instance().getBgImg());
 }
 
 void Channel::onFrame(const mediakit::FFmpegFrame::Ptr& frame)
 {
-    std::weak_ptr<Channel> weakSelf = shared_from_this();
-    _poller = _poller ? _poller : toolkit::WorkThreadPool::Instance().getPoller();
-    _poller->async([weakSelf, frame]() {
-        auto self = weakSelf.lock();
-        if (!self) {
-            return;
-        }
-        self->_tmp = self->_sws->inputFrame(frame);
-
-        self->forEachParam([self](const Param::Ptr& p) { self->fillBuffer(p); });
-    });
-}
-
-void Channel::forEachParam(const std::function<void(const Param::Ptr&)>& func)
-{
-    for (auto& wp : _params) {
-        if (auto sp = wp.lock()) {
-            func(sp);
-        }
+    if (!frame) {
+        return;
     }
+    std::lock_guard<std::mutex> lock(_mx);
+    _src = frame;
+    ++_seq;
 }
 
-void Channel::fillBuffer(const Param::Ptr& p)
+uint64_t Channel::getSeq()
 {
-    if (auto buf = p->weak_buf.lock()) {
-        copyData(buf, p);
-    }
+    std::lock_guard<std::mutex> lock(_mx);
+    return _seq;
 }
 
-void Channel::copyData(const mediakit::FFmpegFrame::Ptr& buf, const Param::Ptr& p)
+mediakit::FFmpegFrame::Ptr Channel::getFrame(uint64_t& seq)
 {
-
-    switch (p->pixfmt) {
-    case AV_PIX_FMT_YUV420P: {
-        for (int i = 0; i < p->height; i++) {
-            memcpy(buf->get()->data[0] + buf->get()->linesize[0] * (i + p->posY) + p->posX,
-                _tmp->get()->data[0] + _tmp->get()->linesize[0] * i,
-                _tmp->get()->width);
-        }
-        //确保height为奇数时，也能正确的复制到最后一行uv数据
-        for (int i = 0; i < (p->height + 1) / 2; i++) {
-            // U平面
-            memcpy(buf->get()->data[1] + buf->get()->linesize[1] * (i + p->posY / 2) + p->posX / 2,
-                _tmp->get()->data[1] + _tmp->get()->linesize[1] * i,
-                _tmp->get()->width / 2);
-
-            // V平面
-            memcpy(buf->get()->data[2] + buf->get()->linesize[2] * (i + p->posY / 2) + p->posX / 2,
-                _tmp->get()->data[2] + _tmp->get()->linesize[2] * i,
-                _tmp->get()->width / 2);
-        }
-        break;
-    }
-    case AV_PIX_FMT_NV12: {
-        //TODO: 待实现
-        break;
+    mediakit::FFmpegFrame::Ptr src;
+    {
+        std::lock_guard<std::mutex> lock(_mx);
+        src = _src;
+        seq = _seq;
     }
 
-    default:
-        WarnL << "No support pixformat: " << av_get_pix_fmt_name(p->pixfmt);
-        break;
+    std::lock_guard<std::mutex> lock(_sws_mx);
+    if (src && _scaled_seq != seq) {
+        _tmp = _sws->inputFrame(src);
+        _scaled_seq = seq;
     }
+    return _tmp;
 }
+
 void StackPlayer::addChannel(const std::weak_ptr<Channel>& chn)
 {
     std::lock_guard<std::recursive_mutex> lock(_mx);
@@ -275,55 +242,90 @@ VideoStack::VideoStack(const std::string& id, int width, int height, AVPixelForm
     //dev->initAudio();         //TODO:音频
     _dev->addTrackCompleted();
 
-    _isExit = false;
+    // 合成与编码都在该线程执行，布局修改也切换到该线程，避免与合成冲突
+    _poller = toolkit::WorkThreadPool::Instance().getPoller();
 }
 
 VideoStack::~VideoStack()
 {
-    _isExit = true;
-    if (_thread.joinable()) {
-        _thread.join();
-    }
+    _timer = nullptr;
 }
 
 void VideoStack::setParam(const Params& params)
 {
-    if (_params) {
-        for (auto& p : (*_params)) {
-            if (!p)
-                continue;
-            p->weak_buf.reset();
-        }
-    }
-
-    initBgColor();
-    for (auto& p : (*params)) {
-        if (!p)
-            continue;
-        p->weak_buf = _buffer;
-        if (auto chn = p->weak_chn.lock()) {
-            chn->addParam(p);
-            chn->fillBuffer(p);
+    std::weak_ptr<VideoStack> weakSelf = shared_from_this();
+    _poller->async([weakSelf, params]() {
+        auto self = weakSelf.lock();
+        if (!self) {
+            return;
         }
-    }
-    _params = params;
+        // 新布局的画面序号都为0，下次合成时全部重新拷贝
+        self->initBgColor();
+        self->_params = params;
+    });
 }
 
 void VideoStack::start()
 {
-    _thread = std::thread([&]() {
-        uint64_t pts = 0;
-        int frameInterval = 1000 / _fps;
-        auto lastEncTP = std::chrono::steady_clock::now();
-        while (!_isExit) {
-            if (std::chrono::steady_clock::now() - lastEncTP > std::chrono::milliseconds(frameInterval)) {
-                lastEncTP = std::chrono::steady_clock::now();
-
-                _dev->inputYUV((char**)_buffer->get()->data, _buffer->get()->linesize, pts);
-                pts += frameInterval;
+    std::weak_ptr<VideoStack> weakSelf = shared_from_this();
+    _ticker.resetTime();
+    // 定时器间隔按毫秒取整，以半帧间隔检查，由onTick按照实际流逝时间决定是否出帧
+    _timer = std::make_shared<mediakit::WheelTimer>(
+        0.5f / _fps, [weakSelf]() {
+            auto self = weakSelf.lock();
+            if (!self) {
+                return false;
             }
+            self->onTick();
+            return true;
+        },
+        _poller);
+}
+
+void VideoStack::onTick()
+{
+    // 时间戳按照帧率递增，合成编码耗时过长导致落后时跳过落后的帧
+    auto expect = (uint64_t)(_ticker.elapsedTime() * _fps / 1000);
+    if (_frameIndex > expect) {
+        // 还未到下一帧的时间
+        return;
+    }
+    if (expect > _frameIndex + 1) {
+        _frameIndex = expect;
+    }
+    auto pts = (uint64_t)(_frameIndex++ * 1000 / _fps);
+
+    compose();
+    _dev->inputYUV((char**)_buffer->get()->data, _buffer->get()->linesize, pts);
+}
+
+void VideoStack::compose()
+{
+    if (!_params) {
+        return;
+    }
+    auto canvas = toYuvImage(_buffer);
+    std::vector<mediakit::TileScheduler::Job> jobs;
+    for (auto& p : (*_params)) {
+        if (!p) {
+            continue;
         }
-    });
+        auto chn = p->weak_chn.lock();
+        if (!chn || chn->getSeq() == p->seq) {
+            // 画面没有变化，画布上保留上次的内容
+            continue;
+        }
+        // 各个格子互不重叠，缩放与拷贝可以并行执行
+        jobs.emplace_back([p, chn, canvas]() {
+            uint64_t seq;
+            auto frame = chn->getFrame(seq);
+            if (frame) {
+                p->seq = seq;
+                mediakit::blitYuv(canvas, p->posX, p->posY, toYuvImage(frame));
+            }
+        });
+    }
+    mediakit::TileScheduler::Instance().run(jobs);
 }
 
 void VideoStack::initBgColor()
@@ -333,13 +335,7 @@ void VideoStack::initBgColor()
     auto G = 20;
     auto B = 20;
 
-    double Y = RGB_TO_Y(R, G, B);
-    double U = RGB_TO_U(R, G, B);
-    double V = RGB_TO_V(R, G, B);
-
-    memset(_buffer->get()->data[0], Y, _buffer->get()->linesize[0] * _height);
-    memset(_buffer->get()->data[1], U, _buffer->get()->linesize[1] * _height / 2);
-    memset(_buffer->get()->data[2], V, _buffer->get()->linesize[2] * _height / 2);
+    mediakit::fillYuv(toYuvImage(_buffer), RGB_TO_Y(R, G, B), RGB_TO_U(R, G, B), RGB_TO_V(R, G, B));
 }
 
 Channel::Ptr VideoStackManager::getChannel(const std::string& id,
@@ -1,8 +1,11 @@
 ﻿#pragma once
 #if defined(ENABLE_VIDEOSTACK) && defined(ENABLE_X264) && defined(ENABLE_FFMPEG)
 #include "Codec/Transcode.h"
+#include "Codec/Compositor.h"
 #include "Common/Device.h"
+#include "Common/TimerWheel.h"
 #include "Player/MediaPlayer.h"
+#include "Util/TimeTicker.h"
 #include "json/json.h"
 #include <mutex>
 template <typename T>
@@ -44,7 +47,8 @@ struct Param {
 
     // runtime
     std::weak_ptr<Channel> weak_chn;
-    std::weak_ptr<mediakit::FFmpegFrame> weak_buf;
+    // 最近一次拷贝到画布的画面序号
+    uint64_t seq = 0;
 
     ~Param();
 };
@@ -57,16 +61,21 @@ class Channel : public std::enable_shared_from_this<Channel> {
 
     Channel(const std::string& id, int width, int height, AVPixelFormat pixfmt);
 
-    void addParam(const std::weak_ptr<Param>& p);
-
+    /**
+     * 输入解码后的画面，只保存最新一帧，合成时才缩放
+     */
     void onFrame(const mediakit::FFmpegFrame::Ptr& frame);
 
-    void fillBuffer(const Param::Ptr& p);
-
- protected:
-    void forEachParam(const std::function<void(const Param::Ptr&)>& func);
+    /**
+     * 最新画面的序号，每输入一帧加1
+     */
+    uint64_t getSeq();
 
-    void copyData(const mediakit::FFmpegFrame::Ptr& buf, const Param::Ptr& p);
+    /**
+     * 获取缩放后的最新画面，同一帧只缩放一次
+     * @param seq 返回画面序号
+     */
+    mediakit::FFmpegFrame::Ptr getFrame(uint64_t& seq);
 
  private:
     std::string _id;
@@ -74,13 +83,15 @@ class Channel : public std::enable_shared_from_this<Channel> {
     int _height;
     AVPixelFormat _pixfmt;
 
-    mediakit::FFmpegFrame::Ptr _tmp;
-
-    std::recursive_mutex _mx;
-    std::vector<std::weak_ptr<Param>> _params;
+    std::mutex _mx;
+    uint64_t _seq = 0;
+    mediakit::FFmpegFrame::Ptr _src;
 
+    // 缩放在合成线程执行，可能被多个合成器同时请求
+    std::mutex _sws_mx;
+    uint64_t _scaled_seq = 0;
+    mediakit::FFmpegFrame::Ptr _tmp;
     mediakit::FFmpegSws::Ptr _sws;
-    toolkit::EventPoller::Ptr _poller;
 };
 
 class StackPlayer : public std::enable_shared_from_this<StackPlayer> {
@@ -115,7 +126,7 @@ class StackPlayer : public std::enable_shared_from_this<StackPlayer> {
     std::vector<std::weak_ptr<Channel>> _channels;
 };
 
-class VideoStack {
+class VideoStack : public std::enable_shared_from_this<VideoStack> {
  public:
     using Ptr = std::shared_ptr<VideoStack>;
 
@@ -128,13 +139,23 @@ class VideoStack {
 
     ~VideoStack();
 
+    /**
+     * 设置布局，在合成线程生效
+     */
     void setParam(const Params& params);
 
+    /**
+     * 按照帧率定时合成并编码
+     */
     void start();
 
  protected:
     void initBgColor();
 
+    void onTick();
+
+    void compose();
+
  public:
     Params _params;
 
@@ -150,9 +171,11 @@ class VideoStack {
 
     mediakit::DevChannel::Ptr _dev;
 
-    bool _isExit;
-
-    std::thread _thread;
+    // 按照帧率计算的下一帧序号
+    uint64_t _frameIndex = 0;
+    toolkit::Ticker _ticker;
+    toolkit::EventPoller::Ptr _poller;
+    mediakit::WheelTimer::Ptr _timer;
 };
 
 class VideoStackManager {
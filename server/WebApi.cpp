@@ -21,6 +21,7 @@
 #include <functional>
 #include <unordered_map>
 #include <regex>
+#include <sstream>
 #include "Util/MD5.h"
 #include "Util/util.h"
 #include "Util/File.h"
@@ -41,12 +42,19 @@
 
 #include "Common/config.h"
 #include "Common/MediaSource.h"
+#include "Common/UdpBatchSender.h"
+#include "Common/UdpBatchReceiver.h"
+#include "Common/Metrics.h"
+#include "Common/TimerWheel.h"
+#include "Common/PacketPool.h"
 #include "Http/HttpSession.h"
 #include "Http/HttpRequester.h"
 #include "Player/PlayerProxy.h"
 #include "Pusher/PusherProxy.h"
 #include "Rtp/RtpProcess.h"
 #include "Record/MP4Reader.h"
+#include "Record/HlsMediaSource.h"
+#include "Record/DiskWriter.h"
 
 #if defined(ENABLE_RTPPROXY)
 #include "Rtp/RtpServer.h"
@@ -423,6 +431,11 @@ Value makeMediaSourceJson(MediaSource &media){
     //getLossRate有线程安全问题；使用getMediaInfo接口才能获取丢包率；getMediaList接口将忽略丢包率
     auto current_thread = false;
     try { current_thread = media.getOwnerPoller()->isCurrentThread();} catch (...) {}
+    if (current_thread) {
+        //共享gop缓存只能在归属线程访问
+        auto muxer = media.getMuxer();
+        item["gopCacheBytes"] = (Json::UInt64) (muxer ? muxer->getGopCacheBytes() : 0);
+    }
     float last_loss = -1;
     for(auto &track : media.getTracks(false)){
         Value obj;
@@ -496,6 +509,132 @@ uint16_t openRtpServer(uint16_t local_port, const string &stream_id, int tcp_mod
 
 #endif
 
+static const double kLatencyQuantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+static Value makeLatencyJson(const LatencySnapshot &snap) {
+    Value obj(objectValue);
+    obj["count"] = (Json::UInt64) snap.count;
+    obj["avg"] = (Json::UInt64) snap.average();
+    obj["max"] = (Json::UInt64) snap.max;
+    obj["p50"] = (Json::UInt64) snap.percentile(0.5);
+    obj["p90"] = (Json::UInt64) snap.percentile(0.9);
+    obj["p99"] = (Json::UInt64) snap.percentile(0.99);
+    obj["p999"] = (Json::UInt64) snap.percentile(0.999);
+    return obj;
+}
+
+//prometheus标签值转义
+static string escapeLabel(const string &str) {
+    string ret;
+    ret.reserve(str.size());
+    for (auto ch : str) {
+        switch (ch) {
+            case '\\': ret.append("\\\\"); break;
+            case '"': ret.append("\\\""); break;
+            case '\n': ret.append("\\n"); break;
+            default: ret.push_back(ch); break;
+        }
+    }
+    return ret;
+}
+
+static void dumpLatencySummary(std::ostream &printer, const string &name, const string &labels, const LatencySnapshot &snap) {
+    for (auto quantile : kLatencyQuantiles) {
+        printer << name << "{" << labels << ",quantile=\"" << quantile << "\"} " << snap.percentile(quantile) << "\n";
+    }
+    printer << name << "_sum{" << labels << "} " << snap.sum << "\n";
+    printer << name << "_count{" << labels << "} " << snap.count << "\n";
+}
+
+static void forEachStreamLatency(const function<void(const MediaSource::Ptr &src, const LatencySnapshot &snap)> &cb) {
+    MediaSource::for_each_media([&](const MediaSource::Ptr &src) {
+        auto histogram = src->getIngestLatency();
+        if (!histogram) {
+            return;
+        }
+        LatencySnapshot snap;
+        histogram->mergeTo(snap);
+        if (snap.count) {
+            cb(src, snap);
+        }
+    });
+}
+
+void getLatencyStatsJson(Value &val) {
+    for (int i = 0; i < LatencyStat::kTypeMax; ++i) {
+        auto type = (LatencyStat::Type) i;
+        val["global"][LatencyStat::getTypeName(type)] = makeLatencyJson(LatencyStat::snapshot(type));
+    }
+    val["streams"] = Value(arrayValue);
+    forEachStreamLatency([&](const MediaSource::Ptr &src, const LatencySnapshot &snap) {
+        auto obj = makeLatencyJson(snap);
+        auto &tuple = src->getMediaTuple();
+        obj["schema"] = src->getSchema();
+        obj["vhost"] = tuple.vhost;
+        obj["app"] = tuple.app;
+        obj["stream"] = tuple.stream;
+        val["streams"].append(std::move(obj));
+    });
+}
+
+string getLatencyStatsPrometheus() {
+    std::ostringstream printer;
+    printer << "# HELP zlm_latency_microseconds Latency of media pipeline stages in microseconds\n";
+    printer << "# TYPE zlm_latency_microseconds summary\n";
+    for (int i = 0; i < LatencyStat::kTypeMax; ++i) {
+        auto type = (LatencyStat::Type) i;
+        dumpLatencySummary(printer, "zlm_latency_microseconds", string("stage=\"") + LatencyStat::getTypeName(type) + "\"", LatencyStat::snapshot(type));
+    }
+    printer << "# HELP zlm_stream_ingest_latency_microseconds Latency from frame ingest to ring buffer write per stream in microseconds\n";
+    printer << "# TYPE zlm_stream_ingest_latency_microseconds summary\n";
+    forEachStreamLatency([&](const MediaSource::Ptr &src, const LatencySnapshot &snap) {
+        auto &tuple = src->getMediaTuple();
+        auto labels = "schema=\"" + src->getSchema() + "\",vhost=\"" + escapeLabel(tuple.vhost) + "\",app=\"" + escapeLabel(tuple.app)
+            + "\",stream=\"" + escapeLabel(tuple.stream) + "\"";
+        dumpLatencySummary(printer, "zlm_stream_ingest_latency_microseconds", labels, snap);
+    });
+    return printer.str();
+}
+
+static void dumpThreadsPrometheus(std::ostream &out, const char *name, const char *pool, const vector<int> &values) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << name << "{pool=\"" << pool << "\",thread=\"" << i << "\"} " << values[i] << "\n";
+    }
+}
+
+string getMetricsPrometheus(const vector<int> &poller_delay, const vector<int> &work_delay) {
+    std::ostringstream out;
+    Metrics::dumpPrometheus(out);
+
+    //各线程事件循环任务排队延时与负载
+    //同一指标的样本需要连续输出在其HELP/TYPE之后
+    out << "# HELP zlm_thread_delay_milliseconds Task queue delay of event poller and work threads\n";
+    out << "# TYPE zlm_thread_delay_milliseconds gauge\n";
+    dumpThreadsPrometheus(out, "zlm_thread_delay_milliseconds", "event", poller_delay);
+    dumpThreadsPrometheus(out, "zlm_thread_delay_milliseconds", "work", work_delay);
+    out << "# HELP zlm_thread_load_percent Load of event poller and work threads\n";
+    out << "# TYPE zlm_thread_load_percent gauge\n";
+    dumpThreadsPrometheus(out, "zlm_thread_load_percent", "event", EventPollerPool::Instance().getExecutorLoad());
+    dumpThreadsPrometheus(out, "zlm_thread_load_percent", "work", WorkThreadPool::Instance().getExecutorLoad());
+
+    //各流环形缓存的播放器个数
+    out << "# HELP zlm_stream_readers Ring buffer reader count per stream and protocol\n";
+    out << "# TYPE zlm_stream_readers gauge\n";
+    size_t sources = 0;
+    MediaSource::for_each_media([&](const MediaSource::Ptr &src) {
+        auto &tuple = src->getMediaTuple();
+        ++sources;
+        out << "zlm_stream_readers{schema=\"" << src->getSchema() << "\",vhost=\"" << escapeLabel(tuple.vhost) << "\",app=\"" << escapeLabel(tuple.app)
+            << "\",stream=\"" << escapeLabel(tuple.stream) << "\"} " << src->readerCount() << "\n";
+    });
+    out << "# HELP zlm_media_sources Registered media source count\n";
+    out << "# TYPE zlm_media_sources gauge\n";
+    out << "zlm_media_sources " << sources << "\n";
+
+    out << getLatencyStatsPrometheus();
+    return out.str();
+}
+
 void getStatisticJson(const function<void(Value &val)> &cb) {
     auto obj = std::make_shared<Value>(objectValue);
     auto &val = *obj;
@@ -519,6 +658,37 @@ void getStatisticJson(const function<void(Value &val)> &cb) {
 
     val["RtpPacket"] = (Json::UInt64)(ObjectStatistic<RtpPacket>::count());
     val["RtmpPacket"] = (Json::UInt64)(ObjectStatistic<RtmpPacket>::count());
+
+    //udp批量发送的总包数与系统调用次数
+    val["udpBatchSendPackets"] = (Json::UInt64)(UdpBatchSender::getTotalPackets());
+    val["udpBatchSendSyscalls"] = (Json::UInt64)(UdpBatchSender::getTotalSyscalls());
+    //udp批量接收的总包数与唤醒次数
+    val["udpBatchRecvPackets"] = (Json::UInt64)(UdpBatchReceiver::getTotalPackets());
+    val["udpBatchRecvWakeups"] = (Json::UInt64)(UdpBatchReceiver::getTotalWakeups());
+    //内存hls切片占用字节数
+    val["hlsMemoryBytes"] = (Json::UInt64)(HlsMediaSource::getSegmentMemory());
+    //webrtc nack重传命中与未命中次数
+    val["webrtcNackServed"] = (Json::UInt64)(Metrics::get(Metrics::kWebRtcRetransmit));
+    val["webrtcNackMissed"] = (Json::UInt64)(Metrics::get(Metrics::kWebRtcRetransmitMiss));
+    //时间轮定时任务个数、驱动次数与耗时(微秒)
+    val["timerWheelCount"] = (Json::UInt64)(TimerWheel::getTimerCount());
+    val["timerWheelTicks"] = (Json::UInt64)(TimerWheel::getTickCount());
+    val["timerWheelTickCostUS"] = (Json::UInt64)(TimerWheel::getTickCostUS());
+    val["timerWheelMaxTickCostUS"] = (Json::UInt64)(TimerWheel::getMaxTickCostUS());
+    //包内存池线程缓存命中、未命中次数与跨线程归还次数
+    auto pool_hit = PacketPool::getHitCount();
+    auto pool_miss = PacketPool::getMissCount();
+    val["packetPoolHit"] = (Json::UInt64)pool_hit;
+    val["packetPoolMiss"] = (Json::UInt64)pool_miss;
+    val["packetPoolRemoteFree"] = (Json::UInt64)(PacketPool::getRemoteFreeCount());
+    val["packetPoolHitRate"] = pool_hit + pool_miss ? (double)pool_hit / (pool_hit + pool_miss) : 0.0;
+    //录制异步写盘队列深度、待写与丢弃字节数、写盘延时(微秒)
+    val["diskWriteQueueDepth"] = (Json::UInt64)(DiskWriter::getQueueDepth());
+    val["diskWritePendingBytes"] = (Json::UInt64)(DiskWriter::getPendingBytes());
+    val["diskWriteBytes"] = (Json::UInt64)(DiskWriter::getWriteBytes());
+    val["diskWriteDropBytes"] = (Json::UInt64)(DiskWriter::getDropBytes());
+    val["diskWriteLatencyUS"] = (Json::UInt64)(DiskWriter::getWriteLatencyUS());
+    val["diskWriteMaxLatencyUS"] = (Json::UInt64)(DiskWriter::getMaxWriteLatencyUS());
 #ifdef ENABLE_MEM_DEBUG
     auto bytes = getTotalMemUsage();
     val["totalMemUsage"] = (Json::UInt64) bytes;
@@ -679,6 +849,8 @@ void addStreamPusherProxy(const string &schema,
 void installWebApi() {
     addHttpListener();
     GET_CONFIG(string,api_secret,API::kSecret);
+    //定时采样事件轮询线程排队延时
+    LatencyStat::startPollerSampler();
 
     //获取线程负载
     //测试url http://127.0.0.1/index/api/getThreadsLoad
@@ -1693,7 +1865,7 @@ void installWebApi() {
         invoker.responseFile(headerIn, headerOut, snap_path);
     };
 
-    //获取截图缓存或者实时截图
+    //获取截图缓存或者实时截图，本服务器上的流优先在进程内解码关键帧截图
     //http://127.0.0.1/index/api/getSnap?url=rtmp://127.0.0.1/record/robot.mp4&timeout_sec=10&expire_sec=3
     api_regist("/index/api/getSnap", [](API_ARGS_MAP_ASYNC){
         CHECK_SECRET();
@@ -1742,9 +1914,9 @@ void installWebApi() {
             }
         }
 
-        //启动FFmpeg进程，开始截图，生成临时文件，截图成功后替换为正式文件
+        //开始截图，生成临时文件，截图成功后替换为正式文件
         auto new_snap_tmp = new_snap + ".tmp";
-        FFmpegSnap::makeSnap(allArgs["url"], new_snap_tmp, allArgs["timeout_sec"], [invoker, allArgs, new_snap, new_snap_tmp](bool success, const string &err_msg) {
+        auto on_snap = [invoker, allArgs, new_snap, new_snap_tmp](bool success, const string &err_msg) {
             if (!success) {
                 //生成截图失败，可能残留空文件
                 File::delete_file(new_snap_tmp);
@@ -1754,7 +1926,24 @@ void installWebApi() {
                 rename(new_snap_tmp.data(), new_snap.data());
             }
             responseSnap(new_snap, allArgs.parser.getHeader(), invoker, err_msg);
-        });
+        };
+
+        //skip_ffmpeg为1时只在进程内截图，不启动FFmpeg进程
+        bool skip_ffmpeg = allArgs["skip_ffmpeg"].as<bool>();
+#if defined(ENABLE_FFMPEG)
+        GET_CONFIG(bool, snap_in_process, FFmpeg::kSnapInProcess);
+        if ((snap_in_process || skip_ffmpeg) && FFmpegSnapService::Instance().makeSnap(allArgs["url"], new_snap_tmp, allArgs["timeout_sec"], on_snap)) {
+            //本服务器上的流，直接解码关键帧截图
+            return;
+        }
+#endif
+        if (skip_ffmpeg) {
+            on_snap(false, "media source not found in this server or it has no video");
+            return;
+        }
+
+        //启动FFmpeg进程截图
+        FFmpegSnap::makeSnap(allArgs["url"], new_snap_tmp, allArgs["timeout_sec"], on_snap);
     });
 
     api_regist("/index/api/getStatistic",[](API_ARGS_MAP_ASYNC){
@@ -1765,6 +1954,31 @@ void installWebApi() {
         });
     });
 
+    //prometheus指标导出，包括各协议收发字节数、丢包、nack与重传、环形缓存播放器个数、线程延时与负载、延时统计
+    //测试url http://127.0.0.1/metrics
+    api_regist("/metrics",[](API_ARGS_MAP_ASYNC){
+        CHECK_SECRET();
+        EventPollerPool::Instance().getExecutorDelay([invoker, headerOut](const vector<int> &poller_delay) mutable {
+            WorkThreadPool::Instance().getExecutorDelay([invoker, headerOut, poller_delay](const vector<int> &work_delay) mutable {
+                headerOut["Content-Type"] = "text/plain; version=0.0.4";
+                invoker(200, headerOut, getMetricsPrometheus(poller_delay, work_delay));
+            });
+        });
+    });
+
+    //获取延时统计直方图(单位微秒)，format=prometheus时返回prometheus文本格式
+    //测试url http://127.0.0.1/index/api/getLatencyStats
+    api_regist("/index/api/getLatencyStats",[](API_ARGS_MAP_ASYNC){
+        CHECK_SECRET();
+        if (allArgs["format"] == "prometheus") {
+            headerOut["Content-Type"] = "text/plain; version=0.0.4";
+            invoker(200, headerOut, getLatencyStatsPrometheus());
+            return;
+        }
+        getLatencyStatsJson(val["data"]);
+        invoker(200, headerOut, val.toStyledString());
+    });
+
 #ifdef ENABLE_WEBRTC
     class WebRtcArgsImp : public WebRtcArgs {
     public:
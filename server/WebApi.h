@@ -207,6 +207,9 @@ uint16_t openRtpServer(uint16_t local_port, const std::string &stream_id, int tc
 
 Json::Value makeMediaSourceJson(mediakit::MediaSource &media);
 void getStatisticJson(const std::function<void(Json::Value &val)> &cb);
+void getLatencyStatsJson(Json::Value &val);
+std::string getLatencyStatsPrometheus();
+std::string getMetricsPrometheus(const std::vector<int> &poller_delay, const std::vector<int> &work_delay);
 void addStreamProxy(const std::string &vhost, const std::string &app, const std::string &stream, const std::string &url, int retry_count,
                     const mediakit::ProtocolOption &option, int rtp_type, float timeout_sec, const toolkit::mINI &args,
                     const std::function<void(const toolkit::SockException &ex, const std::string &key)> &cb);
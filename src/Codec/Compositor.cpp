@@ -0,0 +1,257 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <cstring>
+#include "Compositor.h"
+#include "Common/macros.h"
+#include "Common/config.h"
+#include "Util/util.h"
+#include "Util/logger.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENABLE_COMPOSITOR_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ENABLE_COMPOSITOR_NEON
+#endif
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+void copyPlane(uint8_t *dst, int dst_stride, const uint8_t *src, int src_stride, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if (dst_stride == width && src_stride == width) {
+        // 连续内存，一次拷贝
+        memcpy(dst, src, (size_t)width * height);
+        return;
+    }
+    for (int i = 0; i < height; ++i) {
+        memcpy(dst + (size_t)dst_stride * i, src + (size_t)src_stride * i, width);
+    }
+}
+
+static void splitUVRow(uint8_t *u, uint8_t *v, const uint8_t *uv, int width) {
+    int i = 0;
+#if defined(ENABLE_COMPOSITOR_SSE2)
+    auto mask = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= width; i += 16) {
+        auto a = _mm_loadu_si128((const __m128i *)(uv + 2 * i));
+        auto b = _mm_loadu_si128((const __m128i *)(uv + 2 * i + 16));
+        // 偶数字节为u，奇数字节为v
+        _mm_storeu_si128((__m128i *)(u + i), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+        _mm_storeu_si128((__m128i *)(v + i), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+#elif defined(ENABLE_COMPOSITOR_NEON)
+    for (; i + 16 <= width; i += 16) {
+        auto pair = vld2q_u8(uv + 2 * i);
+        vst1q_u8(u + i, pair.val[0]);
+        vst1q_u8(v + i, pair.val[1]);
+    }
+#endif
+    for (; i < width; ++i) {
+        u[i] = uv[2 * i];
+        v[i] = uv[2 * i + 1];
+    }
+}
+
+static void mergeUVRow(uint8_t *uv, const uint8_t *u, const uint8_t *v, int width) {
+    int i = 0;
+#if defined(ENABLE_COMPOSITOR_SSE2)
+    for (; i + 16 <= width; i += 16) {
+        auto a = _mm_loadu_si128((const __m128i *)(u + i));
+        auto b = _mm_loadu_si128((const __m128i *)(v + i));
+        _mm_storeu_si128((__m128i *)(uv + 2 * i), _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128((__m128i *)(uv + 2 * i + 16), _mm_unpackhi_epi8(a, b));
+    }
+#elif defined(ENABLE_COMPOSITOR_NEON)
+    for (; i + 16 <= width; i += 16) {
+        uint8x16x2_t pair;
+        pair.val[0] = vld1q_u8(u + i);
+        pair.val[1] = vld1q_u8(v + i);
+        vst2q_u8(uv + 2 * i, pair);
+    }
+#endif
+    for (; i < width; ++i) {
+        uv[2 * i] = u[i];
+        uv[2 * i + 1] = v[i];
+    }
+}
+
+void splitUVPlane(uint8_t *dst_u, int dst_u_stride, uint8_t *dst_v, int dst_v_stride, const uint8_t *src_uv, int src_stride, int width, int height) {
+    for (int i = 0; i < height; ++i) {
+        splitUVRow(dst_u + (size_t)dst_u_stride * i, dst_v + (size_t)dst_v_stride * i, src_uv + (size_t)src_stride * i, width);
+    }
+}
+
+void mergeUVPlane(uint8_t *dst_uv, int dst_stride, const uint8_t *src_u, int src_u_stride, const uint8_t *src_v, int src_v_stride, int width, int height) {
+    for (int i = 0; i < height; ++i) {
+        mergeUVRow(dst_uv + (size_t)dst_stride * i, src_u + (size_t)src_u_stride * i, src_v + (size_t)src_v_stride * i, width);
+    }
+}
+
+void blitYuv(const YuvImage &dst, int x, int y, const YuvImage &src) {
+    if (x < 0 || y < 0 || x >= dst.width || y >= dst.height) {
+        return;
+    }
+    auto width = MIN(src.width, dst.width - x);
+    auto height = MIN(src.height, dst.height - y);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    copyPlane(dst.data[0] + (size_t)dst.linesize[0] * y + x, dst.linesize[0], src.data[0], src.linesize[0], width, height);
+
+    // 色度平面宽高减半，height为奇数时也要拷贝最后一行uv
+    auto cx = x / 2;
+    auto cy = y / 2;
+    auto cw = MIN((width + 1) / 2, (dst.width + 1) / 2 - cx);
+    auto ch = MIN((height + 1) / 2, (dst.height + 1) / 2 - cy);
+    if (dst.format == YuvImage::I420) {
+        auto dst_u = dst.data[1] + (size_t)dst.linesize[1] * cy + cx;
+        auto dst_v = dst.data[2] + (size_t)dst.linesize[2] * cy + cx;
+        if (src.format == YuvImage::I420) {
+            copyPlane(dst_u, dst.linesize[1], src.data[1], src.linesize[1], cw, ch);
+            copyPlane(dst_v, dst.linesize[2], src.data[2], src.linesize[2], cw, ch);
+        } else {
+            splitUVPlane(dst_u, dst.linesize[1], dst_v, dst.linesize[2], src.data[1], src.linesize[1], cw, ch);
+        }
+        return;
+    }
+
+    auto dst_uv = dst.data[1] + (size_t)dst.linesize[1] * cy + cx * 2;
+    if (src.format == YuvImage::NV12) {
+        copyPlane(dst_uv, dst.linesize[1], src.data[1], src.linesize[1], cw * 2, ch);
+    } else {
+        mergeUVPlane(dst_uv, dst.linesize[1], src.data[1], src.linesize[1], src.data[2], src.linesize[2], cw, ch);
+    }
+}
+
+void fillYuv(const YuvImage &dst, uint8_t y, uint8_t u, uint8_t v) {
+    for (int i = 0; i < dst.height; ++i) {
+        memset(dst.data[0] + (size_t)dst.linesize[0] * i, y, dst.width);
+    }
+    auto cw = (dst.width + 1) / 2;
+    auto ch = (dst.height + 1) / 2;
+    for (int i = 0; i < ch; ++i) {
+        if (dst.format == YuvImage::I420) {
+            memset(dst.data[1] + (size_t)dst.linesize[1] * i, u, cw);
+            memset(dst.data[2] + (size_t)dst.linesize[2] * i, v, cw);
+            continue;
+        }
+        auto uv = dst.data[1] + (size_t)dst.linesize[1] * i;
+        for (int j = 0; j < cw; ++j) {
+            uv[2 * j] = u;
+            uv[2 * j + 1] = v;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////TileScheduler/////////////////////////////////////////////////////////
+
+TileScheduler::TileScheduler() {
+    GET_CONFIG(uint32_t, composeThreads, General::kComposeThreads);
+    // 调用线程也参与执行
+    auto threads = MAX(composeThreads ? composeThreads : thread::hardware_concurrency(), 1u) - 1;
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.emplace_back([this, i]() {
+            setThreadName(("stack tile " + to_string(i)).data());
+            while (true) {
+                Job job;
+                {
+                    unique_lock<mutex> lck(_mtx);
+                    _cond.wait(lck, [this]() { return _exit || !_jobs.empty(); });
+                    if (_exit) {
+                        return;
+                    }
+                    job = std::move(_jobs.front());
+                    _jobs.pop_front();
+                }
+                job();
+            }
+        });
+    }
+}
+
+TileScheduler::~TileScheduler() {
+    {
+        lock_guard<mutex> lck(_mtx);
+        _exit = true;
+    }
+    _cond.notify_all();
+    for (auto &th : _threads) {
+        th.join();
+    }
+}
+
+TileScheduler &TileScheduler::Instance() {
+    static TileScheduler s_instance;
+    return s_instance;
+}
+
+bool TileScheduler::runOne() {
+    Job job;
+    {
+        lock_guard<mutex> lck(_mtx);
+        if (_jobs.empty()) {
+            return false;
+        }
+        job = std::move(_jobs.front());
+        _jobs.pop_front();
+    }
+    job();
+    return true;
+}
+
+void TileScheduler::run(vector<Job> &jobs) {
+    if (jobs.size() <= 1 || _threads.empty()) {
+        for (auto &job : jobs) {
+            job();
+        }
+        return;
+    }
+
+    struct Latch {
+        size_t remain;
+        mutex mtx;
+        condition_variable cond;
+    };
+    auto latch = std::make_shared<Latch>();
+    latch->remain = jobs.size();
+    {
+        lock_guard<mutex> lck(_mtx);
+        for (auto &job : jobs) {
+            _jobs.emplace_back([job, latch]() {
+                try {
+                    job();
+                } catch (std::exception &ex) {
+                    WarnL << "Compose job failed: " << ex.what();
+                }
+                lock_guard<mutex> lck(latch->mtx);
+                if (--latch->remain == 0) {
+                    latch->cond.notify_all();
+                }
+            });
+        }
+    }
+    _cond.notify_all();
+
+    // 帮助执行，队列空了再等待其他线程执行完毕
+    while (runOne()) {
+    }
+    unique_lock<mutex> lck(latch->mtx);
+    latch->cond.wait(lck, [&]() { return latch->remain == 0; });
+}
+
+} // namespace mediakit
@@ -0,0 +1,105 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_COMPOSITOR_H
+#define ZLMEDIAKIT_COMPOSITOR_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace mediakit {
+
+/**
+ * yuv图像或者其中的一块区域，支持yuv420p与nv12
+ */
+struct YuvImage {
+    enum Format {
+        I420 = 0,
+        NV12 = 1,
+    };
+
+    Format format = I420;
+    int width = 0;
+    int height = 0;
+    // nv12时data[1]为交织的uv平面，data[2]不使用
+    uint8_t *data[3] = { nullptr, nullptr, nullptr };
+    int linesize[3] = { 0, 0, 0 };
+};
+
+/**
+ * 拷贝一个平面
+ * @param width 每行拷贝的字节数
+ */
+void copyPlane(uint8_t *dst, int dst_stride, const uint8_t *src, int src_stride, int width, int height);
+
+/**
+ * 交织的uv平面拆分为u、v两个平面(nv12 -> yuv420p)
+ * @param width 每行的uv采样对个数
+ */
+void splitUVPlane(uint8_t *dst_u, int dst_u_stride, uint8_t *dst_v, int dst_v_stride, const uint8_t *src_uv, int src_stride, int width, int height);
+
+/**
+ * u、v两个平面合并为交织的uv平面(yuv420p -> nv12)
+ * @param width 每行的uv采样对个数
+ */
+void mergeUVPlane(uint8_t *dst_uv, int dst_stride, const uint8_t *src_u, int src_u_stride, const uint8_t *src_v, int src_v_stride, int width, int height);
+
+/**
+ * 把src拷贝到dst的(x, y)处，超出dst的部分被裁剪
+ * 支持yuv420p与nv12之间相互拷贝，uv分量的拆分与合并使用simd指令
+ */
+void blitYuv(const YuvImage &dst, int x, int y, const YuvImage &src);
+
+/**
+ * 以指定颜色填充整个图像
+ */
+void fillYuv(const YuvImage &dst, uint8_t y, uint8_t u, uint8_t v);
+
+/**
+ * 画面合成任务调度器
+ * 把多个画面的缩放与拷贝分发到工作线程并行执行，调用线程也参与执行，
+ * 多个合成器可以同时提交，所有合成器共享同一组工作线程，线程数由general.compose_threads配置
+ */
+class TileScheduler {
+public:
+    using Job = std::function<void()>;
+
+    ~TileScheduler();
+    static TileScheduler &Instance();
+
+    /**
+     * 并行执行全部任务，全部完成后返回
+     */
+    void run(std::vector<Job> &jobs);
+
+    /**
+     * 工作线程个数(不含调用线程)
+     */
+    size_t getThreads() const { return _threads.size(); }
+
+private:
+    TileScheduler();
+    bool runOne();
+
+private:
+    bool _exit = false;
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    std::deque<Job> _jobs;
+    std::vector<std::thread> _threads;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_COMPOSITOR_H
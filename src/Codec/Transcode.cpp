@@ -314,7 +314,7 @@ static inline const AVCodec *getCodecByName(const std::vector<std::string> &code
     return ret;
 }
 
-FFmpegDecoder::FFmpegDecoder(const Track::Ptr &track, int thread_num, const std::vector<std::string> &codec_name) {
+FFmpegDecoder::FFmpegDecoder(const Track::Ptr &track, int thread_num, const std::vector<std::string> &codec_name, int thread_type) {
     setupFFmpeg();
     const AVCodec *codec = nullptr;
     const AVCodec *codec_default = nullptr;
@@ -409,6 +409,10 @@ FFmpegDecoder::FFmpegDecoder(const Track::Ptr &track, int thread_num, const std:
 #endif
         _context->flags |= AV_CODEC_FLAG_LOW_DELAY;
         _context->flags2 |= AV_CODEC_FLAG2_FAST;
+        if (thread_type) {
+            // 帧级多线程会增加解码延时，单帧解码(例如截图)时应该使用slice多线程
+            _context->thread_type = thread_type;
+        }
         if (track->getTrackType() == TrackVideo) {
             _context->width = static_pointer_cast<VideoTrack>(track)->getVideoWidth();
             _context->height = static_pointer_cast<VideoTrack>(track)->getVideoHeight();
@@ -465,13 +469,13 @@ FFmpegDecoder::FFmpegDecoder(const Track::Ptr &track, int thread_num, const std:
 
 FFmpegDecoder::~FFmpegDecoder() {
     stopThread(true);
-    if (_do_merger) {
-        _merger.flush();
-    }
     flush();
 }
 
 void FFmpegDecoder::flush() {
+    if (_do_merger) {
+        _merger.flush();
+    }
     while (true) {
         auto out_frame = std::make_shared<FFmpegFrame>();
         auto ret = avcodec_receive_frame(_context.get(), out_frame->get());
@@ -488,6 +492,8 @@ void FFmpegDecoder::flush() {
         }
         onDecode(out_frame);
     }
+    // 解码器进入eof状态后必须重置才能继续解码
+    avcodec_flush_buffers(_context.get());
 }
 
 const AVCodecContext *FFmpegDecoder::getContext() const {
@@ -693,5 +699,65 @@ FFmpegFrame::Ptr FFmpegSws::inputFrame(const FFmpegFrame::Ptr &frame, int &ret,
     return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::tuple<bool, std::string> FFmpegUtils::saveFrame(const FFmpegFrame::Ptr &frame, const char *filename, int qscale) {
+    TimeTicker2(30, TraceL);
+    auto yuv = frame;
+    auto format = (enum AVPixelFormat) frame->get()->format;
+    if (format != AV_PIX_FMT_YUV420P && format != AV_PIX_FMT_YUVJ420P) {
+        // 硬件解码器等输出的其他格式需要先转换
+        yuv = FFmpegSws(AV_PIX_FMT_YUV420P, 0, 0).inputFrame(frame);
+        if (!yuv) {
+            return make_tuple(false, "convert frame to yuv420p failed");
+        }
+    }
+
+    auto codec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    if (!codec) {
+        return make_tuple(false, "mjpeg encoder not found");
+    }
+    std::shared_ptr<AVCodecContext> ctx(avcodec_alloc_context3(codec), [](AVCodecContext *ctx) {
+        avcodec_free_context(&ctx);
+    });
+    if (!ctx) {
+        return make_tuple(false, "alloc mjpeg encoder failed");
+    }
+    ctx->width = yuv->get()->width;
+    ctx->height = yuv->get()->height;
+    ctx->pix_fmt = (enum AVPixelFormat) yuv->get()->format;
+    ctx->time_base = { 1, 25 };
+    // mjpeg编码器默认只接受yuvj420p，允许直接编码yuv420p以省去一次格式转换
+    ctx->strict_std_compliance = FF_COMPLIANCE_UNOFFICIAL;
+    ctx->flags |= AV_CODEC_FLAG_QSCALE;
+    ctx->global_quality = FF_QP2LAMBDA * MIN(MAX(qscale, 2), 31);
+    auto ret = avcodec_open2(ctx.get(), codec, nullptr);
+    if (ret < 0) {
+        return make_tuple(false, "open mjpeg encoder failed:" + ffmpeg_err(ret));
+    }
+
+    yuv->get()->quality = ctx->global_quality;
+    ret = avcodec_send_frame(ctx.get(), yuv->get());
+    if (ret < 0) {
+        return make_tuple(false, "avcodec_send_frame failed:" + ffmpeg_err(ret));
+    }
+    auto pkt = alloc_av_packet();
+    ret = avcodec_receive_packet(ctx.get(), pkt.get());
+    if (ret < 0) {
+        return make_tuple(false, "avcodec_receive_packet failed:" + ffmpeg_err(ret));
+    }
+
+    auto fp = File::create_file(filename, "wb");
+    if (!fp) {
+        return make_tuple(false, StrPrinter << "open file " << filename << " failed:" << get_uv_errmsg());
+    }
+    auto size = fwrite(pkt->data, 1, pkt->size, fp);
+    fclose(fp);
+    if (size != (size_t)pkt->size) {
+        return make_tuple(false, StrPrinter << "write file " << filename << " failed:" << get_uv_errmsg());
+    }
+    return make_tuple(true, "");
+}
+
 } //namespace mediakit
 #endif//ENABLE_FFMPEG
@@ -13,6 +13,7 @@
 
 #if defined(ENABLE_FFMPEG)
 
+#include <tuple>
 #include "Util/TimeTicker.h"
 #include "Common/MediaSink.h"
 
@@ -100,11 +101,20 @@ public:
     using Ptr = std::shared_ptr<FFmpegDecoder>;
     using onDec = std::function<void(const FFmpegFrame::Ptr &)>;
 
-    FFmpegDecoder(const Track::Ptr &track, int thread_num = 2, const std::vector<std::string> &codec_name = {});
+    /**
+     * @param thread_num 解码线程数，小于等于0时自动设置
+     * @param codec_name 优先使用的解码器名称
+     * @param thread_type 多线程解码方式，FF_THREAD_FRAME和(或)FF_THREAD_SLICE，为0时使用ffmpeg默认值
+     */
+    FFmpegDecoder(const Track::Ptr &track, int thread_num = 2, const std::vector<std::string> &codec_name = {}, int thread_type = 0);
     ~FFmpegDecoder() override;
 
     bool inputFrame(const Frame::Ptr &frame, bool live, bool async, bool enable_merge = true);
     void setOnDecode(onDec cb);
+
+    /**
+     * 输出所有缓存的帧并重置解码器，之后可以继续输入新的帧(例如其他流的关键帧)
+     */
     void flush();
     const AVCodecContext *getContext() const;
 
@@ -143,6 +153,18 @@ private:
     AVPixelFormat _target_format = AV_PIX_FMT_NONE;
 };
 
+class FFmpegUtils {
+public:
+    /**
+     * 把解码后的帧编码为jpeg并保存为文件
+     * @param frame 解码后的帧
+     * @param filename 保存文件路径
+     * @param qscale jpeg量化参数，2~31，越小质量越高
+     * @return 是否成功及失败原因
+     */
+    static std::tuple<bool, std::string> saveFrame(const FFmpegFrame::Ptr &frame, const char *filename, int qscale = 5);
+};
+
 }//namespace mediakit
 #endif// ENABLE_FFMPEG
 #endif //ZLMEDIAKIT_TRANSCODE_H
@@ -0,0 +1,65 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "FrameGopCache.h"
+#include "Util/logger.h"
+
+using namespace std;
+
+namespace mediakit {
+
+void FrameGopCache::inputFrame(const Frame::Ptr &frame, bool have_video) {
+    ++_next_index;
+    if (!have_video) {
+        // 纯音频时各协议也不缓存gop
+        clear();
+        return;
+    }
+
+    if (frame->getTrackType() == TrackVideo) {
+        // 遇到第一帧配置帧或关键帧则标记为gop开始处
+        auto video_key_pos = frame->keyFrame() || frame->configFrame();
+        if (video_key_pos && !_video_key_pos) {
+            clear();
+            _drop_gop = false;
+        }
+        if (!frame->dropAble()) {
+            _video_key_pos = video_key_pos;
+        }
+    }
+
+    if (_drop_gop) {
+        return;
+    }
+    if (_frames.size() >= kMaxFrameCount) {
+        // gop太长，不完整的gop没有意义，直接丢弃
+        WarnL << "Gop is too long, drop the shared gop cache until next key frame";
+        clear();
+        _drop_gop = true;
+        return;
+    }
+    _bytes += frame->size();
+    _frames.emplace_back(frame);
+}
+
+void FrameGopCache::replay(uint64_t index, const onFrame &cb) const {
+    auto first_index = _next_index - _frames.size();
+    auto skip = index > first_index ? index - first_index : 0;
+    for (auto i = skip; i < _frames.size(); ++i) {
+        cb(_frames[i]);
+    }
+}
+
+void FrameGopCache::clear() {
+    _frames.clear();
+    _bytes = 0;
+}
+
+} // namespace mediakit
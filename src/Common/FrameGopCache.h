@@ -0,0 +1,128 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_FRAMEGOPCACHE_H
+#define ZLMEDIAKIT_FRAMEGOPCACHE_H
+
+#include <deque>
+#include <memory>
+#include <functional>
+#include "Extension/Frame.h"
+
+namespace mediakit {
+
+/**
+ * 帧级别的gop缓存，由MultiMediaSourceMuxer持有，各协议共享
+ * 按需转协议时，协议在首次被播放时从该缓存回放最近一个gop并打包，
+ * 这样无人观看的协议不必各自再缓存一份协议格式的gop
+ * Frame level gop cache owned by MultiMediaSourceMuxer and shared by all protocols.
+ * On-demand protocols packetize the latest gop from it on first play,
+ * so protocols without players no longer keep their own gop copy.
+ * 该对象非线程安全，只能在MultiMediaSourceMuxer归属线程访问
+ * Not thread safe, must be accessed in the owner poller of MultiMediaSourceMuxer.
+ */
+class FrameGopCache {
+public:
+    using Ptr = std::shared_ptr<FrameGopCache>;
+    using onFrame = std::function<void(const Frame::Ptr &frame)>;
+
+    // 单个gop最大缓存帧数，超过后丢弃该gop直到下一个关键帧
+    // Max frames of one gop, the gop is dropped until next key frame when exceeded
+    static constexpr size_t kMaxFrameCount = 1024;
+
+    /**
+     * 输入帧，每输入一帧序号加一
+     * @param frame 帧，必须为可缓存帧
+     * @param have_video 是否有视频，无视频时不缓存
+     */
+    void inputFrame(const Frame::Ptr &frame, bool have_video);
+
+    /**
+     * 回放序号不小于index的缓存帧
+     * @param index 起始序号
+     * @param cb 帧回调
+     */
+    void replay(uint64_t index, const onFrame &cb) const;
+
+    /**
+     * 下一个输入帧的序号
+     */
+    uint64_t nextIndex() const { return _next_index; }
+
+    /**
+     * 缓存帧数
+     */
+    size_t size() const { return _frames.size(); }
+
+    /**
+     * 缓存字节数
+     */
+    size_t bytes() const { return _bytes; }
+
+    /**
+     * 清空缓存，序号不重置
+     */
+    void clear();
+
+private:
+    bool _video_key_pos = false;
+    bool _drop_gop = false;
+    size_t _bytes = 0;
+    uint64_t _next_index = 0;
+    std::deque<Frame::Ptr> _frames;
+};
+
+/**
+ * 按需转协议的MediaSourceMuxer从共享gop缓存补齐数据的辅助类
+ * Helper for on-demand protocol muxers to catch up from the shared gop cache.
+ */
+class FrameGopReplayer {
+public:
+    /**
+     * 设置共享gop缓存，只对按需转协议生效
+     * @return 是否使用共享gop缓存，使用时协议自身的环形缓存不必再缓存gop
+     */
+    bool setGopCache(const FrameGopCache::Ptr &gop_cache) {
+        _gop_cache = _demand ? gop_cache : nullptr;
+        return (bool)_gop_cache;
+    }
+
+protected:
+    /**
+     * @param demand 该协议是否按需转协议
+     */
+    FrameGopReplayer(bool demand) : _demand(demand) {}
+
+    /**
+     * 协议缓存已清空，下次开启时从共享gop缓存的起始位置(关键帧与配置帧)开始补齐
+     */
+    void resetGopIndex() { _gop_index = 0; }
+
+    /**
+     * 按需转协议开启后，先补齐暂停期间未输入的共享gop缓存，使首个观看者可以秒开
+     * @param cb 输入协议muxer的回调
+     */
+    void replayGop(const FrameGopCache::onFrame &cb) {
+        if (!_gop_cache) {
+            return;
+        }
+        _gop_cache->replay(_gop_index, cb);
+        // 当前帧随后会写入共享gop缓存，其序号为nextIndex()
+        _gop_index = _gop_cache->nextIndex() + 1;
+    }
+
+private:
+    bool _demand;
+    uint64_t _gop_index = 0;
+    FrameGopCache::Ptr _gop_cache;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_FRAMEGOPCACHE_H
@@ -0,0 +1,186 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "LatencyStat.h"
+#include "ThreadShard.h"
+#include "Common/config.h"
+#include "Util/util.h"
+#include "Util/onceToken.h"
+#include "Poller/EventPoller.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+uint64_t LatencySnapshot::percentile(double quantile) const {
+    if (!count) {
+        return 0;
+    }
+    auto target = (uint64_t)(quantile * count);
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        total += buckets[i];
+        if (total > target) {
+            return MIN(LatencyHistogram::getBucketValue(i), max);
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::LatencyHistogram() {
+    _sum = 0;
+    _max = 0;
+    for (auto &bucket : _buckets) {
+        bucket = 0;
+    }
+}
+
+size_t LatencyHistogram::getBucket(uint64_t us) {
+    if (us < 4) {
+        return (size_t)us;
+    }
+    // 最高位序号
+#if defined(__GNUC__)
+    size_t exp = 63 - __builtin_clzll(us);
+#else
+    size_t exp = 0;
+    while (us >> (exp + 1)) {
+        ++exp;
+    }
+#endif
+    // 最高位之后的两位决定区间内的细分桶
+    auto bucket = 4 * (exp - 1) + ((us >> (exp - 2)) & 0x03);
+    return MIN(bucket, LatencySnapshot::kBuckets - 1);
+}
+
+uint64_t LatencyHistogram::getBucketValue(size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    auto exp = bucket / 4 + 1;
+    return ((uint64_t)(5 + bucket % 4) << (exp - 2)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    _buckets[getBucket(us)].fetch_add(1, memory_order_relaxed);
+    _sum.fetch_add(us, memory_order_relaxed);
+    if (us > _max.load(memory_order_relaxed)) {
+        // 并发写入时最大值可能略有误差，统计场景可以接受
+        _max.store(us, memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::mergeTo(LatencySnapshot &snap) const {
+    for (size_t i = 0; i < LatencySnapshot::kBuckets; ++i) {
+        auto count = _buckets[i].load(memory_order_relaxed);
+        snap.buckets[i] += count;
+        snap.count += count;
+    }
+    snap.sum += _sum.load(memory_order_relaxed);
+    snap.max = MAX(snap.max, _max.load(memory_order_relaxed));
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+// 每个线程的直方图分片
+class LatencyShard {
+public:
+    LatencyHistogram histograms[LatencyStat::kTypeMax];
+};
+
+using LatencyShardList = ThreadShardList<LatencyShard>;
+
+static thread_local uint64_t s_ingest_stamp = 0;
+// 当前线程是否正在回放gop缓存
+static thread_local bool s_replaying = false;
+
+const char *LatencyStat::getTypeName(Type type) {
+    switch (type) {
+        case kIngestToRing: return "ingest_to_ring";
+        case kRingToRtsp: return "ring_to_send_rtsp";
+        case kRingToRtmp: return "ring_to_send_rtmp";
+        case kRingToFlv: return "ring_to_send_flv";
+        case kRingToTs: return "ring_to_send_ts";
+        case kRingToFmp4: return "ring_to_send_fmp4";
+        case kRingToWebRtc: return "ring_to_send_webrtc";
+        case kRingToSrt: return "ring_to_send_srt";
+        case kPollerDelay: return "poller_delay";
+        default: return "unknown";
+    }
+}
+
+bool LatencyStat::enabled() {
+    GET_CONFIG(bool, latency_stat, General::kLatencyStat);
+    return latency_stat;
+}
+
+uint64_t LatencyStat::now() {
+    return getCurrentMicrosecond();
+}
+
+void LatencyStat::record(Type type, uint64_t us) {
+    LatencyShardList::Instance().getThreadShard().histograms[type].record(us);
+}
+
+LatencySnapshot LatencyStat::snapshot(Type type) {
+    LatencySnapshot ret;
+    LatencyShardList::Instance().for_each([&](const LatencyShard &shard) { shard.histograms[type].mergeTo(ret); });
+    return ret;
+}
+
+uint64_t LatencyStat::getIngestStamp() {
+    return s_ingest_stamp ? s_ingest_stamp : now();
+}
+
+LatencyStat::IngestScope::IngestScope() {
+    // 支持嵌套，以最外层的输入时间为准
+    _last = s_ingest_stamp;
+    if (!_last) {
+        s_ingest_stamp = now();
+    }
+}
+
+LatencyStat::IngestScope::~IngestScope() {
+    s_ingest_stamp = _last;
+}
+
+bool LatencyStat::isReplaying() {
+    return s_replaying;
+}
+
+LatencyStat::ReplayScope::ReplayScope() {
+    _last = s_replaying;
+    s_replaying = true;
+}
+
+LatencyStat::ReplayScope::~ReplayScope() {
+    s_replaying = _last;
+}
+
+void LatencyStat::startPollerSampler() {
+    static onceToken token([]() {
+        // 每秒向所有事件轮询线程投递一个任务，任务执行时间与投递时间之差即为排队延时
+        EventPollerPool::Instance().getPoller(false)->doDelayTask(1000, []() {
+            if (enabled()) {
+                EventPollerPool::Instance().for_each([](const TaskExecutor::Ptr &executor) {
+                    auto start = now();
+                    executor->async([start]() {
+                        auto now_stamp = now();
+                        record(kPollerDelay, now_stamp > start ? now_stamp - start : 0);
+                    }, false);
+                });
+            }
+            return 1000;
+        });
+    });
+}
+
+} // namespace mediakit
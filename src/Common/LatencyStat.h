@@ -0,0 +1,201 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_LATENCYSTAT_H
+#define ZLMEDIAKIT_LATENCYSTAT_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include "Util/List.h"
+
+namespace mediakit {
+
+/**
+ * 延时直方图快照，用于计算分位数
+ */
+class LatencySnapshot {
+public:
+    // 每个2的幂区间细分为4个桶，相对误差不超过25%，最大可统计2^33微秒
+    static constexpr size_t kBuckets = 128;
+
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    uint64_t buckets[kBuckets] = { 0 };
+
+    /**
+     * 获取分位数延时
+     * @param quantile 分位，取值0~1
+     * @return 所在桶的上界，单位微秒
+     */
+    uint64_t percentile(double quantile) const;
+
+    /**
+     * 平均延时，单位微秒
+     */
+    uint64_t average() const { return count ? sum / count : 0; }
+};
+
+/**
+ * HDR风格的对数分桶延时直方图，单位微秒
+ * 记录只有几次relaxed原子操作，不加锁不分配内存，读取时可以与写入并发
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * 记录一次延时
+     * @param us 延时，单位微秒
+     */
+    void record(uint64_t us);
+
+    /**
+     * 合并到快照
+     */
+    void mergeTo(LatencySnapshot &snap) const;
+
+    /**
+     * 获取桶序号
+     */
+    static size_t getBucket(uint64_t us);
+
+    /**
+     * 获取桶的上界，单位微秒
+     */
+    static uint64_t getBucketValue(size_t bucket);
+
+private:
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _max;
+    std::atomic<uint64_t> _buckets[LatencySnapshot::kBuckets];
+};
+
+/**
+ * 全局延时统计
+ * 每个线程写入自己的直方图分片，只在读取时合并，热路径上没有跨线程的缓存行竞争
+ */
+class LatencyStat {
+public:
+    enum Type {
+        // 帧输入MultiMediaSourceMuxer到合并写缓存刷新写入环形缓存
+        kIngestToRing = 0,
+        // 写入环形缓存到各协议发送至socket
+        kRingToRtsp,
+        kRingToRtmp,
+        kRingToFlv,
+        kRingToTs,
+        kRingToFmp4,
+        kRingToWebRtc,
+        kRingToSrt,
+        // 事件轮询线程任务排队延时
+        kPollerDelay,
+        kTypeMax
+    };
+
+    /**
+     * 获取统计项名称
+     */
+    static const char *getTypeName(Type type);
+
+    /**
+     * 是否开启延时统计(由general.latency_stat配置)
+     */
+    static bool enabled();
+
+    /**
+     * 获取当前时间戳，单位微秒
+     * 使用toolkit后台线程定时更新的时间戳(精度约0.5毫秒)，读取只是一次原子操作，不产生系统调用
+     */
+    static uint64_t now();
+
+    /**
+     * 记录一次延时到当前线程的分片
+     */
+    static void record(Type type, uint64_t us);
+
+    /**
+     * 合并所有线程的分片
+     */
+    static LatencySnapshot snapshot(Type type);
+
+    /**
+     * 获取当前线程正在处理的帧的输入时间戳，不在帧输入流程中时返回当前时间
+     */
+    static uint64_t getIngestStamp();
+
+    /**
+     * 开始定时采样事件轮询线程的任务排队延时
+     */
+    static void startPollerSampler();
+
+    /**
+     * 在作用域内标记当前线程正在处理的帧的输入时间戳
+     */
+    class IngestScope {
+    public:
+        IngestScope();
+        ~IngestScope();
+
+    private:
+        uint64_t _last;
+    };
+
+    /**
+     * 在作用域内标记当前线程正在向新加入的播放器回放gop缓存
+     */
+    class ReplayScope {
+    public:
+        ReplayScope();
+        ~ReplayScope();
+
+    private:
+        bool _last;
+    };
+
+    /**
+     * 当前线程是否正在回放gop缓存
+     */
+    static bool isReplaying();
+
+    /**
+     * 记录环形缓存数据写入到发送完毕的延时，回放gop缓存时不统计
+     */
+    template <typename list_type>
+    static void onSend(Type type, const list_type &list) {
+        auto stamp = list.getRingStamp();
+        if (stamp && !isReplaying()) {
+            auto now_stamp = now();
+            record(type, now_stamp > stamp ? now_stamp - stamp : 0);
+        }
+    }
+};
+
+/**
+ * 带有延时统计时间戳的包列表，为合并写缓存的输出，也是环形缓存中的数据
+ */
+template <typename T>
+class LatencyList : public toolkit::List<T> {
+public:
+    void setIngestStamp(uint64_t stamp) { _ingest_stamp = stamp; }
+    uint64_t getIngestStamp() const { return _ingest_stamp; }
+    void setRingStamp(uint64_t stamp) { _ring_stamp = stamp; }
+    uint64_t getRingStamp() const { return _ring_stamp; }
+
+private:
+    // 第一个包的输入时间
+    uint64_t _ingest_stamp = 0;
+    // 写入环形缓存的时间，为0时表示未统计
+    uint64_t _ring_stamp = 0;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_LATENCYSTAT_H
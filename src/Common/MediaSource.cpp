@@ -28,12 +28,32 @@ namespace toolkit {
 
 namespace mediakit {
 
-static recursive_mutex s_media_source_mtx;
 using StreamMap = unordered_map<string/*strema_id*/, weak_ptr<MediaSource> >;
 using AppStreamMap = unordered_map<string/*app*/, StreamMap>;
 using VhostAppStreamMap = unordered_map<string/*vhost*/, AppStreamMap>;
 using SchemaVhostAppStreamMap = unordered_map<string/*schema*/, VhostAppStreamMap>;
-static SchemaVhostAppStreamMap s_media_source_map;
+
+// 媒体源注册表分片个数，按(vhost, app, stream)哈希分布，降低海量流时的锁竞争
+// Number of media source registry shards, hashed by (vhost, app, stream) to reduce lock contention with massive streams
+static constexpr size_t kMediaSourceShardCount = 64;
+
+// 每个分片独占一个cache line，防止伪共享
+// Each shard owns its cache line to avoid false sharing
+struct alignas(64) MediaSourceShard {
+    // 递归锁: 在锁内释放MediaSource时，其析构函数会调用unregist并再次进入同一分片
+    // Recursive lock: releasing a MediaSource under the lock calls unregist from its destructor, re-entering the same shard
+    recursive_mutex mtx;
+    SchemaVhostAppStreamMap map;
+};
+static MediaSourceShard s_media_source_shards[kMediaSourceShardCount];
+
+static MediaSourceShard &getMediaSourceShard(const string &vhost, const string &app, const string &stream) {
+    std::hash<string> hasher;
+    size_t hash = hasher(vhost);
+    hash ^= hasher(app) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= hasher(stream) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return s_media_source_shards[hash % kMediaSourceShardCount];
+}
 
 string getOriginTypeString(MediaOriginType type){
 #define SWITCH_CASE(type) case MediaOriginType::type : return #type
@@ -75,6 +95,7 @@ ProtocolOption::ProtocolOption() {
     GET_CONFIG(bool, s_rtmp_demand, Protocol::kRtmpDemand);
     GET_CONFIG(bool, s_ts_demand, Protocol::kTSDemand);
     GET_CONFIG(bool, s_fmp4_demand, Protocol::kFMP4Demand);
+    GET_CONFIG(bool, s_shared_gop_cache, Protocol::kSharedGopCache);
 
     GET_CONFIG(bool, s_mp4_as_player, Protocol::kMP4AsPlayer);
     GET_CONFIG(uint32_t, s_mp4_max_second, Protocol::kMP4MaxSecond);
@@ -102,6 +123,7 @@ ProtocolOption::ProtocolOption() {
     rtmp_demand = s_rtmp_demand;
     ts_demand = s_ts_demand;
     fmp4_demand = s_fmp4_demand;
+    shared_gop_cache = s_shared_gop_cache;
 
     mp4_as_player = s_mp4_as_player;
     mp4_max_second = s_mp4_max_second;
@@ -379,9 +401,20 @@ void MediaSource::for_each_media(const function<void(const Ptr &src)> &cb,
                                  const string &app,
                                  const string &stream) {
     deque<Ptr> src_list;
-    {
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        for_each_media_l(s_media_source_map, src_list, schema, vhost, app, stream);
+    auto for_each_shard = [&](MediaSourceShard &shard) {
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        for_each_media_l(shard.map, src_list, schema, vhost, app, stream);
+    };
+    if (!vhost.empty() && !app.empty() && !stream.empty()) {
+        // 精确查找只需访问一个分片
+        // An exact lookup only touches one shard
+        for_each_shard(getMediaSourceShard(vhost, app, stream));
+    } else {
+        // 模糊遍历逐个分片加锁，不会长时间阻塞注册
+        // Wildcard iteration locks shards one by one, so registration is never stalled for long
+        for (auto &shard : s_media_source_shards) {
+            for_each_shard(shard);
+        }
     }
     for (auto &src : src_list) {
         cb(src);
@@ -525,8 +558,9 @@ void MediaSource::emitEvent(bool regist){
 void MediaSource::regist() {
     {
         //减小互斥锁临界区
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        auto &ref = s_media_source_map[_schema][_tuple.vhost][_tuple.app][_tuple.stream];
+        auto &shard = getMediaSourceShard(_tuple.vhost, _tuple.app, _tuple.stream);
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        auto &ref = shard.map[_schema][_tuple.vhost][_tuple.app][_tuple.stream];
         auto src = ref.lock();
         if (src) {
             if (src.get() == this) {
@@ -568,8 +602,9 @@ bool MediaSource::unregist() {
     bool ret = false;
     {
         //减小互斥锁临界区
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        erase_media_source(ret, this, s_media_source_map, _schema, _tuple.vhost, _tuple.app, _tuple.stream);
+        auto &shard = getMediaSourceShard(_tuple.vhost, _tuple.app, _tuple.stream);
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        erase_media_source(ret, this, shard.map, _schema, _tuple.vhost, _tuple.app, _tuple.stream);
     }
 
     if (ret) {
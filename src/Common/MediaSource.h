@@ -18,6 +18,7 @@
 #include "Network/Socket.h"
 #include "Extension/Track.h"
 #include "Record/Recorder.h"
+#include "Common/LatencyStat.h"
 
 namespace toolkit {
 class Session;
@@ -201,6 +202,8 @@ public:
     bool ts_demand;
     // http[s]-fmp4、ws[s]-fmp4协议是否按需生成
     bool fmp4_demand;
+    // 按需转协议时是否开启各协议共享的帧级别gop缓存
+    bool shared_gop_cache;
 
     //是否将mp4录制当做观看者
     bool mp4_as_player;
@@ -246,6 +249,7 @@ public:
         GET_OPT_VALUE(rtmp_demand);
         GET_OPT_VALUE(ts_demand);
         GET_OPT_VALUE(fmp4_demand);
+        GET_OPT_VALUE(shared_gop_cache);
 
         GET_OPT_VALUE(mp4_max_second);
         GET_OPT_VALUE(mp4_as_player);
@@ -369,6 +373,9 @@ public:
 
     virtual bool broadcastMessage(const toolkit::Any &data) { return false; }
 
+    // 获取帧输入到写入环形缓存的延时统计，不支持时返回nullptr
+    virtual const LatencyHistogram *getIngestLatency() const { return nullptr; }
+
     // 获取媒体源类型
     MediaOriginType getOriginType() const;
     // 获取媒体源url或者文件路径
@@ -0,0 +1,102 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include "Metrics.h"
+#include "ThreadShard.h"
+
+using namespace std;
+
+namespace mediakit {
+
+// 每个线程的计数器分片，只有本线程写入
+class MetricShard {
+public:
+    MetricShard() {
+        for (auto &counter : counters) {
+            counter = 0;
+        }
+    }
+
+    std::atomic<uint64_t> counters[Metrics::kCounterMax];
+};
+
+using MetricShardList = ThreadShardList<MetricShard>;
+
+class MetricInfo {
+public:
+    const char *name;
+    const char *labels;
+    const char *help;
+};
+
+// 同名指标按名称分组输出，每个指标名第一次出现时需要提供help
+static const MetricInfo s_metric_info[Metrics::kCounterMax] = {
+    { "zlm_bytes_received_total", "protocol=\"rtsp\"", "Total bytes received per protocol" },
+    { "zlm_bytes_sent_total", "protocol=\"rtsp\"", "Total bytes sent per protocol" },
+    { "zlm_bytes_received_total", "protocol=\"rtmp\"", nullptr },
+    { "zlm_bytes_sent_total", "protocol=\"rtmp\"", nullptr },
+    { "zlm_bytes_received_total", "protocol=\"http\"", nullptr },
+    { "zlm_bytes_sent_total", "protocol=\"http\"", nullptr },
+    { "zlm_bytes_received_total", "protocol=\"webrtc\"", nullptr },
+    { "zlm_bytes_sent_total", "protocol=\"webrtc\"", nullptr },
+    { "zlm_bytes_received_total", "protocol=\"srt\"", nullptr },
+    { "zlm_bytes_sent_total", "protocol=\"srt\"", nullptr },
+    { "zlm_bytes_received_total", "protocol=\"rtp\"", nullptr },
+    { "zlm_packets_dropped_total", "reason=\"rtp_sort\"", "Total packets dropped" },
+    { "zlm_packets_dropped_total", "reason=\"rtp_ssrc_mismatch\"", nullptr },
+    { "zlm_packets_dropped_total", "reason=\"udp_truncated\"", nullptr },
+    { "zlm_nack_packets_total", "protocol=\"webrtc\"", "Total packets requested by nack" },
+    { "zlm_retransmit_packets_total", "protocol=\"webrtc\"", "Total packets retransmitted" },
+    { "zlm_retransmit_miss_packets_total", "protocol=\"webrtc\"", "Total nack requested packets not found in retransmit cache" },
+    { "zlm_nack_packets_total", "protocol=\"srt\"", nullptr },
+    { "zlm_retransmit_packets_total", "protocol=\"srt\"", nullptr },
+    { "zlm_retransmit_miss_packets_total", "protocol=\"srt\"", nullptr },
+};
+
+void Metrics::add(Counter counter, uint64_t value) {
+    // 只有本线程写入，不需要原子的读改写
+    auto &ref = MetricShardList::Instance().getThreadShard().counters[counter];
+    ref.store(ref.load(memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+uint64_t Metrics::get(Counter counter) {
+    uint64_t ret = 0;
+    MetricShardList::Instance().for_each([&](const MetricShard &shard) { ret += shard.counters[counter].load(memory_order_relaxed); });
+    return ret;
+}
+
+void Metrics::dumpPrometheus(std::ostream &out) {
+    uint64_t values[kCounterMax] = { 0 };
+    MetricShardList::Instance().for_each([&](const MetricShard &shard) {
+        for (int i = 0; i < kCounterMax; ++i) {
+            values[i] += shard.counters[i].load(memory_order_relaxed);
+        }
+    });
+
+    // 按指标名分组输出
+    bool dumped[kCounterMax] = { false };
+    for (int i = 0; i < kCounterMax; ++i) {
+        if (dumped[i]) {
+            continue;
+        }
+        auto &info = s_metric_info[i];
+        out << "# HELP " << info.name << " " << info.help << "\n";
+        out << "# TYPE " << info.name << " counter\n";
+        for (int j = i; j < kCounterMax; ++j) {
+            if (!dumped[j] && !strcmp(s_metric_info[j].name, info.name)) {
+                dumped[j] = true;
+                out << info.name << "{" << s_metric_info[j].labels << "} " << values[j] << "\n";
+            }
+        }
+    }
+}
+
+} // namespace mediakit
@@ -0,0 +1,71 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_METRICS_H
+#define ZLMEDIAKIT_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace mediakit {
+
+/**
+ * 全局计数器，用于prometheus /metrics导出
+ * 每个线程累加自己的分片(relaxed原子变量，不加锁不分配内存)，只在导出时合并
+ */
+class Metrics {
+public:
+    enum Counter {
+        // 各协议收发字节数
+        kRtspBytesIn = 0,
+        kRtspBytesOut,
+        kRtmpBytesIn,
+        kRtmpBytesOut,
+        kHttpBytesIn,
+        kHttpBytesOut,
+        kWebRtcBytesIn,
+        kWebRtcBytesOut,
+        kSrtBytesIn,
+        kSrtBytesOut,
+        kRtpBytesIn,
+        // 丢包数
+        kDropRtpSort,
+        kDropRtpSsrc,
+        kDropUdpTruncated,
+        // webrtc nack请求的包数、重传包数、重传时已经不在缓存中的包数
+        kWebRtcNack,
+        kWebRtcRetransmit,
+        kWebRtcRetransmitMiss,
+        // srt nack请求的包数、重传包数、重传时已经不在缓存中的包数
+        kSrtNack,
+        kSrtRetransmit,
+        kSrtRetransmitMiss,
+        kCounterMax
+    };
+
+    /**
+     * 累加当前线程的计数器分片
+     */
+    static void add(Counter counter, uint64_t value = 1);
+
+    /**
+     * 合并所有线程的计数
+     */
+    static uint64_t get(Counter counter);
+
+    /**
+     * 以prometheus文本格式输出所有计数器
+     */
+    static void dumpPrometheus(std::ostream &out);
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_METRICS_H
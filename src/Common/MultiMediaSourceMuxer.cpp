@@ -179,6 +179,66 @@ void MultiMediaSourceMuxer::forEachRtpSender(const std::function<void(const std:
     }
 }
 
+size_t MultiMediaSourceMuxer::getGopCacheBytes() const {
+    return _gop_cache ? _gop_cache->bytes() : 0;
+}
+
+// 收集配置帧及其后的关键帧(可能由多个slice组成)，关键帧完整时返回true
+static bool collectKeyFrame(vector<Frame::Ptr> &frames, const Frame::Ptr &frame) {
+    if (frame->getTrackType() != TrackVideo || frame->dropAble()) {
+        return false;
+    }
+    auto &last = frames.empty() ? frame : frames.back();
+    auto have_key = !frames.empty() && last->keyFrame() && !last->configFrame();
+    if (have_key && (!frame->keyFrame() || frame->configFrame() || frame->dts() != last->dts())) {
+        // 遇到下一帧，关键帧已经完整
+        return true;
+    }
+    if (frame->keyFrame() || frame->configFrame()) {
+        frames.emplace_back(Frame::getCacheAbleFrame(frame));
+    } else {
+        // 非关键帧，之前的配置帧无用
+        frames.clear();
+    }
+    return false;
+}
+
+uint64_t MultiMediaSourceMuxer::getKeyFrame(const onKeyFrame &cb) {
+    if (!haveVideo()) {
+        cb({});
+        return 0;
+    }
+    if (_gop_cache) {
+        vector<Frame::Ptr> frames;
+        bool complete = false;
+        _gop_cache->replay(0, [&](const Frame::Ptr &frame) {
+            complete = complete || collectKeyFrame(frames, frame);
+        });
+        if (complete || (!frames.empty() && frames.back()->keyFrame() && !frames.back()->configFrame())) {
+            cb(frames);
+            return 0;
+        }
+    }
+    auto id = ++_key_frame_waiter_id;
+    _key_frame_waiters.emplace(id, cb);
+    return id;
+}
+
+void MultiMediaSourceMuxer::cancelKeyFrame(uint64_t id) {
+    _key_frame_waiters.erase(id);
+    if (_key_frame_waiters.empty()) {
+        // 没有等待者了，不再收集关键帧
+        _key_frames.clear();
+    }
+}
+
+template <typename MUXER>
+void MultiMediaSourceMuxer::setGopCache(const MUXER &muxer) const {
+    if (muxer && _gop_cache) {
+        muxer->setGopCache(_gop_cache);
+    }
+}
+
 MultiMediaSourceMuxer::MultiMediaSourceMuxer(const MediaTuple& tuple, float dur_sec, const ProtocolOption &option): _tuple(tuple) {
     if (!option.stream_replace.empty()) {
         // 支持在on_publish hook中替换stream_id
@@ -212,6 +272,15 @@ MultiMediaSourceMuxer::MultiMediaSourceMuxer(const MediaTuple& tuple, float dur_
         _fmp4 = dynamic_pointer_cast<FMP4MediaSourceMuxer>(Recorder::createRecorder(Recorder::type_fmp4, _tuple, option));
     }
 
+    if (option.shared_gop_cache && (option.rtsp_demand || option.rtmp_demand || option.ts_demand || option.fmp4_demand)) {
+        // 按需转协议时，无人观看的协议不缓存gop，首次播放时从共享的帧级别gop缓存打包
+        _gop_cache = std::make_shared<FrameGopCache>();
+        setGopCache(_rtmp);
+        setGopCache(_rtsp);
+        setGopCache(_ts);
+        setGopCache(_fmp4);
+    }
+
     //音频相关设置
     enableAudio(option.enable_audio);
     enableMuteAudio(option.add_mute_audio);
@@ -338,6 +407,7 @@ bool MultiMediaSourceMuxer::setupRecord(MediaSource &sender, Recorder::type type
                 auto fmp4 = dynamic_pointer_cast<FMP4MediaSourceMuxer>(makeRecorder(sender, getTracks(), type, _option));
                 if (fmp4) {
                     fmp4->setListener(shared_from_this());
+                    setGopCache(fmp4);
                 }
                 _fmp4 = fmp4;
             } else if (!start && _fmp4) {
@@ -350,6 +420,7 @@ bool MultiMediaSourceMuxer::setupRecord(MediaSource &sender, Recorder::type type
                 auto ts = dynamic_pointer_cast<TSMediaSourceMuxer>(makeRecorder(sender, getTracks(), type, _option));
                 if (ts) {
                     ts->setListener(shared_from_this());
+                    setGopCache(ts);
                 }
                 _ts = ts;
             } else if (!start && _ts) {
@@ -580,6 +651,10 @@ void MultiMediaSourceMuxer::createGopCacheIfNeed() {
 void MultiMediaSourceMuxer::resetTracks() {
     MediaSink::resetTracks();
 
+    if (_gop_cache) {
+        _gop_cache->clear();
+    }
+
     if (_rtmp) {
         _rtmp->resetTracks();
     }
@@ -604,6 +679,8 @@ void MultiMediaSourceMuxer::resetTracks() {
 }
 
 bool MultiMediaSourceMuxer::onTrackFrame(const Frame::Ptr &frame_in) {
+    // 标记帧输入时间，用于统计输入到写入环形缓存的延时
+    LatencyStat::IngestScope scope;
     auto frame = frame_in;
     if (_option.modify_stamp != ProtocolOption::kModifyStampOff) {
         // 时间戳不采用原始的绝对时间戳
@@ -639,9 +716,24 @@ bool MultiMediaSourceMuxer::onTrackFrame_l(const Frame::Ptr &frame_in) {
     if (_fmp4) {
         ret = _fmp4->inputFrame(frame) ? true : ret;
     }
-    if (_ring) {
-        // 此场景由于直接转发，可能存在切换线程引起的数据被缓存在管道，所以需要CacheAbleFrame
+    if (_ring || _gop_cache) {
+        // 此场景由于直接转发或缓存，可能存在切换线程引起的数据被缓存在管道，所以需要CacheAbleFrame
         frame = Frame::getCacheAbleFrame(frame);
+    }
+    if (!_key_frame_waiters.empty() && collectKeyFrame(_key_frames, frame)) {
+        auto waiters = std::move(_key_frame_waiters);
+        auto frames = std::move(_key_frames);
+        _key_frame_waiters.clear();
+        _key_frames.clear();
+        for (auto &pr : waiters) {
+            pr.second(frames);
+        }
+    }
+    if (_gop_cache) {
+        // 必须在各协议输入之后再写入，各协议依赖此顺序计算帧序号
+        _gop_cache->inputFrame(frame, haveVideo());
+    }
+    if (_ring) {
         if (frame->getTrackType() == TrackVideo) {
             // 视频时，遇到第一帧配置帧或关键帧则标记为gop开始处
             auto video_key_pos = frame->keyFrame() || frame->configFrame();
@@ -662,7 +754,9 @@ bool MultiMediaSourceMuxer::isEnabled(){
     if (!_is_enable || _last_check.elapsedTime() > stream_none_reader_delay_ms) {
         //无人观看时，每次检查是否真的无人观看
         //有人观看时，则延迟一定时间检查一遍是否无人观看了(节省性能)
-        _is_enable = (_rtmp ? _rtmp->isEnabled() : false) ||
+        // 有截图等请求在等待关键帧时也需要输入帧
+        _is_enable = !_key_frame_waiters.empty() ||
+                     (_rtmp ? _rtmp->isEnabled() : false) ||
                      (_rtsp ? _rtsp->isEnabled() : false) ||
                      (_ts ? _ts->isEnabled() : false) ||
                      (_fmp4 ? _fmp4->isEnabled() : false) ||
@@ -674,6 +768,9 @@ bool MultiMediaSourceMuxer::isEnabled(){
         if (_is_enable) {
             //无人观看时，不刷新计时器,因为无人观看时每次都会检查一遍，所以刷新计数器无意义且浪费cpu
             _last_check.resetTime();
+        } else if (_gop_cache) {
+            // 停止输入帧后共享gop缓存不再更新，清空以免下次开启时回放过期的gop
+            _gop_cache->clear();
         }
     }
     return _is_enable;
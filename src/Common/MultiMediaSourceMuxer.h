@@ -14,6 +14,7 @@
 #include "Common/Stamp.h"
 #include "Common/MediaSource.h"
 #include "Common/MediaSink.h"
+#include "Common/FrameGopCache.h"
 #include "Record/Recorder.h"
 #include "Rtp/RtpSender.h"
 #include "Record/HlsRecorder.h"
@@ -29,6 +30,7 @@ class MultiMediaSourceMuxer : public MediaSourceEventInterceptor, public MediaSi
 public:
     using Ptr = std::shared_ptr<MultiMediaSourceMuxer>;
     using RingType = toolkit::RingBuffer<Frame::Ptr>;
+    using onKeyFrame = std::function<void(const std::vector<Frame::Ptr> &frames)>;
 
     class Listener {
     public:
@@ -135,6 +137,28 @@ public:
 
     void forEachRtpSender(const std::function<void(const std::string &ssrc)> &cb) const;
 
+    /**
+     * 获取共享gop缓存字节数，未开启shared_gop_cache时为0
+     * 只能在归属线程调用
+     */
+    size_t getGopCacheBytes() const;
+
+    /**
+     * 获取最近的视频关键帧及其配置帧，用于截图等场景
+     * 开启shared_gop_cache时直接从gop缓存获取，否则等待下一个关键帧
+     * 没有视频时立即回调空列表，流注销前都没有关键帧时不回调
+     * 只能在归属线程调用
+     * @return 等待关键帧的请求id，用于超时取消；已经立即回调时返回0
+     */
+    uint64_t getKeyFrame(const onKeyFrame &cb);
+
+    /**
+     * 取消等待关键帧的请求，例如截图超时
+     * 只能在归属线程调用
+     * @param id getKeyFrame返回的请求id
+     */
+    void cancelKeyFrame(uint64_t id);
+
 protected:
     /////////////////////////////////MediaSink override/////////////////////////////////
 
@@ -159,6 +183,8 @@ protected:
 
 private:
     void createGopCacheIfNeed();
+    template <typename MUXER>
+    void setGopCache(const MUXER &muxer) const;
 
 private:
     bool _is_enable = false;
@@ -181,6 +207,11 @@ private:
     HlsFMP4Recorder::Ptr _hls_fmp4;
     toolkit::EventPoller::Ptr _poller;
     RingType::Ptr _ring;
+    FrameGopCache::Ptr _gop_cache;
+    // 等待关键帧的请求及正在收集的关键帧
+    uint64_t _key_frame_waiter_id = 0;
+    std::map<uint64_t, onKeyFrame> _key_frame_waiters;
+    std::vector<Frame::Ptr> _key_frames;
 
     //对象个数统计
     toolkit::ObjectStatistic<MultiMediaSourceMuxer> _statistic;
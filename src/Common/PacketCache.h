@@ -12,6 +12,7 @@
 #define ZLMEDIAKIT_PACKET_CACHE_H_
 
 #include "Common/config.h"
+#include "Common/LatencyStat.h"
 #include "Util/List.h"
 
 namespace mediakit {
@@ -29,7 +30,7 @@ private:
 /// \tparam packet 包类型
 /// \tparam policy 刷新缓存策略
 /// \tparam packet_list 包缓存类型
-template<typename packet, typename policy = FlushPolicy, typename packet_list = toolkit::List<std::shared_ptr<packet> > >
+template<typename packet, typename policy = FlushPolicy, typename packet_list = LatencyList<std::shared_ptr<packet> > >
 class PacketCache {
 public:
     PacketCache() { _cache = std::make_shared<packet_list>(); }
@@ -42,6 +43,10 @@ public:
             flush();
         }
 
+        if (_cache->empty()) {
+            // 以第一个包的输入时间统计延时
+            _cache->setIngestStamp(LatencyStat::getIngestStamp());
+        }
         //追加数据到最后
         _cache->emplace_back(std::move(pkt));
         if (key_pos) {
@@ -57,6 +62,14 @@ public:
         if (_cache->empty()) {
             return;
         }
+        if (LatencyStat::enabled()) {
+            auto now = LatencyStat::now();
+            auto ingest = _cache->getIngestStamp();
+            auto delay = now > ingest ? now - ingest : 0;
+            LatencyStat::record(LatencyStat::kIngestToRing, delay);
+            _ingest_latency.record(delay);
+            _cache->setRingStamp(now);
+        }
         onFlush(std::move(_cache), _key_pos);
         _cache = std::make_shared<packet_list>();
         _key_pos = false;
@@ -68,6 +81,11 @@ public:
 
     virtual void onFlush(std::shared_ptr<packet_list>, bool key_pos) = 0;
 
+    /**
+     * 获取本缓存输入到写入环形缓存的延时统计
+     */
+    const LatencyHistogram &getIngestLatency() const { return _ingest_latency; }
+
 private:
     bool flushImmediatelyWhenCloseMerge() {
         // 一般的协议关闭合并写时，立即刷新缓存，这样可以减少一帧的延时，但是rtp例外
@@ -84,6 +102,7 @@ private:
     bool _key_pos = false;
     policy _policy;
     std::shared_ptr<packet_list> _cache;
+    LatencyHistogram _ingest_latency;
 };
 }
 
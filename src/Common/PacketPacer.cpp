@@ -0,0 +1,176 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+#include <algorithm>
+#include "PacketPacer.h"
+#include "Common/config.h"
+#include "Util/util.h"
+#include "TimerWheel.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+/**
+ * 每个poller线程一个调度器，定时驱动该线程上所有有缓存的pacer
+ */
+class PacerScheduler {
+public:
+    static PacerScheduler &Instance() {
+        static thread_local PacerScheduler s_instance;
+        return s_instance;
+    }
+
+    /**
+     * 加入调度，不在poller线程时返回false
+     */
+    bool addPacer(const PacketPacerBase::Ptr &pacer) {
+        if (!_running) {
+            auto poller = EventPoller::getCurrentPoller();
+            if (!poller) {
+                return false;
+            }
+            GET_CONFIG(uint32_t, interval_ms, General::kPacerIntervalMS);
+            _running = true;
+            uint64_t interval = MAX(interval_ms, 1u);
+            _task = TimerWheel::doDelayTask(poller, interval, [this, interval]() -> uint64_t { return onTick() ? interval : 0; });
+        }
+        _pacers.emplace_back(pacer);
+        return true;
+    }
+
+    /**
+     * 获取线程共享的可用发送预算
+     */
+    size_t getSharedBudget(uint64_t now) {
+        GET_CONFIG(uint32_t, max_bitrate, General::kPacerMaxBitrate);
+        if (!max_bitrate) {
+            return SIZE_MAX;
+        }
+        // 配置单位为kbps，正好是每毫秒的bit数
+        int64_t max_tokens = (int64_t)max_bitrate * PacketPacerBase::kMaxBurstMS / 8;
+        _shared_tokens = MIN(_shared_tokens + (int64_t)((now - _last_refill) * max_bitrate / 8), max_tokens);
+        _last_refill = now;
+        return _shared_tokens > 0 ? (size_t)_shared_tokens : 0;
+    }
+
+    void onSent(size_t bytes) {
+        _shared_tokens -= bytes;
+    }
+
+private:
+    PacerScheduler() = default;
+
+    bool onTick() {
+        auto now = getCurrentMillisecond();
+        // 轮流从不同的pacer开始发送，共享预算不足时避免总是饿死后面的pacer
+        auto size = _pacers.size();
+        for (size_t i = 0; i < size; ++i) {
+            // 发送回调中可能有新的pacer加入调度，所以不能持有引用
+            auto index = (_offset + i) % size;
+            auto pacer = _pacers[index].lock();
+            if (!pacer) {
+                continue;
+            }
+            auto budget = pacer->getBudget(now);
+            if (budget) {
+                pacer->sendCache(budget);
+            }
+            if (!pacer->_cache_bytes) {
+                // 缓存已经发送完毕，移出调度
+                pacer->_scheduled = false;
+                _pacers[index].reset();
+            }
+        }
+        _offset = size ? (_offset + 1) % size : 0;
+        // 移除已经不需要调度的pacer
+        _pacers.erase(std::remove_if(_pacers.begin(), _pacers.end(), [](const weak_ptr<PacketPacerBase> &pacer) {
+            return pacer.expired();
+        }), _pacers.end());
+        _running = !_pacers.empty();
+        return _running;
+    }
+
+private:
+    bool _running = false;
+    size_t _offset = 0;
+    int64_t _shared_tokens = 0;
+    uint64_t _last_refill = 0;
+    TimerWheel::Task::Ptr _task;
+    vector<weak_ptr<PacketPacerBase> > _pacers;
+};
+
+uint64_t PacketPacerBase::getRate() const {
+    if (!_input_rate) {
+        return 0;
+    }
+    return (uint64_t)(MAX(_input_rate, kMinRate) * _ratio);
+}
+
+void PacketPacerBase::refillTokens(uint64_t now) {
+    auto rate = getRate();
+    if (!_last_tick) {
+        _last_tick = now;
+    }
+    // rate单位为bps，令牌单位为字节
+    int64_t max_tokens = rate * kMaxBurstMS / 8000;
+    _tokens = MIN(_tokens + (int64_t)(rate * (now - _last_tick) / 8000), max_tokens);
+    _last_tick = now;
+}
+
+size_t PacketPacerBase::getBudget(uint64_t now) {
+    refillTokens(now);
+    if (_tokens <= 0) {
+        return 0;
+    }
+    return MIN((size_t)_tokens, PacerScheduler::Instance().getSharedBudget(now));
+}
+
+size_t PacketPacerBase::onInput(size_t bytes) {
+    _cache_bytes += bytes;
+    if (!isEnabled()) {
+        // 关闭了平滑发送，全部立即发送
+        return SIZE_MAX;
+    }
+    auto now = getCurrentMillisecond();
+    if (!_window_begin) {
+        _window_begin = now;
+    }
+    _window_bytes += bytes;
+    if (now - _window_begin >= kRateWindowMS) {
+        // 统计输入码率
+        _input_rate = _window_bytes * 8000 / (now - _window_begin);
+        _window_bytes = 0;
+        _window_begin = now;
+    }
+
+    auto rate = getRate();
+    if (!rate || _cache_bytes * 8000 / rate > kMaxDelayMS) {
+        // 还没有统计出输入码率或者积压太多，全部立即发送
+        return SIZE_MAX;
+    }
+    if (!_scheduled) {
+        if (!PacerScheduler::Instance().addPacer(shared_from_this())) {
+            // 不在poller线程，无法定时发送
+            return SIZE_MAX;
+        }
+        _scheduled = true;
+    }
+    return getBudget(now);
+}
+
+void PacketPacerBase::onSent(size_t bytes) {
+    _tokens -= bytes;
+    PacerScheduler::Instance().onSent(bytes);
+}
+
+} // namespace mediakit
@@ -0,0 +1,171 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_PACKETPACER_H
+#define ZLMEDIAKIT_PACKETPACER_H
+
+#include <deque>
+#include <cstdint>
+#include <memory>
+#include <functional>
+
+namespace mediakit {
+
+/**
+ * 发送端平滑发送(pacing)基类
+ * 按照输入码率的倍数释放缓存的包，避免关键帧等突发数据以线速发出导致交换机缓存溢出丢包
+ * 同一个poller线程上的所有pacer由时间轮上的同一个定时任务驱动，并共享该线程的发送预算(general.pacer_max_bitrate)
+ * 只能在创建者所在的poller线程使用
+ */
+class PacketPacerBase : public std::enable_shared_from_this<PacketPacerBase> {
+public:
+    using Ptr = std::shared_ptr<PacketPacerBase>;
+
+    // 码率统计周期，单位毫秒
+    static constexpr uint64_t kRateWindowMS = 1000;
+    // 令牌桶最大突发时长，单位毫秒
+    static constexpr uint64_t kMaxBurstMS = 10;
+    // 缓存的数据超过该时长则全部立即发送，单位毫秒
+    static constexpr uint64_t kMaxDelayMS = 500;
+    // 最小发送码率，单位bps
+    static constexpr uint64_t kMinRate = 500 * 1000;
+
+    virtual ~PacketPacerBase() = default;
+
+    /**
+     * 设置发送码率为输入码率的倍数，为0时关闭平滑发送，直接发送
+     */
+    void setRatio(float ratio) { _ratio = ratio; }
+    bool isEnabled() const { return _ratio > 0; }
+
+    /**
+     * 获取缓存中等待发送的字节数
+     */
+    size_t getCacheBytes() const { return _cache_bytes; }
+
+    /**
+     * 获取当前目标发送码率，单位bps，为0时表示还在统计输入码率
+     */
+    uint64_t getRate() const;
+
+protected:
+    /**
+     * 统计输入并加入调度
+     * @param bytes 新输入的字节数
+     * @return 现在可以发送的字节数，SIZE_MAX表示立即发送全部缓存
+     */
+    size_t onInput(size_t bytes);
+
+    /**
+     * 发送完毕后扣除令牌
+     */
+    void onSent(size_t bytes);
+
+    /**
+     * 发送缓存的包
+     * @param budget 最多发送的字节数，超过前至少发送一个包
+     * @return 实际发送的字节数
+     */
+    virtual size_t sendCache(size_t budget) = 0;
+
+private:
+    friend class PacerScheduler;
+    void refillTokens(uint64_t now);
+    size_t getBudget(uint64_t now);
+
+protected:
+    size_t _cache_bytes = 0;
+
+private:
+    bool _scheduled = false;
+    float _ratio = 0;
+    int64_t _tokens = 0;
+    uint64_t _last_tick = 0;
+    uint64_t _window_begin = 0;
+    uint64_t _window_bytes = 0;
+    uint64_t _input_rate = 0;
+};
+
+/**
+ * 平滑发送器，Packet需要提供size()方法
+ */
+template <typename Packet>
+class PacketPacer : public PacketPacerBase {
+public:
+    using Ptr = std::shared_ptr<PacketPacer>;
+    // flush为本次发送的最后一个包
+    using OnSend = std::function<void(Packet pkt, bool flush)>;
+
+    PacketPacer(OnSend cb) { _cb = std::move(cb); }
+
+    /**
+     * 输入待发送的包，调用flush后才会发送
+     */
+    void inputPacket(Packet pkt) {
+        _input_bytes += pkt->size();
+        _cache.emplace_back(std::move(pkt));
+    }
+
+    /**
+     * 一批包输入完毕，令牌足够的部分立即发送，剩余的由定时器平滑发送
+     * 未开启平滑发送时全部立即发送
+     */
+    void flush() {
+        auto budget = onInput(_input_bytes);
+        _input_bytes = 0;
+        if (budget) {
+            sendCache(budget);
+        }
+    }
+
+    /**
+     * 不受码率限制，立即发送全部缓存
+     */
+    void sendAll() {
+        // 尚未flush的包也一起发送
+        _cache_bytes += _input_bytes;
+        _input_bytes = 0;
+        sendCache(SIZE_MAX);
+    }
+
+    /**
+     * 清空缓存
+     */
+    void clear() {
+        _cache.clear();
+        _cache_bytes = 0;
+        _input_bytes = 0;
+    }
+
+private:
+    size_t sendCache(size_t budget) override {
+        size_t sent = 0;
+        while (!_cache.empty() && sent < budget) {
+            auto pkt = std::move(_cache.front());
+            _cache.pop_front();
+            auto bytes = pkt->size();
+            sent += bytes;
+            _cache_bytes -= bytes;
+            _cb(std::move(pkt), _cache.empty() || sent >= budget);
+        }
+        if (budget != SIZE_MAX) {
+            onSent(sent);
+        }
+        return sent;
+    }
+
+private:
+    size_t _input_bytes = 0;
+    OnSend _cb;
+    std::deque<Packet> _cache;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_PACKETPACER_H
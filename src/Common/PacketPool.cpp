@@ -0,0 +1,336 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "PacketPool.h"
+#include "ThreadShard.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+#if defined(ENABLE_PACKET_POOL)
+
+class ThreadCache;
+
+// 每个内存块的头部，16字节保证负载对齐
+class BlockHeader {
+public:
+    ThreadCache *owner;
+    size_t size_class;
+
+    BlockHeader *&next() { return *(BlockHeader **)(this + 1); }
+};
+
+// 线程退出后其他线程归还的块直接释放
+static BlockHeader *const kRemoteClosed = (BlockHeader *)1;
+
+// 每个线程的缓存，线程退出时释放空闲块，但缓存对象本身不释放，保证其他线程归还的块不会访问野指针
+class ThreadCache {
+public:
+    class FreeList {
+    public:
+        BlockHeader *head = nullptr;
+        // 只有本线程写入，其他线程统计时读取
+        std::atomic<size_t> count { 0 };
+    };
+
+    ThreadCache() {
+        for (size_t i = 0; i < PacketPool::kClassCount; ++i) {
+            max_count[i] = max(PacketPool::kMaxCacheBytes >> (i + PacketPool::kMinShift), (size_t)16);
+        }
+    }
+
+    bool push(BlockHeader *block) {
+        auto &list = lists[block->size_class];
+        auto count = list.count.load(memory_order_relaxed);
+        if (exited || count >= max_count[block->size_class]) {
+            return false;
+        }
+        block->next() = list.head;
+        list.head = block;
+        list.count.store(count + 1, memory_order_relaxed);
+        return true;
+    }
+
+    BlockHeader *pop(size_t size_class) {
+        auto &list = lists[size_class];
+        auto block = list.head;
+        if (block) {
+            list.head = block->next();
+            list.count.store(list.count.load(memory_order_relaxed) - 1, memory_order_relaxed);
+        }
+        return block;
+    }
+
+    // 其他线程归还块，无锁入栈
+    void pushRemote(BlockHeader *block) {
+        auto head = remote.load(memory_order_relaxed);
+        do {
+            if (head == kRemoteClosed) {
+                // 所属线程已经退出
+                free(block);
+                return;
+            }
+            block->next() = head;
+        } while (!remote.compare_exchange_weak(head, block, memory_order_release, memory_order_relaxed));
+    }
+
+    // 回收其他线程归还的块
+    void drainRemote() {
+        auto block = remote.exchange(nullptr, memory_order_acquire);
+        while (block) {
+            auto next = block->next();
+            if (!push(block)) {
+                free(block);
+            }
+            block = next;
+        }
+    }
+
+    // 线程退出，释放所有空闲块，并且不再接收其他线程归还的块
+    void release() {
+        exited = true;
+        for (size_t i = 0; i < PacketPool::kClassCount; ++i) {
+            while (auto block = pop(i)) {
+                free(block);
+            }
+        }
+        auto block = remote.exchange(kRemoteClosed, memory_order_acquire);
+        while (block) {
+            auto next = block->next();
+            free(block);
+            block = next;
+        }
+    }
+
+    static void addCounter(std::atomic<uint64_t> &counter) {
+        // 只有本线程写入，不需要原子的读改写
+        counter.store(counter.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    }
+
+public:
+    // 是否已经被线程退出释放，只有本线程访问
+    bool exited = false;
+    // 是否已经注册线程退出回调，只有本线程访问
+    bool registered = false;
+    FreeList lists[PacketPool::kClassCount];
+    size_t max_count[PacketPool::kClassCount];
+    std::atomic<BlockHeader *> remote { nullptr };
+    std::atomic<uint64_t> hit { 0 };
+    std::atomic<uint64_t> miss { 0 };
+    std::atomic<uint64_t> remote_free { 0 };
+};
+
+using ThreadCacheList = ThreadShardList<ThreadCache>;
+
+// 线程退出时释放本线程的缓存
+class ThreadCacheReleaser {
+public:
+    ThreadCacheReleaser(ThreadCache *cache) : _cache(cache) {}
+    ~ThreadCacheReleaser() { _cache->release(); }
+
+private:
+    ThreadCache *_cache;
+};
+
+static ThreadCache &getThreadCache() {
+    auto &cache = ThreadCacheList::Instance().getThreadShard();
+    if (!cache.registered) {
+        cache.registered = true;
+        static thread_local ThreadCacheReleaser s_releaser(&cache);
+    }
+    return cache;
+}
+
+static size_t getSizeClass(size_t bytes) {
+    size_t shift = PacketPool::kMinShift;
+    while (((size_t)1 << shift) < bytes) {
+        ++shift;
+    }
+    return shift - PacketPool::kMinShift;
+}
+
+void *PacketPool::allocate(size_t size) {
+    auto bytes = size + sizeof(BlockHeader);
+    if (bytes > ((size_t)1 << kMaxShift)) {
+        // 超过最大规格，直接分配
+        auto block = (BlockHeader *)malloc(bytes);
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        block->owner = nullptr;
+        block->size_class = kClassCount;
+        return block + 1;
+    }
+    auto size_class = getSizeClass(bytes);
+    auto &cache = getThreadCache();
+    auto block = cache.pop(size_class);
+    if (!block && !cache.exited && cache.remote.load(memory_order_relaxed)) {
+        cache.drainRemote();
+        block = cache.pop(size_class);
+    }
+    if (block) {
+        ThreadCache::addCounter(cache.hit);
+        return block + 1;
+    }
+    ThreadCache::addCounter(cache.miss);
+    block = (BlockHeader *)malloc((size_t)1 << (size_class + kMinShift));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    block->owner = &cache;
+    block->size_class = size_class;
+    return block + 1;
+}
+
+void PacketPool::deallocate(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    auto block = (BlockHeader *)ptr - 1;
+    if (!block->owner) {
+        free(block);
+        return;
+    }
+    auto &cache = getThreadCache();
+    if (block->owner == &cache) {
+        if (!cache.push(block)) {
+            free(block);
+        }
+        return;
+    }
+    // 归还给分配该块的线程
+    ThreadCache::addCounter(cache.remote_free);
+    block->owner->pushRemote(block);
+}
+
+template <typename FUNC>
+static uint64_t sumCache(FUNC &&func) {
+    uint64_t ret = 0;
+    ThreadCacheList::Instance().for_each([&](const ThreadCache &cache) { ret += func(cache); });
+    return ret;
+}
+
+uint64_t PacketPool::getHitCount() {
+    return sumCache([](const ThreadCache &cache) { return cache.hit.load(memory_order_relaxed); });
+}
+
+uint64_t PacketPool::getMissCount() {
+    return sumCache([](const ThreadCache &cache) { return cache.miss.load(memory_order_relaxed); });
+}
+
+uint64_t PacketPool::getRemoteFreeCount() {
+    return sumCache([](const ThreadCache &cache) { return cache.remote_free.load(memory_order_relaxed); });
+}
+
+uint64_t PacketPool::getCacheBytes() {
+    return sumCache([](const ThreadCache &cache) {
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < kClassCount; ++i) {
+            bytes += cache.lists[i].count.load(memory_order_relaxed) << (i + kMinShift);
+        }
+        return bytes;
+    });
+}
+
+#else
+
+void *PacketPool::allocate(size_t size) {
+    auto ret = malloc(size);
+    if (!ret) {
+        throw std::bad_alloc();
+    }
+    return ret;
+}
+
+void PacketPool::deallocate(void *ptr) {
+    free(ptr);
+}
+
+uint64_t PacketPool::getHitCount() {
+    return 0;
+}
+
+uint64_t PacketPool::getMissCount() {
+    return 0;
+}
+
+uint64_t PacketPool::getRemoteFreeCount() {
+    return 0;
+}
+
+uint64_t PacketPool::getCacheBytes() {
+    return 0;
+}
+
+#endif // defined(ENABLE_PACKET_POOL)
+
+///////////////////////////////////////////PooledBuffer///////////////////////////////////////////
+
+PooledBuffer::Ptr PooledBuffer::create(size_t capacity) {
+    auto ret = makePooledShared(new PooledBuffer);
+    if (capacity) {
+        ret->setCapacity(capacity);
+    }
+    return ret;
+}
+
+PooledBuffer::~PooledBuffer() {
+    PacketPool::deallocate(_data);
+}
+
+void PooledBuffer::setCapacity(size_t capacity) {
+    if (_data) {
+        do {
+            if (capacity > _capacity) {
+                // 请求的内存大于当前内存，那么重新分配
+                break;
+            }
+            if (_capacity < 2 * 1024) {
+                // 2K以下，不重复开辟内存，直接复用
+                return;
+            }
+            if (2 * capacity > _capacity) {
+                // 如果请求的内存大于当前内存的一半，那么也复用
+                return;
+            }
+        } while (false);
+        PacketPool::deallocate(_data);
+        _data = nullptr;
+        _capacity = 0;
+    }
+    _data = (char *)PacketPool::allocate(capacity);
+    _capacity = capacity;
+}
+
+void PooledBuffer::setSize(size_t size) {
+    if (size > _capacity) {
+        throw std::invalid_argument("PooledBuffer::setSize out of range");
+    }
+    _size = size;
+}
+
+void PooledBuffer::assign(const char *data, size_t size) {
+    if (size <= 0) {
+        size = strlen(data);
+    }
+    setCapacity(size + 1);
+    memcpy(_data, data, size);
+    _data[size] = '\0';
+    setSize(size);
+}
+
+} // namespace mediakit
@@ -0,0 +1,128 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_PACKETPOOL_H
+#define ZLMEDIAKIT_PACKETPOOL_H
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "Network/Buffer.h"
+
+namespace mediakit {
+
+/**
+ * 按大小分级的线程缓存内存池，用于rtp/rtmp包、帧等高频创建销毁的对象及其负载
+ * 每个线程为每个规格缓存一定数量的空闲块，分配与本线程释放都不加锁；
+ * 其他线程释放的块通过无锁链表归还给分配它的线程，由该线程下次分配时回收；
+ * 线程退出时释放其缓存的空闲块，之后归还给该线程的块直接释放
+ * 编译时未定义ENABLE_PACKET_POOL(默认关闭)则直接使用malloc/free
+ */
+class PacketPool {
+public:
+    // 最小规格64字节，最大规格64KB，超过最大规格的直接使用malloc
+    static constexpr size_t kMinShift = 6;
+    static constexpr size_t kMaxShift = 16;
+    static constexpr size_t kClassCount = kMaxShift - kMinShift + 1;
+    // 每个线程每个规格最多缓存的字节数
+    static constexpr size_t kMaxCacheBytes = 2 * 1024 * 1024;
+
+    static void *allocate(size_t size);
+    static void deallocate(void *ptr);
+
+    /**
+     * 从线程缓存中分配成功的次数
+     */
+    static uint64_t getHitCount();
+
+    /**
+     * 线程缓存为空，从系统分配的次数
+     */
+    static uint64_t getMissCount();
+
+    /**
+     * 其他线程释放并归还的次数
+     */
+    static uint64_t getRemoteFreeCount();
+
+    /**
+     * 所有线程缓存中空闲块的总字节数(不含其他线程归还但尚未回收的块)
+     */
+    static uint64_t getCacheBytes();
+};
+
+/**
+ * 对象继承该类后，new/delete以及shared_ptr控制块都从PacketPool分配
+ */
+class PacketPoolObject {
+public:
+    static void *operator new(size_t size) { return PacketPool::allocate(size); }
+    static void operator delete(void *ptr) { PacketPool::deallocate(ptr); }
+};
+
+/**
+ * 供std::shared_ptr分配控制块使用的分配器
+ */
+template <typename T>
+class PacketPoolAllocator {
+public:
+    using value_type = T;
+
+    PacketPoolAllocator() = default;
+    template <typename U>
+    PacketPoolAllocator(const PacketPoolAllocator<U> &) {}
+
+    T *allocate(size_t n) { return (T *)PacketPool::allocate(n * sizeof(T)); }
+    void deallocate(T *ptr, size_t) { PacketPool::deallocate(ptr); }
+
+    template <typename U>
+    bool operator==(const PacketPoolAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const PacketPoolAllocator<U> &) const { return false; }
+};
+
+/**
+ * 创建对象，对象本身与shared_ptr控制块都从PacketPool分配
+ * T需要继承PacketPoolObject
+ */
+template <typename T>
+std::shared_ptr<T> makePooledShared(T *ptr) {
+    return std::shared_ptr<T>(ptr, std::default_delete<T>(), PacketPoolAllocator<T>());
+}
+
+/**
+ * 负载内存从PacketPool分配的Buffer，接口与toolkit::BufferRaw一致
+ */
+class PooledBuffer : public toolkit::Buffer, public PacketPoolObject {
+public:
+    using Ptr = std::shared_ptr<PooledBuffer>;
+
+    static Ptr create(size_t capacity = 0);
+    ~PooledBuffer() override;
+
+    char *data() const override { return _data; }
+    size_t size() const override { return _size; }
+    size_t getCapacity() const override { return _capacity; }
+
+    void setCapacity(size_t capacity);
+    virtual void setSize(size_t size);
+    void assign(const char *data, size_t size = 0);
+
+protected:
+    PooledBuffer() = default;
+
+private:
+    size_t _size = 0;
+    size_t _capacity = 0;
+    char *_data = nullptr;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_PACKETPOOL_H
@@ -46,49 +46,38 @@ string findSubString(const char *buf, const char *start, const char *end, size_t
 
 void Parser::parse(const char *buf, size_t size) {
     clear();
-    auto ptr = buf;
-    while (true) {
-        auto next_line = strchr(ptr, '\n');
-        auto offset = 1;
-        CHECK(next_line && next_line > ptr);
-        if (*(next_line - 1) == '\r') {
-            next_line -= 1;
-            offset = 2;
-        }
-        if (ptr == buf) {
-            auto blank = strchr(ptr, ' ');
-            CHECK(blank > ptr && blank < next_line);
-           _method = std::string(ptr, blank - ptr);
-            auto next_blank = strchr(blank + 1, ' ');
-            CHECK(next_blank && next_blank < next_line);
-            _url.assign(blank + 1, next_blank);
-            auto pos = _url.find('?');
-            if (pos != string::npos) {
-                _params = _url.substr(pos + 1);
-                _url_args = parseArgs(_params);
-                _url = _url.substr(0, pos);
-            }
-            _protocol = std::string(next_blank + 1, next_line);
-        } else {
-            auto pos = strchr(ptr, ':');
-            CHECK(pos > ptr && pos < next_line);
-            std::string key { ptr, static_cast<std::size_t>(pos - ptr) };
-            std::string value;
-            if (pos[1] == ' ') {
-                value.assign(pos + 2, next_line);
-            } else {
-                value.assign(pos + 1, next_line);
-            }
-            _headers.emplace_force(trim(std::move(key)), trim(std::move(value)));
-        }
-        ptr = next_line + offset;
-        if (strncmp(ptr, "\r\n", 2) == 0) { // 协议解析完毕
-            _content.assign(ptr + 2, buf + size);
-            break;
-        }
+    auto &view = _raw.view;
+    view.parse(buf, size);
+    // 只保存头部，content单独保存
+    auto content = view.content();
+    _raw.data.assign(buf, content.data() - buf);
+    view.setBase(_raw.data.data());
+    _content.assign(content.data(), content.size());
+
+    auto method = view.method();
+    auto url = view.url();
+    auto params = view.params();
+    auto protocol = view.protocol();
+    _method.assign(method.data(), method.size());
+    _url.assign(url.data(), url.size());
+    _params.assign(params.data(), params.size());
+    _protocol.assign(protocol.data(), protocol.size());
+
+    // 在parse时生成header值与url参数，保证const接口可以被多线程同时调用
+    _values.reserve(view.headerCount());
+    for (size_t i = 0; i < view.headerCount(); ++i) {
+        auto value = view.headerValue(i);
+        _values.emplace_back(value.data(), value.size());
+    }
+    if (!_params.empty()) {
+        _url_args = parseArgs(_params);
     }
 }
 
+const ParserView &Parser::view() const {
+    return _raw.view;
+}
+
 const string &Parser::method() const {
     return _method;
 }
@@ -119,11 +108,20 @@ const std::string &Parser::statusStr() const {
 static std::string kNull;
 
 const string &Parser::operator[](const char *name) const {
-    auto it = _headers.find(name);
-    if (it == _headers.end()) {
+    if (_headers_ready) {
+        // header已经生成，可能被外部修改过
+        auto it = _headers.find(name);
+        if (it == _headers.end()) {
+            return kNull;
+        }
+        return it->second;
+    }
+    auto &parser = view();
+    auto index = parser.findHeader(name);
+    if (index < 0) {
         return kNull;
     }
-    return it->second;
+    return _values[index];
 }
 
 const string &Parser::content() const {
@@ -131,6 +129,10 @@ const string &Parser::content() const {
 }
 
 void Parser::clear() {
+    _raw.data.clear();
+    _raw.view.clear();
+    _values.clear();
+    _headers_ready = false;
     _method.clear();
     _url.clear();
     _params.clear();
@@ -153,6 +155,13 @@ void Parser::setContent(string content) {
 }
 
 StrCaseMap &Parser::getHeader() const {
+    if (!_headers_ready) {
+        _headers_ready = true;
+        auto &parser = view();
+        for (size_t i = 0; i < parser.headerCount(); ++i) {
+            _headers.emplace_force(parser.headerKey(i).str(), parser.headerValue(i).str());
+        }
+    }
     return _headers;
 }
 
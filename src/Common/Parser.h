@@ -13,7 +13,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "Util/util.h"
+#include "ParserView.h"
 
 namespace mediakit {
 
@@ -55,7 +57,8 @@ public:
     }
 };
 
-// rtsp/http/sip解析类
+// rtsp/http/sip解析类，基于ParserView实现
+// 只拷贝一次原始头部数据，header map在首次调用getHeader时才生成
 class Parser {
 public:
     // 解析http/rtsp/sip请求，需要确保buf以\0结尾
@@ -95,7 +98,7 @@ public:
     // 重新设置content
     void setContent(std::string content);
 
-    // 获取header列表
+    // 获取header列表，首次调用时生成，与修改header一样不能多线程同时调用
     StrCaseMap &getHeader() const;
 
     // 获取url参数列表
@@ -106,12 +109,43 @@ public:
 
     static std::string mergeUrl(const std::string &base_url, const std::string &path);
 
+    // 获取不拷贝数据的解析结果
+    const ParserView &view() const;
+
+private:
+    // 原始头部数据及其解析结果，拷贝或移动后切片重新指向自身的数据
+    struct RawHeader {
+        std::string data;
+        ParserView view;
+
+        RawHeader() = default;
+        RawHeader(const RawHeader &that) : data(that.data), view(that.view) { view.setBase(data.data()); }
+        RawHeader(RawHeader &&that) : data(std::move(that.data)), view(std::move(that.view)) { view.setBase(data.data()); }
+        RawHeader &operator=(const RawHeader &that) {
+            data = that.data;
+            view = that.view;
+            view.setBase(data.data());
+            return *this;
+        }
+        RawHeader &operator=(RawHeader &&that) {
+            data = std::move(that.data);
+            view = std::move(that.view);
+            view.setBase(data.data());
+            return *this;
+        }
+    };
+
 private:
+    RawHeader _raw;
     std::string _method;
     std::string _url;
     std::string _protocol;
     std::string _content;
     std::string _params;
+    // header值，下标与ParserView中的header一致，在parse时生成，const接口不修改内部状态
+    std::vector<std::string> _values;
+    // getHeader返回可修改的map，首次调用时才生成
+    mutable bool _headers_ready = false;
     mutable StrCaseMap _headers;
     mutable StrCaseMap _url_args;
 };
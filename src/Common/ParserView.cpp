@@ -0,0 +1,151 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "ParserView.h"
+#include "Common/macros.h"
+#include "Util/util.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENABLE_PARSER_SSE2
+#endif
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+bool StrView::equalsIgnoreCase(const char *str, size_t size) const {
+    return size == _size && !strncasecmp(_data, str, size);
+}
+
+static inline bool isTrimChar(char ch) {
+    return ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t';
+}
+
+ParserView::Slice ParserView::slice(const char *start, const char *end) const {
+    // 与toolkit::trim保持一致，去除首尾空白
+    while (start < end && isTrimChar(*start)) {
+        ++start;
+    }
+    while (end > start && isTrimChar(end[-1])) {
+        --end;
+    }
+    Slice ret;
+    ret.offset = (uint32_t)(start - _base);
+    ret.size = (uint32_t)(end - start);
+    return ret;
+}
+
+void ParserView::addHeader(const Slice &key, const Slice &value) {
+    if (_header_count < kInlineHeaders) {
+        _headers[_header_count].key = key;
+        _headers[_header_count].value = value;
+    } else {
+        Header header;
+        header.key = key;
+        header.value = value;
+        _more_headers.emplace_back(header);
+    }
+    ++_header_count;
+}
+
+void ParserView::clear() {
+    _method = _url = _params = _protocol = _content = Slice();
+    _header_count = 0;
+    _more_headers.clear();
+}
+
+const char *ParserView::findLineEnd(const char *ptr, const char *end) {
+#if defined(ENABLE_PARSER_SSE2)
+    auto lf = _mm_set1_epi8('\n');
+    while (ptr + 16 <= end) {
+        auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)ptr), lf));
+        if (mask) {
+            int index = 0;
+            while (!(mask & (1 << index))) {
+                ++index;
+            }
+            return ptr + index;
+        }
+        ptr += 16;
+    }
+#endif
+    return ptr < end ? (const char *)memchr(ptr, '\n', end - ptr) : nullptr;
+}
+
+const char *ParserView::findHeaderTail(const char *ptr, size_t size) {
+    auto start = ptr;
+    auto end = ptr + size;
+    while ((ptr = findLineEnd(ptr, end))) {
+        if (ptr - start >= 3 && !memcmp(ptr - 3, "\r\n\r\n", 4)) {
+            return ptr + 1;
+        }
+        ++ptr;
+    }
+    return nullptr;
+}
+
+int ParserView::findHeader(const char *name) const {
+    auto size = strlen(name);
+    for (size_t i = 0; i < _header_count; ++i) {
+        if (headerKey(i).equalsIgnoreCase(name, size)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void ParserView::parse(const char *buf, size_t size) {
+    clear();
+    _base = buf;
+    auto end = buf + size;
+    auto ptr = buf;
+    while (true) {
+        auto next_line = findLineEnd(ptr, end);
+        auto offset = 1;
+        CHECK(next_line && next_line > ptr);
+        if (*(next_line - 1) == '\r') {
+            next_line -= 1;
+            offset = 2;
+        }
+        if (ptr == buf) {
+            auto blank = (const char *)memchr(ptr, ' ', next_line - ptr);
+            CHECK(blank && blank > ptr);
+            _method = slice(ptr, blank);
+            auto next_blank = (const char *)memchr(blank + 1, ' ', next_line - blank - 1);
+            CHECK(next_blank);
+            auto url_end = next_blank;
+            auto pos = (const char *)memchr(blank + 1, '?', next_blank - blank - 1);
+            if (pos) {
+                _params.offset = (uint32_t)(pos + 1 - buf);
+                _params.size = (uint32_t)(next_blank - pos - 1);
+                url_end = pos;
+            }
+            _url.offset = (uint32_t)(blank + 1 - buf);
+            _url.size = (uint32_t)(url_end - blank - 1);
+            _protocol.offset = (uint32_t)(next_blank + 1 - buf);
+            _protocol.size = (uint32_t)(next_line - next_blank - 1);
+        } else {
+            auto pos = (const char *)memchr(ptr, ':', next_line - ptr);
+            CHECK(pos && pos > ptr);
+            addHeader(slice(ptr, pos), slice(pos + 1, next_line));
+        }
+        ptr = next_line + offset;
+        if (end - ptr >= 2 && ptr[0] == '\r' && ptr[1] == '\n') {
+            // 协议解析完毕
+            _content.offset = (uint32_t)(ptr + 2 - buf);
+            _content.size = (uint32_t)(end - ptr - 2);
+            break;
+        }
+    }
+}
+
+} // namespace mediakit
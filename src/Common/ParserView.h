@@ -0,0 +1,131 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_PARSERVIEW_H
+#define ZLMEDIAKIT_PARSERVIEW_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+namespace mediakit {
+
+/**
+ * 只读字符串切片，不持有内存
+ */
+class StrView {
+public:
+    StrView() = default;
+    StrView(const char *data, size_t size) : _data(data), _size(size) {}
+
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+    bool empty() const { return !_size; }
+    std::string str() const { return std::string(_data, _size); }
+
+    bool operator==(const char *str) const { return strlen(str) == _size && !memcmp(_data, str, _size); }
+    bool operator!=(const char *str) const { return !operator==(str); }
+
+    // 忽略大小写比较
+    bool equalsIgnoreCase(const char *str, size_t size) const;
+
+private:
+    const char *_data = nullptr;
+    size_t _size = 0;
+};
+
+/**
+ * 不拷贝数据的rtsp/http/sip请求、回复头解析器
+ * 解析结果都是指向原始数据的切片(偏移量+长度)，原始数据需要在使用期间保持有效；
+ * 只记录偏移量，所以原始数据被整体拷贝或移动后，通过setBase指向新的地址即可继续使用
+ */
+class ParserView {
+public:
+    // 小于该个数的header不需要额外分配内存
+    static constexpr size_t kInlineHeaders = 32;
+
+    class Slice {
+    public:
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    class Header {
+    public:
+        Slice key;
+        Slice value;
+    };
+
+    /**
+     * 解析请求或回复头，格式错误时抛AssertFailedException
+     * @param buf 数据，可以不以\0结尾
+     * @param size 数据长度，头部之后的数据作为content
+     */
+    void parse(const char *buf, size_t size);
+
+    /**
+     * 清空解析结果
+     */
+    void clear();
+
+    /**
+     * 原始数据被拷贝或移动后，指向新的地址
+     */
+    void setBase(const char *buf) { _base = buf; }
+
+    // 请求时为命令字/url(不含?后的参数)/协议，回复时为协议/状态码/状态字符串
+    StrView method() const { return view(_method); }
+    StrView url() const { return view(_url); }
+    StrView params() const { return view(_params); }
+    StrView protocol() const { return view(_protocol); }
+    StrView content() const { return view(_content); }
+
+    size_t headerCount() const { return _header_count; }
+    StrView headerKey(size_t index) const { return view(getHeader(index).key); }
+    StrView headerValue(size_t index) const { return view(getHeader(index).value); }
+
+    /**
+     * 忽略大小写查找header，返回第一个匹配项的下标，未找到返回-1
+     */
+    int findHeader(const char *name) const;
+
+    /**
+     * 查找下一个\n，支持sse2时每次比较16个字节
+     * @return 未找到返回nullptr
+     */
+    static const char *findLineEnd(const char *ptr, const char *end);
+
+    /**
+     * 查找\r\n\r\n结尾的头部
+     * @return 头部之后的指针，未找到返回nullptr
+     */
+    static const char *findHeaderTail(const char *ptr, size_t size);
+
+private:
+    StrView view(const Slice &slice) const { return StrView(_base + slice.offset, slice.size); }
+    Slice slice(const char *start, const char *end) const;
+    const Header &getHeader(size_t index) const { return index < kInlineHeaders ? _headers[index] : _more_headers[index - kInlineHeaders]; }
+    void addHeader(const Slice &key, const Slice &value);
+
+private:
+    const char *_base = nullptr;
+    Slice _method;
+    Slice _url;
+    Slice _params;
+    Slice _protocol;
+    Slice _content;
+    size_t _header_count = 0;
+    Header _headers[kInlineHeaders];
+    std::vector<Header> _more_headers;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_PARSERVIEW_H
@@ -0,0 +1,59 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_THREADSHARD_H
+#define ZLMEDIAKIT_THREADSHARD_H
+
+#include <mutex>
+#include <vector>
+#include <functional>
+
+namespace mediakit {
+
+/**
+ * 线程分片列表，每个线程只写入自己的分片，读取时遍历所有分片合并
+ * 热路径上只有首次访问需要加锁，之后没有跨线程的缓存行竞争
+ * 线程退出后分片仍然保留，保证统计数据不丢失，线程数量有限，内存占用可以忽略
+ */
+template <typename shard_type>
+class ThreadShardList {
+public:
+    static ThreadShardList &Instance() {
+        static auto instance = new ThreadShardList;
+        return *instance;
+    }
+
+    shard_type &getThreadShard() {
+        static thread_local shard_type *shard = nullptr;
+        if (!shard) {
+            shard = new shard_type;
+            std::lock_guard<std::mutex> lck(_mtx);
+            _shards.emplace_back(shard);
+        }
+        return *shard;
+    }
+
+    void for_each(const std::function<void(const shard_type &)> &cb) {
+        std::lock_guard<std::mutex> lck(_mtx);
+        for (auto shard : _shards) {
+            cb(*shard);
+        }
+    }
+
+private:
+    ThreadShardList() = default;
+
+private:
+    std::mutex _mtx;
+    std::vector<shard_type *> _shards;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_THREADSHARD_H
@@ -0,0 +1,245 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "TimerWheel.h"
+#include "ThreadShard.h"
+#include "Util/util.h"
+#include "Util/logger.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+// 每个线程时间轮的统计分片，只有本线程写入
+class TimerWheelShard {
+public:
+    std::atomic<uint64_t> timers { 0 };
+    std::atomic<uint64_t> ticks { 0 };
+    std::atomic<uint64_t> cost_us { 0 };
+    std::atomic<uint64_t> max_cost_us { 0 };
+};
+
+using TimerWheelShardList = ThreadShardList<TimerWheelShard>;
+
+template <typename FUNC>
+static uint64_t sumShard(FUNC &&func) {
+    uint64_t ret = 0;
+    TimerWheelShardList::Instance().for_each([&](const TimerWheelShard &shard) { ret += func(shard); });
+    return ret;
+}
+
+uint64_t TimerWheel::getTimerCount() {
+    return sumShard([](const TimerWheelShard &shard) { return shard.timers.load(memory_order_relaxed); });
+}
+
+uint64_t TimerWheel::getTickCount() {
+    return sumShard([](const TimerWheelShard &shard) { return shard.ticks.load(memory_order_relaxed); });
+}
+
+uint64_t TimerWheel::getTickCostUS() {
+    return sumShard([](const TimerWheelShard &shard) { return shard.cost_us.load(memory_order_relaxed); });
+}
+
+uint64_t TimerWheel::getMaxTickCostUS() {
+    uint64_t ret = 0;
+    TimerWheelShardList::Instance().for_each([&](const TimerWheelShard &shard) { ret = MAX(ret, shard.max_cost_us.load(memory_order_relaxed)); });
+    return ret;
+}
+
+void TimerWheel::Task::cancel() {
+    if (_canceled.exchange(true)) {
+        return;
+    }
+    // 在poller线程调用时EventPoller::async会同步执行，立即从时间轮中移除；
+    // 在其他线程调用时切换到poller线程异步移除，移除前到期也不会再执行回调
+    auto self = shared_from_this();
+    _poller->async([self]() { TimerWheel::Instance().removeTask(self); });
+}
+
+TimerWheel &TimerWheel::Instance() {
+    static thread_local TimerWheel s_instance;
+    return s_instance;
+}
+
+TimerWheel::Task::Ptr TimerWheel::doDelayTask(const EventPoller::Ptr &poller, uint64_t delay_ms, function<uint64_t()> cb) {
+    auto task = std::make_shared<Task>();
+    task->_cb = std::move(cb);
+    task->_poller = poller;
+    poller->async([task, delay_ms]() {
+        if (!task->_canceled) {
+            TimerWheel::Instance().addTask(task, delay_ms);
+        }
+    });
+    return task;
+}
+
+void TimerWheel::addTask(const Task::Ptr &task, uint64_t delay_ms) {
+    auto now = getCurrentMillisecond();
+    if (!_count && !_ticking) {
+        // 时间轮为空，跳过空闲期间的所有槽
+        _cur = now;
+    }
+    task->_expire = now + delay_ms;
+    placeTask(task);
+    TimerWheelShardList::Instance().getThreadShard().timers.store(_count, memory_order_relaxed);
+    startTicker(task->_expire);
+}
+
+void TimerWheel::removeTask(const Task::Ptr &task) {
+    if (!task->_owner) {
+        return;
+    }
+    if (task->_owner >= _fine && task->_owner < _fine + kFineSlots) {
+        --_fine_count;
+    }
+    task->_owner->erase(task->_it);
+    task->_owner = nullptr;
+    --_count;
+}
+
+void TimerWheel::placeTask(const Task::Ptr &task) {
+    // 已经处理过的时间不能再插入
+    task->_expire = MAX(task->_expire, _cur);
+    std::list<Task::Ptr> *owner;
+    if (task->_expire - _cur < kFineSlots) {
+        owner = &_fine[task->_expire % kFineSlots];
+        ++_fine_count;
+    } else {
+        // 最后一次降级到第一层的槽，以及还需要转多少圈
+        auto last = (_cur - 1) / kFineSlots;
+        auto bucket = task->_expire / kFineSlots;
+        task->_rounds = (bucket - last - 1) / kCoarseSlots;
+        owner = &_coarse[bucket % kCoarseSlots];
+    }
+    task->_owner = owner;
+    task->_it = owner->emplace(owner->end(), task);
+    ++_count;
+}
+
+void TimerWheel::startTicker(uint64_t expire) {
+    if (_ticking || (_ticker && _wakeup <= expire)) {
+        // 驱动中或者会及时唤醒
+        return;
+    }
+    if (_ticker) {
+        _ticker->cancel();
+    }
+    auto now = getCurrentMillisecond();
+    _wakeup = expire;
+    _ticker = EventPoller::getCurrentPoller()->doDelayTask(expire > now ? expire - now : 0, []() { return TimerWheel::Instance().onTick(); });
+}
+
+uint64_t TimerWheel::onTick() {
+    auto now = getCurrentMillisecond();
+    auto begin = getCurrentMicrosecond();
+    _ticking = true;
+    while (_cur <= now) {
+        auto tick = _cur++;
+        if (tick % kFineSlots == 0) {
+            // 第二层的槽降级到第一层
+            auto &slot = _coarse[(tick / kFineSlots) % kCoarseSlots];
+            for (auto it = slot.begin(); it != slot.end();) {
+                auto &task = *it;
+                if (task->_rounds) {
+                    --task->_rounds;
+                    ++it;
+                    continue;
+                }
+                auto &fine = _fine[task->_expire % kFineSlots];
+                task->_owner = &fine;
+                task->_it = it++;
+                fine.splice(fine.end(), slot, task->_it);
+                ++_fine_count;
+            }
+        }
+        // 先把到期的任务整体移出时间轮再执行，回调中可能取消其他任务或添加新任务，
+        // 重新添加的任务可能落在本槽(延时正好一圈)，必须等到下一圈再执行，否则会死循环
+        std::list<Task::Ptr> expired;
+        expired.swap(_fine[tick % kFineSlots]);
+        for (auto &task : expired) {
+            task->_owner = nullptr;
+        }
+        _fine_count -= expired.size();
+        _count -= expired.size();
+        for (auto &task : expired) {
+            if (task->_canceled) {
+                continue;
+            }
+            uint64_t next = 0;
+            try {
+                next = task->_cb();
+            } catch (std::exception &ex) {
+                ErrorL << "Exception occurred when do delay task: " << ex.what();
+            }
+            if (next && !task->_canceled) {
+                task->_expire = now + next;
+                placeTask(task);
+            }
+        }
+    }
+    _ticking = false;
+
+    auto cost = getCurrentMicrosecond() - begin;
+    auto &shard = TimerWheelShardList::Instance().getThreadShard();
+    shard.timers.store(_count, memory_order_relaxed);
+    shard.ticks.store(shard.ticks.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    shard.cost_us.store(shard.cost_us.load(memory_order_relaxed) + cost, memory_order_relaxed);
+    if (cost > shard.max_cost_us.load(memory_order_relaxed)) {
+        shard.max_cost_us.store(cost, memory_order_relaxed);
+    }
+
+    if (!_count) {
+        // 没有定时任务了，停止驱动
+        _ticker = nullptr;
+        return 0;
+    }
+    _wakeup = nextWakeup();
+    return MAX(_wakeup - now, (uint64_t)1);
+}
+
+uint64_t TimerWheel::nextWakeup() const {
+    // 下一次第二层槽降级的时间
+    auto boundary = (_cur + kFineSlots - 1) / kFineSlots * kFineSlots;
+    auto ret = boundary + kFineSlots * kCoarseSlots;
+    for (auto t = boundary; t < ret; t += kFineSlots) {
+        if (!_coarse[(t / kFineSlots) % kCoarseSlots].empty()) {
+            ret = t;
+            break;
+        }
+    }
+    if (_fine_count) {
+        // 第一层的任务都在一圈以内
+        for (auto t = _cur; t < ret && t < _cur + kFineSlots; ++t) {
+            if (!_fine[t % kFineSlots].empty()) {
+                return t;
+            }
+        }
+    }
+    return ret;
+}
+
+WheelTimer::WheelTimer(float second, const function<bool()> &cb, const EventPoller::Ptr &poller) {
+    auto interval = MAX((uint64_t)(second * 1000), (uint64_t)1);
+    _task = TimerWheel::doDelayTask(poller ? poller : EventPollerPool::Instance().getPoller(), interval, [cb, interval]() -> uint64_t {
+        try {
+            return cb() ? interval : 0;
+        } catch (std::exception &ex) {
+            ErrorL << "Exception occurred when do timer task: " << ex.what();
+            return interval;
+        }
+    });
+}
+
+WheelTimer::~WheelTimer() {
+    _task->cancel();
+}
+
+} // namespace mediakit
@@ -0,0 +1,126 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_TIMERWHEEL_H
+#define ZLMEDIAKIT_TIMERWHEEL_H
+
+#include <list>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include "Poller/EventPoller.h"
+
+namespace mediakit {
+
+/**
+ * 分层时间轮，每个poller线程一个
+ * 第一层100个槽，精度1毫秒；第二层600个槽，精度100毫秒，超过60秒的定时任务记录圈数
+ * 插入与取消都是O(1)，同一个poller上所有定时任务共用一个poller延时任务驱动，到期任务批量处理
+ * 用于替代会话级别的大量toolkit::Timer与EventPoller::doDelayTask，减少定时器堆的条目与唤醒次数
+ */
+class TimerWheel {
+public:
+    // 第一层槽数与精度(毫秒)
+    static constexpr uint64_t kFineSlots = 100;
+    // 第二层槽数，精度为kFineSlots毫秒
+    static constexpr uint64_t kCoarseSlots = 600;
+
+    class Task : public std::enable_shared_from_this<Task> {
+    public:
+        using Ptr = std::shared_ptr<Task>;
+
+        /**
+         * 取消任务，可以在任意线程调用
+         */
+        void cancel();
+
+    private:
+        friend class TimerWheel;
+        std::atomic<bool> _canceled { false };
+        uint64_t _expire = 0;
+        uint64_t _rounds = 0;
+        std::function<uint64_t()> _cb;
+        std::list<Ptr> *_owner = nullptr;
+        std::list<Ptr>::iterator _it;
+        toolkit::EventPoller::Ptr _poller;
+    };
+
+    /**
+     * 在poller线程的时间轮上添加延时任务，用法与EventPoller::doDelayTask一致
+     * @param poller 执行任务的poller，可以在其他线程调用
+     * @param delay_ms 延时毫秒数
+     * @param cb 任务回调，返回下次执行的延时毫秒数，返回0时停止
+     * @return 可取消的任务
+     */
+    static Task::Ptr doDelayTask(const toolkit::EventPoller::Ptr &poller, uint64_t delay_ms, std::function<uint64_t()> cb);
+
+    /**
+     * 所有线程时间轮上的定时任务总数
+     */
+    static uint64_t getTimerCount();
+
+    /**
+     * 所有线程时间轮的驱动次数
+     */
+    static uint64_t getTickCount();
+
+    /**
+     * 所有线程时间轮驱动累计耗时与单次最大耗时，单位微秒
+     */
+    static uint64_t getTickCostUS();
+    static uint64_t getMaxTickCostUS();
+
+private:
+    TimerWheel() = default;
+    // 本线程的时间轮，只能在poller线程调用
+    static TimerWheel &Instance();
+
+    void addTask(const Task::Ptr &task, uint64_t delay_ms);
+    void removeTask(const Task::Ptr &task);
+    void placeTask(const Task::Ptr &task);
+    void startTicker(uint64_t expire);
+    uint64_t onTick();
+    uint64_t nextWakeup() const;
+
+private:
+    // 下一个未处理的毫秒时间戳
+    uint64_t _cur = 0;
+    // 驱动延时任务的下次唤醒时间
+    uint64_t _wakeup = 0;
+    bool _ticking = false;
+    size_t _fine_count = 0;
+    size_t _count = 0;
+    toolkit::EventPoller::DelayTask::Ptr _ticker;
+    std::list<Task::Ptr> _fine[kFineSlots];
+    std::list<Task::Ptr> _coarse[kCoarseSlots];
+};
+
+/**
+ * 基于时间轮的定时器，用法与toolkit::Timer一致，析构时取消
+ */
+class WheelTimer {
+public:
+    using Ptr = std::shared_ptr<WheelTimer>;
+
+    /**
+     * @param second 定时器间隔，单位秒
+     * @param cb 定时器回调，返回true表示重复执行，否则只执行一次
+     * @param poller 执行回调的poller，为空时从EventPollerPool中选取
+     */
+    WheelTimer(float second, const std::function<bool()> &cb, const toolkit::EventPoller::Ptr &poller);
+    ~WheelTimer();
+
+private:
+    TimerWheel::Task::Ptr _task;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_TIMERWHEEL_H
@@ -0,0 +1,204 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "UdpBatchReceiver.h"
+#include "Common/config.h"
+#include "Common/Metrics.h"
+#include <cstring>
+#include "Util/logger.h"
+#include "Util/uv_errno.h"
+#include "Network/sockutil.h"
+#include "Poller/EventPoller.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+static atomic<uint64_t> s_total_packets { 0 };
+static atomic<uint64_t> s_total_wakeups { 0 };
+
+size_t UdpBatchReceiver::getBatchSize() {
+#if defined(__linux__)
+    GET_CONFIG(int, batch, General::kUdpBatchRecv);
+    // 每次只读1个包时与普通接收无异
+    return batch > 1 ? MIN((size_t)batch, kMaxBatch) : 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t UdpBatchReceiver::getTotalPackets() {
+    return s_total_packets.load(memory_order_relaxed);
+}
+
+uint64_t UdpBatchReceiver::getTotalWakeups() {
+    return s_total_wakeups.load(memory_order_relaxed);
+}
+
+UdpBatchReceiver::UdpBatchReceiver(size_t batch_size) {
+    _batch_size = MAX(MIN(batch_size, kMaxBatch), (size_t)1);
+    _buffers.resize(_batch_size);
+    _packets.resize(_batch_size);
+    _addrs.resize(_batch_size);
+#if defined(__linux__)
+    _iov.resize(_batch_size);
+    _msgs.resize(_batch_size);
+#endif
+}
+
+UdpBatchReceiver::~UdpBatchReceiver() {
+    if (_sock) {
+        // 移除本对象的事件监听，socket析构时关闭fd
+        _sock->getPoller()->delEvent(_sock->rawFD());
+    }
+}
+
+void UdpBatchReceiver::setOnRead(onReadCB cb) {
+    _on_read = std::move(cb);
+}
+
+void UdpBatchReceiver::setOnErr(onErrCB cb) {
+    _on_err = std::move(cb);
+}
+
+bool UdpBatchReceiver::attach(const Socket::Ptr &sock) {
+#if defined(__linux__)
+    auto fd = sock->rawFD();
+    if (fd == -1) {
+        return false;
+    }
+    auto poller = sock->getPoller();
+    weak_ptr<UdpBatchReceiver> weak_self = shared_from_this();
+    // 同一个poller内顺序执行，先移除Socket自身的读事件再由本对象监听
+    poller->delEvent(fd);
+    auto ret = poller->addEvent(fd, EventPoller::Event_Read | EventPoller::Event_Error, [weak_self](int event) {
+        if (auto strong_self = weak_self.lock()) {
+            strong_self->onEvent(event);
+        }
+    });
+    if (ret == -1) {
+        WarnL << "Attach udp batch receiver failed: " << get_uv_errmsg(true);
+        return false;
+    }
+    _sock = sock;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UdpBatchReceiver::onEvent(int event) {
+    if (event & EventPoller::Event_Read) {
+        onRead();
+    }
+    if ((event & EventPoller::Event_Error) && _sock) {
+        auto err = SockUtil::getSockError(_sock->rawFD());
+        onError(SockException(Err_other, uv_strerror(uv_translate_posix_error(err)), err));
+    }
+}
+
+void UdpBatchReceiver::onError(const SockException &err) {
+    // 与Socket的错误处理一致：移除事件监听并关闭socket，之后不再接收数据
+    auto sock = std::move(_sock);
+    sock->getPoller()->delEvent(sock->rawFD());
+    sock->closeSock();
+    if (_on_err) {
+        // 回调中可能重置回调
+        auto cb = _on_err;
+        cb(err);
+    }
+}
+
+void UdpBatchReceiver::onRead() {
+    if (!_sock) {
+        return;
+    }
+    auto fd = _sock->rawFD();
+    s_total_wakeups.fetch_add(1, memory_order_relaxed);
+    // 边沿触发，必须读到EAGAIN为止
+    while (true) {
+        size_t count = 0;
+        auto read = recvPackets(fd, count);
+        if (count) {
+            s_total_packets.fetch_add(count, memory_order_relaxed);
+            if (_on_read) {
+                _on_read(_packets.data(), _addrs.data(), count);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                // 回调未持有的缓存下次复用
+                _packets[i] = nullptr;
+            }
+        }
+        if (read < _batch_size) {
+            // 内核接收队列已读空
+            break;
+        }
+    }
+}
+
+size_t UdpBatchReceiver::recvPackets(int fd, size_t &count) {
+#if defined(__linux__)
+    for (size_t i = 0; i < _batch_size; ++i) {
+        auto &buf = _buffers[i];
+        if (!buf || buf.use_count() > 1) {
+            // 缓存仍被外部持有，重新分配
+            buf = BufferRaw::create();
+            buf->setCapacity(kBufferSize + 1);
+        }
+        _iov[i].iov_base = buf->data();
+        _iov[i].iov_len = kBufferSize;
+        auto &msg = _msgs[i].msg_hdr;
+        memset(&_msgs[i], 0, sizeof(_msgs[i]));
+        msg.msg_name = &_addrs[i];
+        msg.msg_namelen = sizeof(struct sockaddr_storage);
+        msg.msg_iov = &_iov[i];
+        msg.msg_iovlen = 1;
+    }
+
+    int ret;
+    do {
+        ret = recvmmsg(fd, _msgs.data(), _batch_size, MSG_DONTWAIT, nullptr);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == -1) {
+        auto err = get_uv_error(true);
+        if (err != UV_EAGAIN) {
+            // 与Socket一致，udp接收错误(例如对端端口不可达)不关闭socket
+            WarnL << "Recv err on udp socket[" << fd << "]: " << uv_strerror(err);
+        }
+    }
+    if (ret <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < ret; ++i) {
+        if (_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            Metrics::add(Metrics::kDropUdpTruncated);
+            WarnL << "Udp packet truncated, dropped, size limit: " << kBufferSize;
+            continue;
+        }
+        if (count != (size_t)i) {
+            // 跳过被丢弃的包，保持缓存、地址与包一一对应
+            std::swap(_buffers[count], _buffers[i]);
+            _addrs[count] = _addrs[i];
+        }
+        auto &buf = _buffers[count];
+        auto size = _msgs[i].msg_len;
+        buf->data()[size] = '\0';
+        buf->setSize(size);
+        _packets[count++] = buf;
+    }
+    return ret;
+#else
+    return 0;
+#endif
+}
+
+} // namespace mediakit
@@ -0,0 +1,102 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_UDPBATCHRECEIVER_H
+#define ZLMEDIAKIT_UDPBATCHRECEIVER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "Network/Socket.h"
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+namespace mediakit {
+
+/**
+ * udp批量接收器，每次可读事件通过recvmmsg一次性读取多个udp包
+ * 接收缓存为预分配的环形数组，回调返回后若缓存未被外部持有则复用，避免每个包都分配内存
+ * Udp batch receiver which reads multiple datagrams per readable event with recvmmsg.
+ * Receive buffers are preallocated and reused after the callback returns unless the consumer keeps a reference.
+ */
+class UdpBatchReceiver : public std::enable_shared_from_this<UdpBatchReceiver> {
+public:
+    using Ptr = std::shared_ptr<UdpBatchReceiver>;
+    using onReadCB = std::function<void(toolkit::Buffer::Ptr *buf, struct sockaddr_storage *addr, size_t count)>;
+    using onErrCB = std::function<void(const toolkit::SockException &err)>;
+
+    // 单次recvmmsg最大消息个数
+    static constexpr size_t kMaxBatch = 256;
+    // 单个接收缓存大小，超过该大小的udp包将被丢弃
+    static constexpr size_t kBufferSize = 8 * 1024;
+
+    /**
+     * 获取单次recvmmsg最大读取包数(由general.udp_batch_recv配置)，返回0表示未开启
+     */
+    static size_t getBatchSize();
+
+    /**
+     * 批量接收的总包数与唤醒(可读事件)次数，两者相除即为每次唤醒平均收包数
+     */
+    static uint64_t getTotalPackets();
+    static uint64_t getTotalWakeups();
+
+    UdpBatchReceiver(size_t batch_size);
+    ~UdpBatchReceiver();
+
+    /**
+     * 设置批量收包回调
+     */
+    void setOnRead(onReadCB cb);
+
+    /**
+     * 设置socket错误回调，接管后socket的setOnErr回调不再触发
+     * 与Socket一致，发生错误后停止接收并关闭socket，再触发本回调
+     */
+    void setOnErr(onErrCB cb);
+
+    /**
+     * 接管已绑定udp socket的读事件与错误事件，之后该socket的setOnRead、setOnErr回调不再触发
+     * 本对象会持有该socket，socket析构时其fd的事件监听一并移除
+     * @param sock 已绑定端口的udp socket
+     * @return 是否成功
+     */
+    bool attach(const toolkit::Socket::Ptr &sock);
+
+private:
+    void onEvent(int event);
+    void onRead();
+    void onError(const toolkit::SockException &err);
+    /**
+     * 读取一批udp包
+     * @param count 返回有效包个数
+     * @return 从内核读取的包个数(包含被丢弃的包)
+     */
+    size_t recvPackets(int fd, size_t &count);
+
+private:
+    size_t _batch_size;
+    onReadCB _on_read;
+    onErrCB _on_err;
+    toolkit::Socket::Ptr _sock;
+    std::vector<toolkit::BufferRaw::Ptr> _buffers;
+    std::vector<toolkit::Buffer::Ptr> _packets;
+    std::vector<struct sockaddr_storage> _addrs;
+#if defined(__linux__)
+    std::vector<struct iovec> _iov;
+    std::vector<struct mmsghdr> _msgs;
+#endif
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_UDPBATCHRECEIVER_H
@@ -0,0 +1,223 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "UdpBatchSender.h"
+#include "Common/config.h"
+#include <cstring>
+#include "Util/logger.h"
+#include "Util/uv_errno.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+static atomic<uint64_t> s_total_packets { 0 };
+static atomic<uint64_t> s_total_syscalls { 0 };
+
+#if defined(__linux__)
+static atomic<bool> s_gso_disabled { false };
+static const size_t kControlSize = CMSG_SPACE(sizeof(uint16_t));
+
+static bool isGsoSupported() {
+    // 低版本内核会忽略未知的cmsg并把所有分片合并为一个udp包发送，所以必须先探测
+    static bool supported = []() {
+        auto fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd == -1) {
+            return false;
+        }
+        int val = 0;
+        auto ret = setsockopt(fd, SOL_UDP, UDP_SEGMENT, &val, sizeof(val)) == 0;
+        close(fd);
+        InfoL << "UDP GSO supported: " << ret;
+        return ret;
+    }();
+    return supported;
+}
+#endif
+
+bool UdpBatchSender::isEnabled() {
+#if defined(__linux__)
+    GET_CONFIG(int, mode, General::kUdpBatchSend);
+    return mode != kModeOff;
+#else
+    return false;
+#endif
+}
+
+uint64_t UdpBatchSender::getTotalPackets() {
+    return s_total_packets.load(memory_order_relaxed);
+}
+
+uint64_t UdpBatchSender::getTotalSyscalls() {
+    return s_total_syscalls.load(memory_order_relaxed);
+}
+
+void UdpBatchSender::inputPacket(Buffer::Ptr buf) {
+    _packets.emplace_back(std::move(buf));
+}
+
+void UdpBatchSender::clear() {
+    _packets.clear();
+}
+
+void UdpBatchSender::flush(const Socket::Ptr &sock) {
+    if (_packets.empty()) {
+        return;
+    }
+    if (!sock) {
+        _packets.clear();
+        return;
+    }
+
+    size_t offset = 0;
+#if defined(__linux__)
+    GET_CONFIG(int, mode, General::kUdpBatchSend);
+    auto batch = mode != kModeOff && updatePeer(sock);
+    if (batch && sock->getSendBufferCount()) {
+        // Socket中还有之前回退缓存的包，先尝试发送它们；
+        // 仍未发完时本次也通过Socket排队发送，否则直接写fd的包会插队导致乱序
+        sock->flushAll();
+        batch = !sock->getSendBufferCount();
+    }
+    if (batch) {
+        auto gso = mode == kModeGso && !s_gso_disabled.load(memory_order_relaxed) && isGsoSupported();
+        auto fd = sock->rawFD();
+        while (offset < _packets.size()) {
+            auto sent = sendPackets(fd, offset, gso);
+            if (!sent) {
+                break;
+            }
+            offset += sent;
+        }
+    }
+#endif
+
+    if (offset < _packets.size()) {
+        // 内核缓存已满或批量发送失败，剩余的包回退为逐包发送(由Socket负责缓存与重试)
+        for (auto i = offset; i < _packets.size(); ++i) {
+            sock->send(std::move(_packets[i]), nullptr, 0, false);
+        }
+        sock->flushAll();
+    }
+    _packets.clear();
+}
+
+bool UdpBatchSender::updatePeer(const Socket::Ptr &sock) {
+    if (_peer_len && _peer_sock.lock() == sock) {
+        return true;
+    }
+    // 只缓存获取成功的对端地址，对端地址可能稍后才确定(例如收到第一个包后才绑定)
+    _peer_sock.reset();
+    _peer_len = 0;
+    auto ip = sock->get_peer_ip();
+    auto port = sock->get_peer_port();
+    if (ip.empty() || !port) {
+        return false;
+    }
+    _peer = SockUtil::make_sockaddr(ip.data(), port);
+    _peer_len = _peer.ss_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+    _peer_sock = sock;
+    return true;
+}
+
+size_t UdpBatchSender::sendPackets(int fd, size_t offset, bool gso) {
+#if defined(__linux__)
+    _iov.resize(_packets.size());
+    _msgs.resize(kMaxBatch);
+    _msg_packets.resize(kMaxBatch);
+    _control.resize(kMaxBatch * kControlSize);
+
+    size_t msg_count = 0;
+    size_t pkt = offset;
+    while (pkt < _packets.size() && msg_count < kMaxBatch) {
+        auto &msg = _msgs[msg_count].msg_hdr;
+        memset(&_msgs[msg_count], 0, sizeof(_msgs[msg_count]));
+        msg.msg_name = &_peer;
+        msg.msg_namelen = _peer_len;
+        msg.msg_iov = &_iov[pkt];
+
+        // gso要求除最后一个分片外所有分片大小一致，最后一个分片可以更小
+        auto seg_size = _packets[pkt]->size();
+        size_t segs = 0;
+        size_t bytes = 0;
+        while (pkt < _packets.size()) {
+            auto &buf = _packets[pkt];
+            auto size = buf->size();
+            if (segs && (!gso || size > seg_size || segs >= kMaxGsoSegments || bytes + size > kMaxGsoBytes)) {
+                break;
+            }
+            _iov[pkt].iov_base = buf->data();
+            _iov[pkt].iov_len = size;
+            ++pkt;
+            ++segs;
+            bytes += size;
+            if (size < seg_size) {
+                break;
+            }
+        }
+        msg.msg_iovlen = segs;
+
+        if (segs > 1) {
+            auto control = &_control[msg_count * kControlSize];
+            memset(control, 0, kControlSize);
+            msg.msg_control = control;
+            msg.msg_controllen = kControlSize;
+            auto cm = CMSG_FIRSTHDR(&msg);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type = UDP_SEGMENT;
+            cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            *((uint16_t *)CMSG_DATA(cm)) = (uint16_t)seg_size;
+        }
+        _msg_packets[msg_count++] = segs;
+    }
+
+    int ret;
+    do {
+        ret = sendmmsg(fd, _msgs.data(), msg_count, MSG_DONTWAIT);
+    } while (ret == -1 && errno == EINTR);
+    s_total_syscalls.fetch_add(1, memory_order_relaxed);
+
+    if (ret <= 0) {
+        if (gso && (errno == EIO || errno == EINVAL)) {
+            // 网卡或路由不支持gso，关闭gso后重试
+            if (!s_gso_disabled.exchange(true)) {
+                WarnL << "UDP GSO send failed, disable it: " << get_uv_errmsg(false);
+            }
+            return sendPackets(fd, offset, false);
+        }
+        // EAGAIN等错误由Socket逐包发送时处理
+        return 0;
+    }
+
+    size_t sent = 0;
+    for (int i = 0; i < ret; ++i) {
+        sent += _msg_packets[i];
+    }
+    s_total_packets.fetch_add(sent, memory_order_relaxed);
+    return sent;
+#else
+    return 0;
+#endif
+}
+
+} // namespace mediakit
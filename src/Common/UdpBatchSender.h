@@ -0,0 +1,96 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_UDPBATCHSENDER_H
+#define ZLMEDIAKIT_UDPBATCHSENDER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Network/Socket.h"
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+namespace mediakit {
+
+/**
+ * udp批量发送器，一次系统调用发送一帧的rtp包
+ * linux下使用sendmmsg，内核支持时相同大小的连续包合并为一个UDP GSO(UDP_SEGMENT)消息
+ * 内核缓存已满或不支持时，剩余的包回退为通过Socket逐包发送；Socket中有排队的包时本帧也通过Socket发送，保证包序
+ * Udp batch sender which sends the rtp packets of one frame in one syscall.
+ * On linux it uses sendmmsg, and merges consecutive packets of the same size into one UDP GSO (UDP_SEGMENT) message when supported.
+ * Packets not sent because of full kernel buffer or lack of support fall back to per-packet Socket::send,
+ * and the whole frame goes through the Socket while it still has queued packets, to keep packet order.
+ */
+class UdpBatchSender {
+public:
+    using Ptr = std::shared_ptr<UdpBatchSender>;
+
+    enum Mode {
+        kModeOff = 0, // 逐包发送
+        kModeMMsg = 1, // sendmmsg批量发送
+        kModeGso = 2 // sendmmsg + UDP GSO
+    };
+
+    // 单次sendmmsg最大消息个数
+    static constexpr size_t kMaxBatch = 64;
+    // 单个gso消息最大分片个数
+    static constexpr size_t kMaxGsoSegments = 64;
+    // 单个gso消息最大字节数
+    static constexpr size_t kMaxGsoBytes = 65000;
+
+    /**
+     * 是否开启了批量发送(由general.udp_batch_send配置)
+     */
+    static bool isEnabled();
+
+    /**
+     * 批量发送的总包数与系统调用次数，两者相除即为每次系统调用平均发包数
+     */
+    static uint64_t getTotalPackets();
+    static uint64_t getTotalSyscalls();
+
+    /**
+     * 缓存待发送的包
+     */
+    void inputPacket(toolkit::Buffer::Ptr buf);
+
+    /**
+     * 发送所有缓存的包到该socket的对端地址
+     * @param sock udp socket
+     */
+    void flush(const toolkit::Socket::Ptr &sock);
+
+    /**
+     * 清空缓存的包
+     */
+    void clear();
+
+private:
+    bool updatePeer(const toolkit::Socket::Ptr &sock);
+    size_t sendPackets(int fd, size_t offset, bool gso);
+
+private:
+    socklen_t _peer_len = 0;
+    struct sockaddr_storage _peer;
+    std::weak_ptr<toolkit::Socket> _peer_sock;
+    std::vector<toolkit::Buffer::Ptr> _packets;
+#if defined(__linux__)
+    std::vector<struct iovec> _iov;
+    std::vector<struct mmsghdr> _msgs;
+    std::vector<size_t> _msg_packets;
+    std::vector<char> _control;
+#endif
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_UDPBATCHSENDER_H
@@ -84,6 +84,12 @@ const string kWaitTrackReadyMS = GENERAL_FIELD "wait_track_ready_ms";
 const string kWaitAddTrackMS = GENERAL_FIELD "wait_add_track_ms";
 const string kUnreadyFrameCache = GENERAL_FIELD "unready_frame_cache";
 const string kBroadcastPlayerCountChanged = GENERAL_FIELD "broadcast_player_count_changed";
+const string kUdpBatchSend = GENERAL_FIELD "udp_batch_send";
+const string kUdpBatchRecv = GENERAL_FIELD "udp_batch_recv";
+const string kLatencyStat = GENERAL_FIELD "latency_stat";
+const string kPacerMaxBitrate = GENERAL_FIELD "pacer_max_bitrate";
+const string kPacerIntervalMS = GENERAL_FIELD "pacer_interval_ms";
+const string kComposeThreads = GENERAL_FIELD "compose_threads";
 
 static onceToken token([]() {
     mINI::Instance()[kFlowThreshold] = 1024;
@@ -99,6 +105,12 @@ static onceToken token([]() {
     mINI::Instance()[kWaitAddTrackMS] = 3000;
     mINI::Instance()[kUnreadyFrameCache] = 100;
     mINI::Instance()[kBroadcastPlayerCountChanged] = 0;
+    mINI::Instance()[kUdpBatchSend] = 0;
+    mINI::Instance()[kUdpBatchRecv] = 0;
+    mINI::Instance()[kLatencyStat] = 1;
+    mINI::Instance()[kPacerMaxBitrate] = 0;
+    mINI::Instance()[kPacerIntervalMS] = 5;
+    mINI::Instance()[kComposeThreads] = 0;
 });
 
 } // namespace General
@@ -131,6 +143,7 @@ const string kRtspDemand = PROTOCOL_FIELD "rtsp_demand";
 const string kRtmpDemand = PROTOCOL_FIELD "rtmp_demand";
 const string kTSDemand = PROTOCOL_FIELD "ts_demand";
 const string kFMP4Demand = PROTOCOL_FIELD "fmp4_demand";
+const string kSharedGopCache = PROTOCOL_FIELD "shared_gop_cache";
 
 static onceToken token([]() {
     mINI::Instance()[kModifyStamp] = (int)ProtocolOption::kModifyStampRelative;
@@ -159,6 +172,7 @@ static onceToken token([]() {
     mINI::Instance()[kRtmpDemand] = 0;
     mINI::Instance()[kTSDemand] = 0;
     mINI::Instance()[kFMP4Demand] = 0;
+    mINI::Instance()[kSharedGopCache] = 0;
 });
 } // !Protocol
 
@@ -222,6 +236,8 @@ const string kKeepAliveSecond = RTSP_FIELD "keepAliveSecond";
 const string kDirectProxy = RTSP_FIELD "directProxy";
 const string kLowLatency = RTSP_FIELD"lowLatency";
 const string kRtpTransportType = RTSP_FIELD"rtpTransportType";
+const string kSharedTcpBuffer = RTSP_FIELD "sharedTcpBuffer";
+const string kPacerRatio = RTSP_FIELD "pacerRatio";
 
 static onceToken token([]() {
     // 默认Md5方式认证
@@ -231,6 +247,8 @@ static onceToken token([]() {
     mINI::Instance()[kDirectProxy] = 1;
     mINI::Instance()[kLowLatency] = 0;
     mINI::Instance()[kRtpTransportType] = -1;
+    mINI::Instance()[kSharedTcpBuffer] = 1;
+    mINI::Instance()[kPacerRatio] = 0;
 });
 } // namespace Rtsp
 
@@ -241,12 +259,14 @@ const string kHandshakeSecond = RTMP_FIELD "handshakeSecond";
 const string kKeepAliveSecond = RTMP_FIELD "keepAliveSecond";
 const string kDirectProxy = RTMP_FIELD "directProxy";
 const string kEnhanced = RTMP_FIELD "enhanced";
+const string kSharedFlvTags = RTMP_FIELD "sharedFlvTags";
 
 static onceToken token([]() {
     mINI::Instance()[kHandshakeSecond] = 15;
     mINI::Instance()[kKeepAliveSecond] = 15;
     mINI::Instance()[kDirectProxy] = 1;
     mINI::Instance()[kEnhanced] = 0;
+    mINI::Instance()[kSharedFlvTags] = 1;
 });
 } // namespace Rtmp
 
@@ -296,6 +316,8 @@ const string kFileBufSize = RECORD_FIELD "fileBufSize";
 const string kFastStart = RECORD_FIELD "fastStart";
 const string kFileRepeat = RECORD_FIELD "fileRepeat";
 const string kEnableFmp4 = RECORD_FIELD "enableFmp4";
+const string kAsyncWriteThreads = RECORD_FIELD "asyncWriteThreads";
+const string kAsyncWriteMaxMB = RECORD_FIELD "asyncWriteMaxMB";
 
 static onceToken token([]() {
     mINI::Instance()[kAppName] = "record";
@@ -304,6 +326,8 @@ static onceToken token([]() {
     mINI::Instance()[kFastStart] = false;
     mINI::Instance()[kFileRepeat] = false;
     mINI::Instance()[kEnableFmp4] = false;
+    mINI::Instance()[kAsyncWriteThreads] = 2;
+    mINI::Instance()[kAsyncWriteMaxMB] = 64;
 });
 } // namespace Record
 
@@ -319,6 +343,10 @@ const string kFileBufSize = HLS_FIELD "fileBufSize";
 const string kBroadcastRecordTs = HLS_FIELD "broadcastRecordTs";
 const string kDeleteDelaySec = HLS_FIELD "deleteDelaySec";
 const string kFastRegister = HLS_FIELD "fastRegister";
+const string kPartDuration = HLS_FIELD "partDur";
+const string kPartWindow = HLS_FIELD "partWindow";
+const string kMemoryMode = HLS_FIELD "memoryMode";
+const string kMemoryBudget = HLS_FIELD "memoryBudget";
 
 static onceToken token([]() {
     mINI::Instance()[kSegmentDuration] = 2;
@@ -330,6 +358,10 @@ static onceToken token([]() {
     mINI::Instance()[kBroadcastRecordTs] = false;
     mINI::Instance()[kDeleteDelaySec] = 10;
     mINI::Instance()[kFastRegister] = false;
+    mINI::Instance()[kPartDuration] = 0;
+    mINI::Instance()[kPartWindow] = 3;
+    mINI::Instance()[kMemoryMode] = false;
+    mINI::Instance()[kMemoryBudget] = 1024;
 });
 } // namespace Hls
 
@@ -346,6 +378,7 @@ const string kOpusPT = RTP_PROXY_FIELD "opus_pt";
 const string kGopCache = RTP_PROXY_FIELD "gop_cache";
 const string kRtpG711DurMs = RTP_PROXY_FIELD "rtp_g711_dur_ms";
 const string kUdpRecvSocketBuffer = RTP_PROXY_FIELD "udp_recv_socket_buffer";
+const string kPacerRatio = RTP_PROXY_FIELD "pacer_ratio";
 
 static onceToken token([]() {
     mINI::Instance()[kDumpDir] = "";
@@ -358,6 +391,7 @@ static onceToken token([]() {
     mINI::Instance()[kGopCache] = 1;
     mINI::Instance()[kRtpG711DurMs] = 100;
     mINI::Instance()[kUdpRecvSocketBuffer] = 4 * 1024 * 1024;
+    mINI::Instance()[kPacerRatio] = 0;
 });
 } // namespace RtpProxy
 
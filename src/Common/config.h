@@ -202,6 +202,21 @@ extern const std::string kWaitAddTrackMS;
 extern const std::string kUnreadyFrameCache;
 // 是否启用观看人数变化事件广播，置1则启用，置0则关闭
 extern const std::string kBroadcastPlayerCountChanged;
+// udp批量发送模式(仅linux有效)，0:逐包发送，1:sendmmsg批量发送，2:sendmmsg并在内核支持时开启UDP GSO
+// 用于rtsp udp播放、rtp代理udp发送、webrtc udp播放
+extern const std::string kUdpBatchSend;
+// udp批量接收时单次recvmmsg最大读取包数(仅linux有效)，0或1为逐包接收
+// 用于rtp代理单端口单流的udp接收
+extern const std::string kUdpBatchRecv;
+// 是否开启延时统计(帧输入到写入环形缓存、环形缓存到各协议发送、事件轮询线程排队延时)
+extern const std::string kLatencyStat;
+// 平滑发送(pacer)时同一个poller线程所有会话共享的最大发送码率，单位kbps，置0不限制
+// 各协议是否开启平滑发送由rtc.pacerRatio、rtsp.pacerRatio、rtp_proxy.pacer_ratio控制
+extern const std::string kPacerMaxBitrate;
+// 平滑发送定时器间隔，单位毫秒
+extern const std::string kPacerIntervalMS;
+// 画面合成(VideoStack)时并行缩放与拷贝的线程数(含合成线程)，置0则为cpu核数
+extern const std::string kComposeThreads;
 } // namespace General
 
 namespace Protocol {
@@ -252,6 +267,8 @@ extern const std::string kRtspDemand;
 extern const std::string kRtmpDemand;
 extern const std::string kTSDemand;
 extern const std::string kFMP4Demand;
+// 按需转协议时是否开启各协议共享的帧级别gop缓存，开启后第一个播放者也可以秒开
+extern const std::string kSharedGopCache;
 } // !Protocol
 
 ////////////HTTP配置///////////
@@ -310,6 +327,12 @@ extern const std::string kLowLatency;
 //当客户端发起RTSP SETUP的时候如果传输类型和此配置不一致则返回461 Unsupport Transport
 //迫使客户端重新SETUP并切换到对应协议。目前支持FFMPEG和VLC
 extern const std::string kRtpTransportType;
+
+// rtsp tcp播放时，是否共享合并后的rtp over tcp缓存
+// 开启后每批rtp只拷贝一次，所有tcp播放器共享发送，适合大量tcp播放的场景
+extern const std::string kSharedTcpBuffer;
+// rtsp udp播放时平滑发送的码率为输入码率的倍数，置0关闭平滑发送
+extern const std::string kPacerRatio;
 } // namespace Rtsp
 
 ////////////RTMP服务器配置///////////
@@ -322,6 +345,9 @@ extern const std::string kKeepAliveSecond;
 extern const std::string kDirectProxy;
 // h265-rtmp是否采用增强型(或者国内扩展)
 extern const std::string kEnhanced;
+// http-flv/ws-flv播放时，是否共享序列化后的flv tag
+// 开启后每批rtmp包只序列化一次，所有播放器共享发送
+extern const std::string kSharedFlvTags;
 } // namespace Rtmp
 
 ////////////RTP配置///////////
@@ -362,6 +388,10 @@ extern const std::string kFastStart;
 extern const std::string kFileRepeat;
 // mp4录制文件是否采用fmp4格式
 extern const std::string kEnableFmp4;
+// 录制(mp4/hls)异步写盘的io线程数，0则在流所在线程同步写盘
+extern const std::string kAsyncWriteThreads;
+// 每路流等待写盘的数据上限，单位MB，超过后丢弃新的数据并告警，0则不限制
+extern const std::string kAsyncWriteMaxMB;
 } // namespace Record
 
 ////////////HLS相关配置///////////
@@ -384,6 +414,14 @@ extern const std::string kBroadcastRecordTs;
 extern const std::string kDeleteDelaySec;
 // 如果设置为1，则第一个切片长度强制设置为1个GOP
 extern const std::string kFastRegister;
+// LL-HLS part目标时长，单位秒，大于0时fmp4 hls开启LL-HLS
+extern const std::string kPartDuration;
+// LL-HLS m3u8中保留part的切片个数
+extern const std::string kPartWindow;
+// 内存hls模式，直播hls切片与m3u8只保存在内存中，不写磁盘
+extern const std::string kMemoryMode;
+// 内存hls模式下本进程所有切片占用内存上限，单位MB，0则不限制
+extern const std::string kMemoryBudget;
 } // namespace Hls
 
 ////////////Rtp代理相关配置///////////
@@ -410,6 +448,8 @@ extern const std::string kGopCache;
 extern const std::string kRtpG711DurMs;
 // udp recv socket buffer size
 extern const std::string kUdpRecvSocketBuffer;
+// udp发送rtp时平滑发送的码率为输入码率的倍数，置0关闭平滑发送
+extern const std::string kPacerRatio;
 } // namespace RtpProxy
 
 /**
@@ -18,6 +18,7 @@
 #include "Util/TimeTicker.h"
 #include "Common/Stamp.h"
 #include "Network/Buffer.h"
+#include "Common/PacketPool.h"
 
 namespace mediakit {
 
@@ -211,26 +212,14 @@ private:
     toolkit::ObjectStatistic<Frame> _statistic;
 };
 
-class FrameImp : public Frame {
+class FrameImp : public Frame, public PacketPoolObject {
 public:
     using Ptr = std::shared_ptr<FrameImp>;
 
     template <typename C = FrameImp>
     static std::shared_ptr<C> create() {
-#if 0
-        static ResourcePool<C> packet_pool;
-        static onceToken token([]() {
-            packet_pool.setSize(1024);
-        });
-        auto ret = packet_pool.obtain2();
-        ret->_buffer.clear();
-        ret->_prefix_size = 0;
-        ret->_dts = 0;
-        ret->_pts = 0;
-        return ret;
-#else
-        return std::shared_ptr<C>(new C());
-#endif
+        // 对象与控制块从线程缓存内存池分配
+        return makePooledShared(new C());
     }
 
     char *data() const override { return (char *)_buffer.data(); }
@@ -0,0 +1,194 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include "StartCode.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENABLE_STARTCODE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ENABLE_STARTCODE_NEON
+#endif
+
+// avx2需要运行时判断cpu是否支持，只编译该函数的avx2指令，不要求整个工程开启-mavx2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ENABLE_STARTCODE_AVX2
+#define STARTCODE_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define ENABLE_STARTCODE_AVX2
+#define STARTCODE_AVX2_TARGET
+#endif
+
+using namespace std;
+
+namespace mediakit {
+
+static inline int firstBit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static const char *findStartCodeC(const char *ptr, const char *end) {
+    // 参考ffmpeg的ff_avc_find_startcode_internal，根据第3个字节的值一次跳过多个字节
+    auto p = (const uint8_t *)ptr;
+    auto e = (const uint8_t *)end;
+    while (p + 3 <= e) {
+        if (p[2] > 1) {
+            p += 3;
+        } else if (p[1]) {
+            p += 2;
+        } else if (p[0] || p[2] != 1) {
+            ++p;
+        } else {
+            return (const char *)p;
+        }
+    }
+    return nullptr;
+}
+
+#if defined(ENABLE_STARTCODE_SSE2)
+static const char *findStartCodeSSE2(const char *ptr, const char *end) {
+    auto p = (const uint8_t *)ptr;
+    auto e = (const uint8_t *)end;
+    auto zero = _mm_setzero_si128();
+    auto one = _mm_set1_epi8(1);
+    // 每次比较16个位置，需要读取18个字节
+    for (; p + 18 <= e; p += 16) {
+        auto b0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), zero);
+        auto b1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 1)), zero);
+        auto b2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 2)), one);
+        auto mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2));
+        if (mask) {
+            return (const char *)p + firstBit(mask);
+        }
+    }
+    return findStartCodeC((const char *)p, end);
+}
+#endif
+
+#if defined(ENABLE_STARTCODE_NEON)
+static const char *findStartCodeNEON(const char *ptr, const char *end) {
+    auto p = (const uint8_t *)ptr;
+    auto e = (const uint8_t *)end;
+    auto zero = vdupq_n_u8(0);
+    auto one = vdupq_n_u8(1);
+    for (; p + 18 <= e; p += 16) {
+        auto b0 = vceqq_u8(vld1q_u8(p), zero);
+        auto b1 = vceqq_u8(vld1q_u8(p + 1), zero);
+        auto b2 = vceqq_u8(vld1q_u8(p + 2), one);
+        auto match = vandq_u8(vandq_u8(b0, b1), b2);
+        // neon没有movemask，先判断是否有匹配，有匹配时再逐个确认
+        auto pair = vorr_u8(vget_low_u8(match), vget_high_u8(match));
+        if (vget_lane_u64(vreinterpret_u64_u8(pair), 0)) {
+            return findStartCodeC((const char *)p, (const char *)p + 18);
+        }
+    }
+    return findStartCodeC((const char *)p, end);
+}
+#endif
+
+#if defined(ENABLE_STARTCODE_AVX2)
+STARTCODE_AVX2_TARGET static const char *findStartCodeAVX2(const char *ptr, const char *end) {
+    auto p = (const uint8_t *)ptr;
+    auto e = (const uint8_t *)end;
+    auto zero = _mm256_setzero_si256();
+    auto one = _mm256_set1_epi8(1);
+    // 每次比较32个位置，需要读取34个字节
+    for (; p + 34 <= e; p += 32) {
+        auto b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), zero);
+        auto b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 1)), zero);
+        auto b2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 2)), one);
+        auto mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(b0, b1), b2));
+        if (mask) {
+            return (const char *)p + firstBit(mask);
+        }
+    }
+    return findStartCodeC((const char *)p, end);
+}
+
+static bool cpuSupportAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // 操作系统需要支持保存ymm寄存器
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+FindStartCodeFunc getStartCodeFinder(const string &name) {
+    if (name.empty()) {
+        static auto s_func = getStartCodeFinder(getStartCodeFinderName());
+        return s_func;
+    }
+    if (name == "c") {
+        return findStartCodeC;
+    }
+#if defined(ENABLE_STARTCODE_SSE2)
+    if (name == "sse2") {
+        return findStartCodeSSE2;
+    }
+#endif
+#if defined(ENABLE_STARTCODE_NEON)
+    if (name == "neon") {
+        return findStartCodeNEON;
+    }
+#endif
+#if defined(ENABLE_STARTCODE_AVX2)
+    if (name == "avx2" && cpuSupportAVX2()) {
+        return findStartCodeAVX2;
+    }
+#endif
+    return nullptr;
+}
+
+const char *getStartCodeFinderName() {
+#if defined(ENABLE_STARTCODE_AVX2)
+    static auto s_avx2 = cpuSupportAVX2();
+    if (s_avx2) {
+        return "avx2";
+    }
+#endif
+#if defined(ENABLE_STARTCODE_SSE2)
+    return "sse2";
+#elif defined(ENABLE_STARTCODE_NEON)
+    return "neon";
+#else
+    return "c";
+#endif
+}
+
+const char *findStartCode(const char *ptr, const char *end) {
+    static auto s_func = getStartCodeFinder();
+    return s_func(ptr, end);
+}
+
+} // namespace mediakit
@@ -0,0 +1,43 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_STARTCODE_H
+#define ZLMEDIAKIT_STARTCODE_H
+
+#include <string>
+
+namespace mediakit {
+
+using FindStartCodeFunc = const char *(*)(const char *ptr, const char *end);
+
+/**
+ * 查找h264/h265 annexb起始码00 00 01
+ * 运行时根据cpu支持的指令集选择avx2/sse2/neon或标量实现
+ * 4字节起始码00 00 00 01需要调用者判断返回位置的前一个字节
+ * @param ptr 查找开始位置
+ * @param end 查找结束位置，起始码3个字节都必须在该位置之前
+ * @return 起始码位置，未找到时返回nullptr
+ */
+const char *findStartCode(const char *ptr, const char *end);
+
+/**
+ * 获取指定的起始码查找实现，主要用于测试与性能对比
+ * @param name c、sse2、neon或avx2，为空时返回运行时选择的实现
+ * @return 当前编译选项或cpu不支持时返回nullptr
+ */
+FindStartCodeFunc getStartCodeFinder(const std::string &name = "");
+
+/**
+ * 获取运行时选择的起始码查找实现名
+ */
+const char *getStartCodeFinderName();
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_STARTCODE_H
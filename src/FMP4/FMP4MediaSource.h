@@ -35,7 +35,7 @@ public:
 class FMP4MediaSource final : public MediaSource, public toolkit::RingDelegate<FMP4Packet::Ptr>, private PacketCache<FMP4Packet>{
 public:
     using Ptr = std::shared_ptr<FMP4MediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<FMP4Packet::Ptr> >;
+    using RingDataType = std::shared_ptr<LatencyList<FMP4Packet::Ptr> >;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     FMP4MediaSource(const MediaTuple& tuple,
@@ -78,6 +78,10 @@ public:
         return _ring ? _ring->readerCount() : 0;
     }
 
+    const LatencyHistogram *getIngestLatency() const override {
+        return &PacketCache<FMP4Packet>::getIngestLatency();
+    }
+
     /**
      * 输入FMP4包
      * @param packet FMP4包
@@ -95,6 +99,13 @@ public:
         PacketCache<FMP4Packet>::inputPacket(stamp, true, std::move(packet), key);
     }
 
+    /**
+     * 设置是否缓存gop，由共享gop缓存提供首次播放数据时，环形缓存只保留最新的数据
+     */
+    void setKeepGop(bool keep_gop) {
+        _keep_gop = keep_gop;
+    }
+
     /**
      * 情况GOP缓存
      */
@@ -123,13 +134,14 @@ private:
      * @param packet_list 合并写缓存列队
      * @param key_pos 是否包含关键帧
      */
-    void onFlush(std::shared_ptr<toolkit::List<FMP4Packet::Ptr> > packet_list, bool key_pos) override {
+    void onFlush(std::shared_ptr<LatencyList<FMP4Packet::Ptr> > packet_list, bool key_pos) override {
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以确保一直清空GOP缓存
-        _ring->write(std::move(packet_list), _have_video ? key_pos : true);
+        _ring->write(std::move(packet_list), _have_video && _keep_gop ? key_pos : true);
     }
 
 private:
     bool _have_video = false;
+    bool _keep_gop = true;
     int _ring_size;
     std::string _init_segment;
     RingType::Ptr _ring;
@@ -13,15 +13,16 @@
 
 #include "FMP4MediaSource.h"
 #include "Record/MP4Muxer.h"
+#include "Common/FrameGopCache.h"
 
 namespace mediakit {
 
-class FMP4MediaSourceMuxer final : public MP4MuxerMemory, public MediaSourceEventInterceptor,
+class FMP4MediaSourceMuxer final : public MP4MuxerMemory, public MediaSourceEventInterceptor, public FrameGopReplayer,
                                    public std::enable_shared_from_this<FMP4MediaSourceMuxer> {
 public:
     using Ptr = std::shared_ptr<FMP4MediaSourceMuxer>;
 
-    FMP4MediaSourceMuxer(const MediaTuple& tuple, const ProtocolOption &option) {
+    FMP4MediaSourceMuxer(const MediaTuple& tuple, const ProtocolOption &option) : FrameGopReplayer(option.fmp4_demand) {
         _option = option;
         _media_src = std::make_shared<FMP4MediaSource>(tuple);
     }
@@ -49,13 +50,22 @@ public:
         if (_clear_cache && _option.fmp4_demand) {
             _clear_cache = false;
             _media_src->clearCache();
+            resetGopIndex();
         }
         if (_enabled || !_option.fmp4_demand) {
+            replayGop([this](const Frame::Ptr &frame) { MP4MuxerMemory::inputFrame(frame); });
             return MP4MuxerMemory::inputFrame(frame);
         }
         return false;
     }
 
+    /**
+     * 设置共享gop缓存，按需转协议时用于首次播放，此时协议环形缓存不再缓存gop
+     */
+    void setGopCache(const FrameGopCache::Ptr &gop_cache) {
+        _media_src->setKeepGop(!FrameGopReplayer::setGopCache(gop_cache));
+    }
+
     bool isEnabled() {
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.fmp4_demand ? (_clear_cache ? true : _enabled) : true;
@@ -447,6 +447,130 @@ static string pathCat(const string &a, const string &b){
     return a + '/' + b;
 }
 
+/**
+ * 获取LL-HLS阻塞式m3u8刷新参数(_HLS_msn/_HLS_part)
+ * @param part 未指定_HLS_part时为-1
+ * @return 是否为阻塞式刷新请求
+ */
+static bool getHlsBlockingArgs(const Parser &parser, uint64_t &msn, int64_t &part) {
+    auto &args = parser.getUrlArgs();
+    auto msn_str = args["_HLS_msn"];
+    if (msn_str.empty()) {
+        return false;
+    }
+    msn = strtoull(msn_str.data(), nullptr, 10);
+    auto part_str = args["_HLS_part"];
+    part = part_str.empty() ? -1 : strtoll(part_str.data(), nullptr, 10);
+    return true;
+}
+
+/**
+ * LL-HLS请求挂起的超时时间，单位毫秒
+ */
+static uint64_t getHlsBlockingTimeout() {
+    GET_CONFIG(float, segDur, Hls::kSegmentDuration);
+    // 协议要求服务器至少挂起3倍目标时长
+    return MAX((uint64_t)(segDur * 3000), (uint64_t)1000);
+}
+
+/**
+ * 从内存回复hls切片或part
+ * @param file_path 文件名，用于获取content-type
+ */
+static void responseHlsSegment(const string &file_path, Buffer::Ptr buffer, const HttpServerCookie::Ptr &cookie, const HttpFileManager::invoker &cb) {
+    StrCaseMap headerOut;
+    if (cookie) {
+        headerOut["Set-Cookie"] = cookie->getCookie(cookie->getAttach<HttpCookieAttachment>()._path);
+        auto &attach = cookie->getAttach<HttpCookieAttachment>();
+        if (attach._hls_data) {
+            attach._hls_data->addByteUsage(buffer->size());
+        }
+    }
+    cb(200, HttpFileManager::getContentType(file_path.data()), headerOut, std::make_shared<HttpBufferBody>(std::move(buffer)));
+}
+
+/**
+ * 从内存回复LL-HLS part，part尚未生成时(预加载提示)挂起请求直到生成
+ * @param src fmp4 hls媒体源
+ * @param msn part所属切片序号
+ * @param part part在切片中的序号
+ * @param cookie 播放器cookie，用于统计流量
+ * @param cb 回调对象
+ */
+static void responseHlsPart(const HlsMediaSource::Ptr &src, uint64_t msn, uint32_t part, const HttpServerCookie::Ptr &cookie, const HttpFileManager::invoker &cb) {
+    weak_ptr<HlsMediaSource> weak_src = src;
+    src->waitPart(msn, part, getHlsBlockingTimeout(), [weak_src, msn, part, cookie, cb](bool ready) {
+        auto src = weak_src.lock();
+        auto buffer = src && ready ? src->getPart(msn, part) : nullptr;
+        if (!buffer) {
+            // 超时或已经过期删除
+            sendNotFound(cb);
+            return;
+        }
+        responseHlsSegment(".m4s", std::move(buffer), cookie, cb);
+    });
+}
+
+/**
+ * 访问内存中的hls文件：LL-HLS part，或者内存hls模式下的切片、init.mp4与延时m3u8
+ * @return 是否为内存hls文件请求
+ */
+static bool accessHlsMemory(Session &sender, const Parser &parser, const MediaInfo &media_info, const string &file_path, const HttpFileManager::invoker &cb) {
+    uint64_t msn = 0;
+    uint32_t part = 0;
+    auto pos = media_info.stream.rfind('/');
+    if (pos == string::npos) {
+        return false;
+    }
+    auto name = media_info.stream.substr(pos + 1);
+    // 先按后缀过滤，非hls文件请求不需要查找内存与磁盘
+    bool is_part = end_with(name, ".m4s") && HlsMediaSource::parsePartName(name, msn, part);
+    const char *schema = nullptr;
+    if (is_part || end_with(name, ".mp4") || end_with(name, ".fmp4_delay.m3u8")) {
+        schema = HLS_FMP4_SCHEMA;
+    } else if (end_with(name, ".ts") || end_with(name, "_delay.m3u8")) {
+        schema = HLS_SCHEMA;
+    } else {
+        return false;
+    }
+    if (!is_part && !HlsMediaSource::getSegmentMemory()) {
+        // 没有内存hls切片
+        return false;
+    }
+    if (File::fileExist(file_path)) {
+        return false;
+    }
+    auto src = dynamic_pointer_cast<HlsMediaSource>(MediaSource::find(schema, media_info.vhost, media_info.app, media_info.stream.substr(0, pos)));
+    Buffer::Ptr segment = src && !is_part ? src->getSegment(name) : nullptr;
+    if (!src || (!is_part && !segment)) {
+        sendNotFound(cb);
+        return true;
+    }
+
+    weak_ptr<Session> weak_session = static_pointer_cast<Session>(sender.shared_from_this());
+    // 与切片文件同目录，采用相同的鉴权方式
+    canAccessPath(sender, parser, media_info, false, [weak_session, src, msn, part, segment, file_path, cb](const string &err_msg, const HttpServerCookie::Ptr &cookie) {
+        if (!weak_session.lock()) {
+            // http客户端已经断开，不需要回复
+            return;
+        }
+        if (!err_msg.empty()) {
+            StrCaseMap headerOut;
+            if (cookie) {
+                headerOut["Set-Cookie"] = cookie->getCookie(cookie->getAttach<HttpCookieAttachment>()._path);
+            }
+            cb(401, "text/html", headerOut, std::make_shared<HttpStringBody>(err_msg));
+            return;
+        }
+        if (segment) {
+            responseHlsSegment(file_path, segment, cookie, cb);
+        } else {
+            responseHlsPart(src, msn, part, cookie, cb);
+        }
+    });
+    return true;
+}
+
 /**
  * 访问文件
  * @param sender 事件触发者
@@ -457,6 +581,10 @@ static string pathCat(const string &a, const string &b){
  */
 static void accessFile(Session &sender, const Parser &parser, const MediaInfo &media_info, const string &file_path, const HttpFileManager::invoker &cb) {
     bool is_hls = end_with(file_path, kHlsSuffix) || end_with(file_path, kHlsFMP4Suffix);
+    if (!is_hls && accessHlsMemory(sender, parser, media_info, file_path, cb)) {
+        // LL-HLS part或内存hls切片
+        return;
+    }
     if (!is_hls && !File::fileExist(file_path)) {
         //文件不存在且不是hls,那么直接返回404
         sendNotFound(cb);
@@ -518,23 +646,44 @@ static void accessFile(Session &sender, const Parser &parser, const MediaInfo &m
             invoker.responseFile(parser.getHeader(), httpHeader, file_content.empty() ? file_path : file_content, !is_hls && !is_forbid_cache, file_content.empty());
         };
 
-        if (!is_hls || !cookie) {
-            //不是hls或访问m3u8文件不带cookie, 直接回复文件或404
+        if (!is_hls) {
+            //不是hls, 直接回复文件或404
             response_file(cookie, cb, file_path, parser);
-            if (is_hls) {
-                WarnL << "access m3u8 file without cookie:" << file_path;
-            }
+            return;
+        }
+        if (!cookie) {
+            // 访问m3u8文件不带cookie，内存hls模式下m3u8不落盘，优先从HlsMediaSource获取，否则回复文件或404
+            WarnL << "access m3u8 file without cookie:" << file_path;
+            auto hls = dynamic_pointer_cast<HlsMediaSource>(MediaSource::find(media_info.schema, media_info.vhost, media_info.app, media_info.stream));
+            auto index_file = hls ? hls->getIndexFile() : "";
+            response_file(cookie, cb, file_path, parser, index_file);
             return;
         }
 
         auto &attach = cookie->getAttach<HttpCookieAttachment>();
         auto src = attach._hls_data->getMediaSource();
+        uint64_t msn;
+        int64_t part;
+        if (src && getHlsBlockingArgs(parser, msn, part)) {
+            // LL-HLS阻塞式m3u8刷新，挂起请求直到m3u8包含指定的part
+            weak_ptr<HlsMediaSource> weak_src = src;
+            src->waitPart(msn, part, getHlsBlockingTimeout(), [weak_src, response_file, cookie, cb, file_path, parser](bool ready) {
+                auto src = weak_src.lock();
+                if (!src) {
+                    response_file(cookie, cb, file_path, parser);
+                    return;
+                }
+                // 超时也回复最新的m3u8
+                response_file(cookie, cb, file_path, parser, src->getIndexFile());
+            });
+            return;
+        }
         if (src) {
             // 直接从内存获取m3u8索引文件(而不是从文件系统)
             response_file(cookie, cb, file_path, parser, src->getIndexFile());
             return;
         }
-        if (attach._find_src && attach._find_src_ticker.elapsedTime() < kFindSrcIntervalSecond * 1000) {
+        if (attach._find_src && attach._find_src_ticker.elapsedTime() < kFindSrcIntervalSecond * 1000 && File::fileExist(file_path)) {
             // 最近已经查找过MediaSource了，为了防止频繁查找导致占用全局互斥锁的问题，我们尝试直接从磁盘返回hls索引文件
             response_file(cookie, cb, file_path, parser);
             return;
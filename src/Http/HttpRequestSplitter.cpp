@@ -11,6 +11,7 @@
 #include "HttpRequestSplitter.h"
 #include "Util/logger.h"
 #include "Util/util.h"
+#include "Common/ParserView.h"
 using namespace toolkit;
 using namespace std;
 
@@ -79,7 +80,10 @@ void HttpRequestSplitter::input(const char *data,size_t len) {
 
     if(_content_len == 0){
         //尚未找到http头，缓存定位到剩余数据部分
-        _remain_data.assign(ptr,_remain_data_size);
+        if (ptr != _remain_data.data()) {
+            //数据已经全部在缓存中时不用重复拷贝
+            _remain_data.assign(ptr, _remain_data_size);
+        }
         return;
     }
 
@@ -127,11 +131,7 @@ void HttpRequestSplitter::reset() {
 }
 
 const char *HttpRequestSplitter::onSearchPacketTail(const char *data,size_t len) {
-    auto pos = strstr(data,"\r\n\r\n");
-    if(pos == nullptr){
-        return nullptr;
-    }
-    return  pos + 4;
+    return ParserView::findHeaderTail(data, len);
 }
 
 size_t HttpRequestSplitter::remainDataSize() {
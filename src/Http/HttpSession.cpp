@@ -13,6 +13,7 @@
 #include <algorithm>
 #include "Common/config.h"
 #include "Common/strCoding.h"
+#include "Common/Metrics.h"
 #include "HttpSession.h"
 #include "HttpConst.h"
 #include "Util/base64.h"
@@ -147,9 +148,15 @@ void HttpSession::onRecvContent(const char *data, size_t len) {
 
 void HttpSession::onRecv(const Buffer::Ptr &pBuf) {
     _ticker.resetTime();
+    Metrics::add(Metrics::kHttpBytesIn, pBuf->size());
     input(pBuf->data(), pBuf->size());
 }
 
+ssize_t HttpSession::send(Buffer::Ptr pkt) {
+    Metrics::add(Metrics::kHttpBytesOut, pkt->size());
+    return Session::send(std::move(pkt));
+}
+
 void HttpSession::onError(const SockException &err) {
     if (_is_live_stream) {
         // flv/ts播放器
@@ -355,6 +362,8 @@ bool HttpSession::checkLiveStreamFMP4(const function<void()> &cb) {
             }
             strong_self->shutdown(SockException(Err_shutdown, "fmp4 ring buffer detached"));
         });
+        // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+        LatencyStat::ReplayScope replay_scope;
         _fmp4_reader->setReadCB([weak_self](const FMP4MediaSource::RingDataType &fmp4_list) {
             auto strong_self = weak_self.lock();
             if (!strong_self) {
@@ -364,6 +373,7 @@ bool HttpSession::checkLiveStreamFMP4(const function<void()> &cb) {
             size_t i = 0;
             auto size = fmp4_list->size();
             fmp4_list->for_each([&](const FMP4Packet::Ptr &ts) { strong_self->onWrite(ts, ++i == size); });
+            LatencyStat::onSend(LatencyStat::kRingToFmp4, *fmp4_list);
         });
     });
 }
@@ -399,6 +409,8 @@ bool HttpSession::checkLiveStreamTS(const function<void()> &cb) {
             }
             strong_self->shutdown(SockException(Err_shutdown, "ts ring buffer detached"));
         });
+        // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+        LatencyStat::ReplayScope replay_scope;
         _ts_reader->setReadCB([weak_self](const TSMediaSource::RingDataType &ts_list) {
             auto strong_self = weak_self.lock();
             if (!strong_self) {
@@ -408,6 +420,7 @@ bool HttpSession::checkLiveStreamTS(const function<void()> &cb) {
             size_t i = 0;
             auto size = ts_list->size();
             ts_list->for_each([&](const TSPacket::Ptr &ts) { strong_self->onWrite(ts, ++i == size); });
+            LatencyStat::onSend(LatencyStat::kRingToTs, *ts_list);
         });
     });
 }
@@ -770,6 +783,20 @@ void HttpSession::onWrite(const Buffer::Ptr &buffer, bool flush) {
     }
 }
 
+void HttpSession::onWriteFlvTags(const RtmpMediaSource::RingDataType &pkt) {
+    if (!_live_over_websocket) {
+        FlvMuxer::onWriteFlvTags(pkt);
+        return;
+    }
+    // websocket帧头与flv tag都是共享的，整批rtmp包作为一个websocket帧发送
+    _ticker.resetTime();
+    // 帧头先缓存不刷新，与flv tag一起发送
+    onWebSocketEncodeData(pkt->getWebSocketHeader());
+    HttpSession::setSendFlushFlag(true);
+    onWebSocketEncodeData(pkt->getFlvTags());
+    HttpSession::setSendFlushFlag(false);
+}
+
 void HttpSession::onWebSocketEncodeData(Buffer::Ptr buffer) {
     _total_bytes_usage += buffer->size();
     send(std::move(buffer));
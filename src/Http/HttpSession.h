@@ -44,12 +44,15 @@ public:
     void onRecv(const toolkit::Buffer::Ptr &) override;
     void onError(const toolkit::SockException &err) override;
     void onManager() override;
+    using toolkit::Session::send;
+    ssize_t send(toolkit::Buffer::Ptr pkt) override;
     void setTimeoutSec(size_t second);
     void setMaxReqSize(size_t max_req_size);
 
 protected:
     //FlvMuxer override
     void onWrite(const toolkit::Buffer::Ptr &data, bool flush) override ;
+    void onWriteFlvTags(const RtmpMediaSource::RingDataType &pkt) override;
     void onDetach() override;
     std::shared_ptr<FlvMuxer> getSharedPtr() override;
 
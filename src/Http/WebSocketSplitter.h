@@ -99,6 +99,13 @@ public:
      */
     void encode(const WebSocketHeader &header,const toolkit::Buffer::Ptr &buffer);
 
+    /**
+     * 生成数据包头(包括掩码，不包括负载)
+     * @param header 数据头
+     * @param len 负载数据长度
+     */
+    static std::string encodeHeader(const WebSocketHeader &header, uint64_t len);
+
 protected:
     /**
      * 收到一个webSocket数据包包头，后续将继续触发onWebSocketDecodePayload回调
@@ -0,0 +1,403 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <condition_variable>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+#include "DiskWriter.h"
+#include "Util/File.h"
+#include "Util/util.h"
+#include "Util/logger.h"
+#include "Util/uv_errno.h"
+#include "Common/config.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+static atomic<size_t> s_queue_depth { 0 };
+static atomic<uint64_t> s_pending_bytes { 0 };
+static atomic<uint64_t> s_write_bytes { 0 };
+static atomic<uint64_t> s_drop_bytes { 0 };
+static atomic<uint64_t> s_write_count { 0 };
+static atomic<uint64_t> s_write_cost_us { 0 };
+static atomic<uint64_t> s_max_write_cost_us { 0 };
+
+static void runTask(const function<void()> &task) {
+    try {
+        task();
+    } catch (std::exception &ex) {
+        WarnL << "Disk write task failed: " << ex.what();
+    }
+}
+
+class DiskWorker {
+public:
+    DiskWorker(size_t index) {
+        _thread = std::thread([this, index]() {
+            setThreadName(("disk writer " + to_string(index)).data());
+            run();
+        });
+    }
+
+    ~DiskWorker() {
+        {
+            lock_guard<mutex> lck(_mtx);
+            _exit = true;
+        }
+        _cond.notify_one();
+        // 退出前写完所有数据
+        _thread.join();
+    }
+
+    void async(function<void()> task) {
+        ++s_queue_depth;
+        {
+            lock_guard<mutex> lck(_mtx);
+            _tasks.emplace_back(std::move(task));
+        }
+        _cond.notify_one();
+    }
+
+private:
+    void run() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lck(_mtx);
+                _cond.wait(lck, [this]() { return _exit || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            runTask(task);
+            --s_queue_depth;
+        }
+    }
+
+private:
+    bool _exit = false;
+    mutex _mtx;
+    condition_variable _cond;
+    deque<function<void()> > _tasks;
+    std::thread _thread;
+};
+
+DiskWriter::DiskWriter() {
+    GET_CONFIG(uint32_t, threads, Record::kAsyncWriteThreads);
+    for (size_t i = 0; i < threads; ++i) {
+        _workers.emplace_back(std::make_shared<DiskWorker>(i));
+    }
+}
+
+DiskWriter::~DiskWriter() = default;
+
+DiskWriter &DiskWriter::Instance() {
+    static DiskWriter s_instance;
+    return s_instance;
+}
+
+size_t DiskWriter::getWorker() {
+    return _workers.empty() ? 0 : _index++ % _workers.size();
+}
+
+void DiskWriter::async(size_t worker, function<void()> task) {
+    if (_workers.empty()) {
+        // 未开启异步写盘，在调用线程同步执行
+        runTask(task);
+        return;
+    }
+    _workers[worker % _workers.size()]->async(std::move(task));
+}
+
+void DiskWriter::onWrite(size_t bytes, uint64_t cost_us) {
+    s_write_bytes += bytes;
+    ++s_write_count;
+    s_write_cost_us += cost_us;
+    auto max_cost = s_max_write_cost_us.load(memory_order_relaxed);
+    while (cost_us > max_cost && !s_max_write_cost_us.compare_exchange_weak(max_cost, cost_us, memory_order_relaxed)) {}
+}
+
+void DiskWriter::onDrop(size_t bytes) {
+    s_drop_bytes += bytes;
+}
+
+size_t DiskWriter::getQueueDepth() {
+    return s_queue_depth;
+}
+
+uint64_t DiskWriter::getPendingBytes() {
+    return s_pending_bytes;
+}
+
+uint64_t DiskWriter::getWriteBytes() {
+    return s_write_bytes;
+}
+
+uint64_t DiskWriter::getDropBytes() {
+    return s_drop_bytes;
+}
+
+uint64_t DiskWriter::getWriteLatencyUS() {
+    auto count = s_write_count.load();
+    return count ? s_write_cost_us / count : 0;
+}
+
+uint64_t DiskWriter::getMaxWriteLatencyUS() {
+    return s_max_write_cost_us;
+}
+
+/////////////////////////////////////////////////////DiskWriteQueue/////////////////////////////////////////////////////////
+
+DiskWriteQueue::DiskWriteQueue() {
+    _worker = DiskWriter::Instance().getWorker();
+}
+
+void DiskWriteQueue::async(function<void()> task) {
+    DiskWriter::Instance().async(_worker, std::move(task));
+}
+
+void DiskWriteQueue::writeFile(const string &path, string data) {
+    auto bytes = data.size();
+    if (!acquire(bytes)) {
+        DiskWriter::onDrop(bytes);
+        WarnL << "Disk write queue is full(" << getPendingBytes() << " bytes), drop file: " << path;
+        return;
+    }
+    auto self = shared_from_this();
+    auto start = getCurrentMicrosecond();
+    async([self, path, data, start]() {
+        auto fp = File::create_file(path.data(), "wb");
+        if (fp) {
+            fwrite(data.data(), data.size(), 1, fp);
+            fclose(fp);
+        } else {
+            WarnL << "Create file failed," << path << " " << get_uv_errmsg();
+        }
+        self->release(data.size());
+        DiskWriter::onWrite(data.size(), getCurrentMicrosecond() - start);
+    });
+}
+
+void DiskWriteQueue::deleteFile(const string &path, bool del_empty_dir) {
+    async([path, del_empty_dir]() { File::delete_file(path.data(), del_empty_dir); });
+}
+
+bool DiskWriteQueue::acquire(size_t bytes) {
+    GET_CONFIG(uint32_t, max_mb, Record::kAsyncWriteMaxMB);
+    if (max_mb && _pending_bytes + bytes > max_mb * 1024ULL * 1024) {
+        return false;
+    }
+    _pending_bytes += bytes;
+    s_pending_bytes += bytes;
+    return true;
+}
+
+void DiskWriteQueue::release(size_t bytes) {
+    _pending_bytes -= bytes;
+    s_pending_bytes -= bytes;
+}
+
+/////////////////////////////////////////////////////AsyncFile/////////////////////////////////////////////////////////
+
+struct AsyncFile::Context {
+    ~Context() {
+        if (fp) {
+            fclose(fp);
+        }
+    }
+
+    std::string path;
+    FILE *fp = nullptr;
+    atomic<bool> failed { false };
+};
+
+static bool writeAt(FILE *fp, uint64_t offset, const char *data, size_t len) {
+#if defined(_WIN32)
+    return _fseeki64(fp, offset, SEEK_SET) == 0 && fwrite(data, 1, len, fp) == len;
+#else
+    auto fd = fileno(fp);
+    while (len) {
+        auto n = pwrite(fd, data, len, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+#endif
+}
+
+static size_t readAt(FILE *fp, uint64_t offset, char *data, size_t len) {
+#if defined(_WIN32)
+    return _fseeki64(fp, offset, SEEK_SET) == 0 ? fread(data, 1, len, fp) : 0;
+#else
+    auto fd = fileno(fp);
+    size_t ret = 0;
+    while (ret < len) {
+        auto n = pread(fd, data + ret, len - ret, offset + ret);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        ret += n;
+    }
+    return ret;
+#endif
+}
+
+AsyncFile::AsyncFile(DiskWriteQueue::Ptr queue, string path, const char *mode, size_t buf_size) {
+    _queue = std::move(queue);
+    _buf_size = MAX(buf_size, (size_t)4 * 1024);
+    _ctx = std::make_shared<Context>();
+    _ctx->path = std::move(path);
+    auto ctx = _ctx;
+    string mode_str = mode;
+    _queue->async([ctx, mode_str]() {
+        ctx->fp = File::create_file(ctx->path.data(), mode_str.data());
+        if (!ctx->fp) {
+            ctx->failed = true;
+            WarnL << "Create file failed," << ctx->path << " " << get_uv_errmsg();
+        }
+    });
+}
+
+AsyncFile::~AsyncFile() {
+    close();
+}
+
+const string &AsyncFile::path() const {
+    return _ctx->path;
+}
+
+bool AsyncFile::failed() const {
+    return _dropped || _ctx->failed;
+}
+
+void AsyncFile::write(const char *data, size_t len) {
+    if (_buf && _buf_offset + _buf->size() != _offset) {
+        // seek过，写位置不连续
+        submit();
+    }
+    while (len) {
+        if (!_buf) {
+            _buf = BufferRaw::create();
+            _buf->setCapacity(_buf_size);
+            _buf->setSize(0);
+            _buf_offset = _offset;
+            // 缓存边界按照文件偏移对齐，顺序写入时每次写盘都是对齐的整块
+            _buf_limit = _buf_size - _offset % _buf_size;
+        }
+        auto size = _buf->size();
+        auto n = MIN(len, _buf_limit - size);
+        memcpy(_buf->data() + size, data, n);
+        _buf->setSize(size + n);
+        data += n;
+        len -= n;
+        _offset += n;
+        if (_buf->size() == _buf_limit) {
+            submit();
+        }
+    }
+    _size = MAX(_size, _offset);
+}
+
+void AsyncFile::submit() {
+    if (!_buf) {
+        return;
+    }
+    BufferRaw::Ptr buf = std::move(_buf);
+    auto bytes = buf->size();
+    if (!bytes) {
+        return;
+    }
+    if (_dropped || !_queue->acquire(bytes)) {
+        // 丢弃该文件后续所有数据，避免写出错位的文件
+        DiskWriter::onDrop(bytes);
+        if (!_dropped) {
+            _dropped = true;
+            WarnL << "Disk write queue is full(" << _queue->getPendingBytes() << " bytes), drop the rest of file: " << path();
+        }
+        return;
+    }
+    _dirty = true;
+    auto ctx = _ctx;
+    auto queue = _queue;
+    auto offset = _buf_offset;
+    auto start = getCurrentMicrosecond();
+    _queue->async([ctx, queue, buf, offset, start]() {
+        auto bytes = buf->size();
+        if (ctx->fp && !ctx->failed && !writeAt(ctx->fp, offset, buf->data(), bytes)) {
+            ctx->failed = true;
+            WarnL << "Write file failed," << ctx->path << " " << get_uv_errmsg();
+        }
+        queue->release(bytes);
+        DiskWriter::onWrite(bytes, getCurrentMicrosecond() - start);
+    });
+}
+
+size_t AsyncFile::read(void *data, size_t len) {
+    submit();
+    if (_dirty) {
+        sync();
+    }
+    if (!_ctx->fp) {
+        return 0;
+    }
+    auto ret = readAt(_ctx->fp, _offset, (char *)data, len);
+    _offset += ret;
+    return ret;
+}
+
+bool AsyncFile::sync() {
+    submit();
+    auto promise = std::make_shared<std::promise<void> >();
+    auto future = promise->get_future();
+    _queue->async([promise]() { promise->set_value(); });
+    future.wait();
+    _dirty = false;
+    return !failed();
+}
+
+void AsyncFile::close(onClosed cb) {
+    if (_closed) {
+        return;
+    }
+    _closed = true;
+    submit();
+    auto ctx = _ctx;
+    auto dropped = _dropped;
+    _queue->async([ctx, dropped, cb]() {
+        if (ctx->fp) {
+            fclose(ctx->fp);
+            ctx->fp = nullptr;
+        }
+        if (cb) {
+            cb(!dropped && !ctx->failed);
+        }
+    });
+}
+
+} // namespace mediakit
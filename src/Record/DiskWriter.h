@@ -0,0 +1,220 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_DISKWRITER_H
+#define ZLMEDIAKIT_DISKWRITER_H
+
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include "Network/Buffer.h"
+
+namespace mediakit {
+
+class DiskWorker;
+
+/**
+ * 异步写盘线程池
+ * hls/mp4录制的文件操作在后台io线程执行，磁盘卡顿(nfs、raid繁忙等)时不会阻塞poller线程上的其他流
+ * record.asyncWriteThreads为0时在调用线程同步执行
+ */
+class DiskWriter {
+public:
+    ~DiskWriter();
+    static DiskWriter &Instance();
+
+    /**
+     * 轮流分配io线程，返回其下标
+     */
+    size_t getWorker();
+
+    /**
+     * 在指定io线程上按提交顺序执行任务
+     */
+    void async(size_t worker, std::function<void()> task);
+
+    /**
+     * 统计写入
+     * @param bytes 写入字节数
+     * @param cost_us 从提交到写入完毕的耗时，单位微秒
+     */
+    static void onWrite(size_t bytes, uint64_t cost_us);
+
+    /**
+     * 统计因队列已满丢弃的字节数
+     */
+    static void onDrop(size_t bytes);
+
+    /**
+     * 所有io线程等待执行的任务个数
+     */
+    static size_t getQueueDepth();
+
+    /**
+     * 所有写队列等待写盘的字节数
+     */
+    static uint64_t getPendingBytes();
+
+    /**
+     * 累计写盘与丢弃的字节数
+     */
+    static uint64_t getWriteBytes();
+    static uint64_t getDropBytes();
+
+    /**
+     * 平均与最大写盘延时(从提交到写入完毕)，单位微秒
+     */
+    static uint64_t getWriteLatencyUS();
+    static uint64_t getMaxWriteLatencyUS();
+
+private:
+    DiskWriter();
+
+private:
+    std::atomic<size_t> _index { 0 };
+    std::vector<std::shared_ptr<DiskWorker> > _workers;
+};
+
+/**
+ * 每路流一个写队列，队列内的文件操作在同一个io线程按顺序执行，
+ * 所以切片写完后才会写m3u8，文件创建后才会被删除
+ * 等待写盘的数据超过record.asyncWriteMaxMB时丢弃新的数据并告警
+ */
+class DiskWriteQueue : public std::enable_shared_from_this<DiskWriteQueue> {
+public:
+    using Ptr = std::shared_ptr<DiskWriteQueue>;
+
+    DiskWriteQueue();
+
+    /**
+     * 在io线程按顺序执行任务
+     */
+    void async(std::function<void()> task);
+
+    /**
+     * 异步覆盖写入整个文件
+     */
+    void writeFile(const std::string &path, std::string data);
+
+    /**
+     * 异步删除文件
+     * @param del_empty_dir 是否删除空的父目录
+     */
+    void deleteFile(const std::string &path, bool del_empty_dir = false);
+
+    /**
+     * 申请写盘额度，超过上限时返回false
+     */
+    bool acquire(size_t bytes);
+
+    /**
+     * 写盘完毕后归还额度，可以在任意线程调用
+     */
+    void release(size_t bytes);
+
+    /**
+     * 等待写盘的字节数
+     */
+    size_t getPendingBytes() const { return _pending_bytes; }
+
+private:
+    size_t _worker;
+    std::atomic<size_t> _pending_bytes { 0 };
+};
+
+/**
+ * 异步写入的文件，只能在一个线程使用
+ * 写入的数据先合并到写缓存，缓存写满(缓存边界按照文件偏移对齐)或写位置不连续时整块提交到io线程写盘，
+ * 文件的打开、写入与关闭都在io线程执行
+ */
+class AsyncFile : public toolkit::noncopyable {
+public:
+    using Ptr = std::shared_ptr<AsyncFile>;
+    using onClosed = std::function<void(bool success)>;
+
+    /**
+     * @param queue 写队列
+     * @param path 文件路径，父目录不存在时自动创建
+     * @param mode fopen的方式
+     * @param buf_size 写缓存大小
+     */
+    AsyncFile(DiskWriteQueue::Ptr queue, std::string path, const char *mode = "wb", size_t buf_size = 64 * 1024);
+
+    /**
+     * 提交剩余数据并在io线程关闭文件，不等待写盘完成
+     */
+    ~AsyncFile();
+
+    /**
+     * 在当前位置写入数据
+     */
+    void write(const char *data, size_t len);
+
+    /**
+     * 在当前位置读取数据，会等待已写入的数据全部写盘，用于mp4 faststart等回读场景
+     * @return 读取的字节数
+     */
+    size_t read(void *data, size_t len);
+
+    /**
+     * 设置与获取读写位置
+     */
+    void seek(uint64_t offset) { _offset = offset; }
+    uint64_t tell() const { return _offset; }
+
+    /**
+     * 已写入的文件大小(含未写盘的数据)
+     */
+    uint64_t size() const { return _size; }
+
+    /**
+     * 提交写缓存并等待全部写盘完成
+     * @return 是否全部写入成功
+     */
+    bool sync();
+
+    /**
+     * 提交剩余数据并在io线程关闭文件，之后不能再使用本对象
+     * @param cb 文件关闭后在io线程回调，参数为数据是否全部写入成功
+     */
+    void close(onClosed cb = nullptr);
+
+    /**
+     * 是否打开或写入失败，或者因为写队列已满丢弃了数据
+     */
+    bool failed() const;
+
+    const std::string &path() const;
+
+private:
+    void submit();
+
+private:
+    struct Context;
+
+    bool _dirty = false;
+    bool _dropped = false;
+    bool _closed = false;
+    size_t _buf_size;
+    size_t _buf_limit = 0;
+    uint64_t _offset = 0;
+    uint64_t _size = 0;
+    // 写缓存首字节在文件中的偏移
+    uint64_t _buf_offset = 0;
+    toolkit::BufferRaw::Ptr _buf;
+    std::shared_ptr<Context> _ctx;
+    DiskWriteQueue::Ptr _queue;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_DISKWRITER_H
@@ -27,7 +27,7 @@ HlsMaker::HlsMaker(bool is_fmp4, float seg_duration, uint32_t seg_number, bool s
 void HlsMaker::makeIndexFile(bool include_delay, bool eof) {
     GET_CONFIG(uint32_t, segDelay, Hls::kSegmentDelay);
     GET_CONFIG(uint32_t, segRetain, Hls::kSegmentRetain);
-    std::deque<std::tuple<int, std::string>> temp(_seg_dur_list);
+    std::deque<std::tuple<int, std::string, bool>> temp(_seg_dur_list);
     if (!include_delay && _seg_number) {
         while (temp.size() > _seg_number) {
             temp.pop_front();
@@ -76,6 +76,10 @@ void HlsMaker::makeIndexFile(bool include_delay, bool eof) {
 
     stringstream ss;
     for (auto &tp : temp) {
+        if (std::get<2>(tp)) {
+            // 写盘失败的切片已删除，保留占位以免改变后续切片的序号
+            ss << "#EXT-X-GAP\n";
+        }
         ss << "#EXTINF:" << std::setprecision(3) << std::get<0>(tp) / 1000.0 << ",\n" << std::get<1>(tp) << "\n";
     }
     index_str += ss.str();
@@ -86,6 +90,100 @@ void HlsMaker::makeIndexFile(bool include_delay, bool eof) {
     onWriteHls(index_str, include_delay);
 }
 
+void HlsMaker::makeLowLatencyIndexFile(uint64_t open_msn, bool eof) {
+    std::deque<std::tuple<int, std::string, bool>> temp(_seg_dur_list);
+    while (temp.size() > _seg_number) {
+        temp.pop_front();
+    }
+    // 目标时长不得小于任意切片时长
+    int maxSegmentDuration = _seg_duration * 1000;
+    for (auto &tp : temp) {
+        maxSegmentDuration = MAX(maxSegmentDuration, std::get<0>(tp));
+    }
+    // 切片序号即为切片文件的index，temp中为最近完成的连续切片
+    uint64_t first_msn = open_msn > temp.size() ? open_msn - temp.size() : 0;
+
+    stringstream ss;
+    ss << "#EXTM3U\n"
+       << "#EXT-X-VERSION:9\n"
+       << "#EXT-X-TARGETDURATION:" << (maxSegmentDuration + 999) / 1000 << "\n"
+       << "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=" << std::setprecision(3) << _part_duration * 3 << "\n"
+       << "#EXT-X-PART-INF:PART-TARGET=" << std::setprecision(3) << _part_duration << "\n"
+       << "#EXT-X-MEDIA-SEQUENCE:" << first_msn << "\n"
+       << "#EXT-X-MAP:URI=\"init.mp4\"\n";
+
+    auto it = _part_list.begin();
+    auto write_parts = [&](uint64_t msn) {
+        while (it != _part_list.end() && it->msn < msn) {
+            ++it;
+        }
+        for (; it != _part_list.end() && it->msn == msn; ++it) {
+            ss << "#EXT-X-PART:DURATION=" << std::setprecision(3) << it->duration / 1000.0 << ",URI=\"" << it->uri << "\"";
+            if (it->independent) {
+                ss << ",INDEPENDENT=YES";
+            }
+            ss << "\n";
+        }
+    };
+
+    auto msn = first_msn;
+    for (auto &tp : temp) {
+        write_parts(msn++);
+        if (std::get<2>(tp)) {
+            ss << "#EXT-X-GAP\n";
+        }
+        ss << "#EXTINF:" << std::setprecision(3) << std::get<0>(tp) / 1000.0 << ",\n" << std::get<1>(tp) << "\n";
+    }
+
+    if (eof) {
+        ss << "#EXT-X-ENDLIST\n";
+    } else {
+        // 当前切片已经生成的part
+        write_parts(open_msn);
+        uint32_t next_part = 0;
+        if (!_part_list.empty() && _part_list.back().msn == open_msn) {
+            next_part = _part_list.back().part + 1;
+        }
+        // 提示播放器提前请求下一个part，该请求将被挂起直到part生成
+        ss << "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"" << getPartUri(open_msn, next_part) << "\"\n";
+    }
+    onWriteLowLatencyHls(ss.str());
+}
+
+void HlsMaker::inputPart(const char *data, size_t len, uint64_t timestamp, bool is_idr_fast_packet) {
+    if (!_part_data.empty() && timestamp - _last_part_timestamp > _part_duration * 1000) {
+        // 加上本数据后part时长将超过目标时长，先输出之前的part
+        flushPart(true);
+    }
+    if (_part_data.empty()) {
+        // 以关键帧开始的part可以独立解码
+        _part_independent = is_idr_fast_packet;
+        _last_part_timestamp = _last_timestamp ? _last_timestamp : timestamp;
+    }
+    _part_data.append(data, len);
+    if (timestamp - _last_part_timestamp >= _part_duration * 1000) {
+        _last_timestamp = timestamp;
+        flushPart(true);
+    }
+}
+
+void HlsMaker::flushPart(bool make_index) {
+    if (_part_data.empty()) {
+        return;
+    }
+    auto msn = _file_index - 1;
+    int duration = _last_timestamp - _last_part_timestamp;
+    if (duration <= 0) {
+        duration = 1;
+    }
+    _part_list.emplace_back(PartInfo { msn, _part_index, duration, _part_independent, getPartUri(msn, _part_index) });
+    onWritePart(msn, _part_index++, std::move(_part_data));
+    _part_data.clear();
+    if (make_index) {
+        makeLowLatencyIndexFile(msn);
+    }
+}
+
 void HlsMaker::inputInitSegment(const char *data, size_t len) {
     if (!_is_fmp4) {
         throw std::invalid_argument("Only fmp4-hls can input init segment");
@@ -106,6 +204,9 @@ void HlsMaker::inputData(const char *data, size_t len, uint64_t timestamp, bool
         }
         if (!_last_file_name.empty()) {
             // 存在切片才写入ts数据
+            if (_part_duration > 0) {
+                inputPart(data, len, timestamp, is_idr_fast_packet);
+            }
             onWriteSegment(data, len);
             _last_timestamp = timestamp;
         }
@@ -146,6 +247,7 @@ void HlsMaker::addNewSegment(uint64_t stamp) {
     flushLastSegment(false);
     //新增切片
     _last_file_name = onOpenSegment(_file_index++);
+    _part_index = 0;
     //记录本次切片的起始时间戳
     _last_seg_timestamp = _last_timestamp ? _last_timestamp : stamp;
 }
@@ -156,21 +258,36 @@ void HlsMaker::flushLastSegment(bool eof){
         //不存在上个切片
         return;
     }
+    //切片的最后一个part
+    flushPart(false);
     //文件创建到最后一次数据写入的时间即为切片长度
     auto seg_dur = _last_timestamp - _last_seg_timestamp;
     if (seg_dur <= 0) {
         seg_dur = 100;
     }
-    _seg_dur_list.emplace_back(seg_dur, std::move(_last_file_name));
+    _seg_dur_list.emplace_back(seg_dur, std::move(_last_file_name), false);
     delOldSegment();
     //先flush ts切片，否则可能存在ts文件未写入完毕就被访问的情况
-    onFlushLastSegment(seg_dur);
+    if (!onFlushLastSegment(seg_dur)) {
+        std::get<2>(_seg_dur_list.back()) = true;
+    }
     //然后写m3u8文件
     makeIndexFile(false, eof);
     //写入切片延迟的m3u8文件
     if (segDelay) {
         makeIndexFile(true, eof);
     }
+    if (_part_duration > 0) {
+        //只保留最近几个切片的part
+        auto min_msn = _file_index > _part_window ? _file_index - _part_window : 0;
+        if (!_part_list.empty() && _part_list.front().msn < min_msn) {
+            while (!_part_list.empty() && _part_list.front().msn < min_msn) {
+                _part_list.pop_front();
+            }
+            onDelPart(min_msn);
+        }
+        makeLowLatencyIndexFile(_file_index, eof);
+    }
 }
 
 bool HlsMaker::isLive() const {
@@ -185,12 +302,29 @@ bool HlsMaker::isFmp4() const {
     return _is_fmp4;
 }
 
+void HlsMaker::enableLowLatency(float part_duration, uint32_t part_window) {
+    if (!_is_fmp4 || !isLive() || part_duration <= 0) {
+        // LL-HLS只支持fmp4直播
+        return;
+    }
+    _part_duration = part_duration;
+    _part_window = MAX(part_window, 1U);
+}
+
+bool HlsMaker::isLowLatency() const {
+    return _part_duration > 0;
+}
+
 void HlsMaker::clear() {
     _file_index = 0;
     _last_timestamp = 0;
     _last_seg_timestamp = 0;
     _seg_dur_list.clear();
     _last_file_name.clear();
+    _part_index = 0;
+    _last_part_timestamp = 0;
+    _part_data.clear();
+    _part_list.clear();
 }
 
 }//namespace mediakit
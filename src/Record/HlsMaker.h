@@ -60,6 +60,19 @@ public:
      */
     bool isFmp4() const;
 
+    /**
+     * 开启LL-HLS(低延迟hls)，仅fmp4直播有效
+     * 开启后每个切片再细分为多个part，并生成包含EXT-X-PART与EXT-X-PRELOAD-HINT的m3u8
+     * @param part_duration part目标时长，单位秒
+     * @param part_window m3u8中保留part的切片个数
+     */
+    void enableLowLatency(float part_duration, uint32_t part_window);
+
+    /**
+     * 是否开启了LL-HLS
+     */
+    bool isLowLatency() const;
+
     /**
      * 清空记录
      */
@@ -98,11 +111,38 @@ protected:
      */
     virtual void onWriteHls(const std::string &data, bool include_delay) = 0;
 
+    /**
+     * 获取LL-HLS part在m3u8中的uri
+     * @param msn part所属切片序号
+     * @param part part在切片中的序号
+     */
+    virtual std::string getPartUri(uint64_t msn, uint32_t part) { return ""; };
+
+    /**
+     * 写LL-HLS part回调，part数据只保存在内存
+     * @param msn part所属切片序号
+     * @param part part在切片中的序号
+     * @param data part数据(若干个完整的moof+mdat)
+     */
+    virtual void onWritePart(uint64_t msn, uint32_t part, std::string data) {};
+
+    /**
+     * 删除序号小于msn的切片的所有part
+     */
+    virtual void onDelPart(uint64_t msn) {};
+
+    /**
+     * 写LL-HLS m3u8回调，只更新内存中的索引
+     * @param data m3u8内容
+     */
+    virtual void onWriteLowLatencyHls(const std::string &data) {};
+
     /**
      * 上一个 ts 切片写入完成, 可在这里进行通知处理
      * @param duration_ms 上一个 ts 切片的时长, 单位为毫秒
+     * @return 切片数据是否完整，不完整时该切片在m3u8中标记为EXT-X-GAP，播放器不会请求
      */
-    virtual void onFlushLastSegment(uint64_t duration_ms) {};
+    virtual bool onFlushLastSegment(uint64_t duration_ms) { return true; };
 
     /**
      * 关闭上个ts切片并且写入m3u8索引
@@ -117,6 +157,23 @@ private:
      */
     void makeIndexFile(bool include_delay, bool eof = false);
 
+    /**
+     * 生成LL-HLS m3u8
+     * @param open_msn 当前正在生成(尚未完成)的切片序号
+     */
+    void makeLowLatencyIndexFile(uint64_t open_msn, bool eof = false);
+
+    /**
+     * 写入LL-HLS part数据，时长达到part目标时长后输出part
+     */
+    void inputPart(const char *data, size_t len, uint64_t timestamp, bool is_idr_fast_packet);
+
+    /**
+     * 输出当前part
+     * @param make_index 是否立即更新m3u8
+     */
+    void flushPart(bool make_index);
+
     /**
      * 删除旧的ts切片
      */
@@ -137,7 +194,23 @@ private:
     uint64_t _last_seg_timestamp = 0;
     uint64_t _file_index = 0;
     std::string _last_file_name;
-    std::deque<std::tuple<int,std::string> > _seg_dur_list;
+    // 切片时长、文件名、是否缺失
+    std::deque<std::tuple<int, std::string, bool> > _seg_dur_list;
+
+    struct PartInfo {
+        uint64_t msn;
+        uint32_t part;
+        int duration;
+        bool independent;
+        std::string uri;
+    };
+    float _part_duration = 0;
+    uint32_t _part_window = 0;
+    uint32_t _part_index = 0;
+    bool _part_independent = false;
+    uint64_t _last_part_timestamp = 0;
+    std::string _part_data;
+    std::deque<PartInfo> _part_list;
 };
 
 }//namespace mediakit
@@ -12,7 +12,6 @@
 #include <sys/stat.h>
 #include "HlsMakerImp.h"
 #include "Util/util.h"
-#include "Util/uv_errno.h"
 #include "Util/File.h"
 #include "Common/config.h"
 
@@ -35,10 +34,16 @@ HlsMakerImp::HlsMakerImp(bool is_fmp4, const string &m3u8_file, const string &pa
     _path_prefix = m3u8_file.substr(0, m3u8_file.rfind('/'));
     _path_hls = m3u8_file;
     _path_hls_delay = getDelayPath(m3u8_file);
+    _name_hls_delay = _path_hls_delay.substr(_path_hls_delay.rfind('/') + 1);
     _params = params;
     _buf_size = bufSize;
-    _file_buf.reset(new char[bufSize], [](char *ptr) { delete[] ptr; });
+    _disk_queue = std::make_shared<DiskWriteQueue>();
     _info.folder = _path_prefix;
+
+    GET_CONFIG(bool, memoryMode, Hls::kMemoryMode);
+    // 点播录制或保留切片时仍然需要落盘
+    _in_memory = memoryMode && isLive() && !isKeep();
+    _seg_number = seg_number;
 }
 
 HlsMakerImp::~HlsMakerImp() {
@@ -68,7 +73,19 @@ void HlsMakerImp::clearCache(bool immediately, bool eof) {
         return;
     }
 
-    {
+    if (_in_memory) {
+        // 内存切片与延时m3u8随HlsMediaSource释放；正在下载的切片由http连接持有，无需延时删除
+        if (_media_src) {
+            if (eof) {
+                _media_src->clearSegment();
+            } else {
+                for (auto &pr : _segment_file_paths) {
+                    _media_src->delSegment(pr.second);
+                }
+                _media_src->delSegment(_name_hls_delay);
+            }
+        }
+    } else {
         std::list<std::string> lst;
         lst.emplace_back(_path_hls);
         lst.emplace_back(_path_hls_delay);
@@ -79,13 +96,14 @@ void HlsMakerImp::clearCache(bool immediately, bool eof) {
             lst.emplace_back(std::move(pr.second));
         }
 
-        // hls直播才删除文件
+        // hls直播才删除文件，删除操作排在本流的写盘操作之后
         GET_CONFIG(uint32_t, delay, Hls::kDeleteDelaySec);
+        auto queue = _disk_queue;
         if (!delay || immediately) {
-            clearHls(lst);
+            queue->async([lst]() { clearHls(lst); });
         } else {
-            _poller->doDelayTask(delay * 1000, [lst]() {
-                clearHls(lst);
+            _poller->doDelayTask(delay * 1000, [lst, queue]() {
+                queue->async([lst]() { clearHls(lst); });
                 return 0;
             });
         }
@@ -94,11 +112,21 @@ void HlsMakerImp::clearCache(bool immediately, bool eof) {
     clear();
     _file = nullptr;
     _segment_file_paths.clear();
+    if (_media_src) {
+        _media_src->delPart(UINT64_MAX);
+    }
 }
 
 string HlsMakerImp::onOpenSegment(uint64_t index) {
     string segment_name, segment_path;
-    {
+    if (_in_memory) {
+        // 内存切片不需要按时间分目录
+        segment_name = to_string(index) + (isFmp4() ? ".mp4" : ".ts");
+        segment_path = _path_prefix + "/" + segment_name;
+        _segment_file_paths.emplace(index, segment_name);
+        _segment_buf.clear();
+        _file = nullptr;
+    } else {
         auto strDate = getTimeStr("%Y-%m-%d");
         auto strHour = getTimeStr("%H");
         auto strTime = getTimeStr("%M-%S");
@@ -107,8 +135,8 @@ string HlsMakerImp::onOpenSegment(uint64_t index) {
         if (isLive()) {
             _segment_file_paths.emplace(index, segment_path);
         }
+        _file = std::make_shared<AsyncFile>(_disk_queue, segment_path, "wb", _buf_size);
     }
-    _file = makeFile(segment_path, true);
 
     // 保存本切片的元数据
     _info.start_time = ::time(NULL);
@@ -116,9 +144,6 @@ string HlsMakerImp::onOpenSegment(uint64_t index) {
     _info.file_path = segment_path;
     _info.url = _info.app + "/" + _info.stream + "/" + segment_name;
 
-    if (!_file) {
-        WarnL << "Create file failed," << segment_path << " " << get_uv_errmsg();
-    }
     if (_params.empty()) {
         return segment_name;
     }
@@ -130,26 +155,30 @@ void HlsMakerImp::onDelSegment(uint64_t index) {
     if (it == _segment_file_paths.end()) {
         return;
     }
-    File::delete_file(it->second.data(), true);
+    if (!_in_memory) {
+        _disk_queue->deleteFile(it->second, true);
+    } else if (_media_src) {
+        _media_src->delSegment(it->second);
+    }
     _segment_file_paths.erase(it);
 }
 
 void HlsMakerImp::onWriteInitSegment(const char *data, size_t len) {
-    string init_seg_path = _path_prefix + "/init.mp4";
-    _file = makeFile(init_seg_path);
-
-    if (_file) {
-        fwrite(data, len, 1, _file.get());
-        _path_init = std::move(init_seg_path);
-        _file = nullptr;
-    } else {
-        WarnL << "Create file failed," << init_seg_path << " " << get_uv_errmsg();
+    if (_in_memory) {
+        if (_media_src) {
+            _media_src->addSegment("init.mp4", std::make_shared<BufferString>(string(data, len)));
+        }
+        return;
     }
+    _path_init = _path_prefix + "/init.mp4";
+    _disk_queue->writeFile(_path_init, string(data, len));
 }
 
 void HlsMakerImp::onWriteSegment(const char *data, size_t len) {
-    if (_file) {
-        fwrite(data, len, 1, _file.get());
+    if (_in_memory) {
+        _segment_buf.append(data, len);
+    } else if (_file) {
+        _file->write(data, len);
     }
     if (_media_src) {
         _media_src->onSegmentSize(len);
@@ -157,42 +186,145 @@ void HlsMakerImp::onWriteSegment(const char *data, size_t len) {
 }
 
 void HlsMakerImp::onWriteHls(const std::string &data, bool include_delay) {
-    auto path = include_delay ? _path_hls_delay : _path_hls;
-    auto hls = makeFile(path);
-    if (hls) {
-        fwrite(data.data(), data.size(), 1, hls.get());
-        hls.reset();
-        if (_media_src && !include_delay) {
+    if (_in_memory) {
+        // m3u8只保存在内存中，由http服务器通过cookie绑定的HlsMediaSource回复；
+        // 延时m3u8与切片一样按文件名保存，由http服务器直接从内存回复
+        if (!_media_src) {
+            return;
+        }
+        if (include_delay) {
+            _media_src->addSegment(_name_hls_delay, std::make_shared<BufferString>(data));
+            return;
+        }
+        if (!isLowLatency()) {
             _media_src->setIndexFile(data);
         }
-    } else {
-        WarnL << "Create hls file failed," << path << " " << get_uv_errmsg();
+        // m3u8已经更新，移出m3u8的切片才可以被淘汰
+        updateSegmentState();
+        trimMemory();
+        return;
+    }
+    // 排在切片写盘之后，避免m3u8中出现未写完的切片
+    _disk_queue->writeFile(include_delay ? _path_hls_delay : _path_hls, data);
+    if (_media_src && !include_delay && !isLowLatency()) {
+        // LL-HLS时内存中的m3u8由onWriteLowLatencyHls更新；
+        // 内存中的m3u8需等切片与m3u8写盘完毕后再更新，否则播放器可能请求到尚未写盘的切片而404
+        std::weak_ptr<HlsMediaSource> weak_src = _media_src;
+        auto poller = _poller;
+        _disk_queue->async([weak_src, poller, data]() {
+            poller->async([weak_src, data]() {
+                if (auto src = weak_src.lock()) {
+                    src->setIndexFile(data);
+                }
+            }, false);
+        });
     }
 }
 
-void HlsMakerImp::onFlushLastSegment(uint64_t duration_ms) {
-    // 关闭并flush文件到磁盘
-    _file = nullptr;
+bool HlsMakerImp::onFlushLastSegment(uint64_t duration_ms) {
+    auto file = std::move(_file);
+    size_t mem_size = 0;
+    if (_in_memory && _media_src && !_segment_file_paths.empty()) {
+        // 切片生成完毕才加入内存，之后才会出现在m3u8中
+        mem_size = _segment_buf.size();
+        _media_src->addSegment(_segment_file_paths.rbegin()->second, std::make_shared<BufferLikeString>(std::move(_segment_buf)));
+        _segment_buf = BufferLikeString();
+    }
+    if (_media_src && isLowLatency()) {
+        // 该切片的最后一个part已经输出
+        _media_src->completeSegment(_last_part_msn);
+    }
+
+    if (file && file->failed()) {
+        // 写队列已满丢弃了部分数据，与mp4录制一样删除不完整的切片，m3u8中不再引用该切片
+        WarnL << "Write hls segment failed, delete it: " << file->path();
+        file->close();
+        _disk_queue->deleteFile(file->path());
+        return false;
+    }
 
     GET_CONFIG(bool, broadcastRecordTs, Hls::kBroadcastRecordTs);
-    if (broadcastRecordTs) {
-        _info.time_len = duration_ms / 1000.0f;
-        _info.file_size = File::fileSize(_info.file_path.data());
+    if (!broadcastRecordTs) {
+        if (file) {
+            // 在io线程写完剩余数据后关闭文件
+            file->close();
+        }
+        return true;
+    }
+    _info.time_len = duration_ms / 1000.0f;
+    if (!file) {
+        _info.file_size = mem_size;
         NOTICE_EMIT(BroadcastRecordTsArgs, Broadcast::kBroadcastRecordTs, _info);
+        return true;
     }
+    _info.file_size = file->size();
+    // 切片写盘完毕后切回事件线程广播，不阻塞写盘线程
+    auto info = _info;
+    auto poller = _poller;
+    file->close([info, poller](bool success) {
+        if (!success) {
+            return;
+        }
+        poller->async([info]() mutable {
+            NOTICE_EMIT(BroadcastRecordTsArgs, Broadcast::kBroadcastRecordTs, info);
+        }, false);
+    });
+    return true;
 }
 
-std::shared_ptr<FILE> HlsMakerImp::makeFile(const string &file, bool setbuf) {
-    auto file_buf = _file_buf;
-    auto ret = shared_ptr<FILE>(File::create_file(file.data(), "wb"), [file_buf](FILE *fp) {
-        if (fp) {
-            fclose(fp);
+void HlsMakerImp::updateSegmentState() {
+    GET_CONFIG(uint32_t, segDelay, Hls::kSegmentDelay);
+    // 从新到旧遍历，多保留一个切片给上一版本的m3u8(LL-HLS的m3u8可能还未更新)
+    size_t n = 0;
+    for (auto it = _segment_file_paths.rbegin(); it != _segment_file_paths.rend(); ++it, ++n) {
+        HlsMediaSource::SegmentState state;
+        if (n <= _seg_number) {
+            state = HlsMediaSource::kSegmentListed;
+        } else if (n <= _seg_number + segDelay) {
+            state = HlsMediaSource::kSegmentDelayed;
+        } else {
+            state = HlsMediaSource::kSegmentRetained;
         }
-    });
-    if (ret && setbuf) {
-        setvbuf(ret.get(), _file_buf.get(), _IOFBF, _buf_size);
+        _media_src->setSegmentState(it->second, state);
+    }
+}
+
+void HlsMakerImp::trimMemory() {
+    GET_CONFIG(uint32_t, memoryBudget, Hls::kMemoryBudget);
+    if (!memoryBudget) {
+        return;
+    }
+    // 在所有流中淘汰未被直播m3u8引用的切片，直播m3u8中的切片不淘汰
+    auto max_bytes = memoryBudget * 1024ULL * 1024;
+    auto bytes = HlsMediaSource::trimSegmentMemory(max_bytes);
+    if (bytes > max_bytes) {
+        WarnL << "Hls memory usage exceeds budget(" << memoryBudget << "MB) by segments still in m3u8: " << bytes << " bytes";
+    }
+}
+
+string HlsMakerImp::getPartUri(uint64_t msn, uint32_t part) {
+    auto name = HlsMediaSource::getPartName(msn, part);
+    return _params.empty() ? name : name + "?" + _params;
+}
+
+void HlsMakerImp::onWritePart(uint64_t msn, uint32_t part, std::string data) {
+    _last_part_msn = msn;
+    if (_media_src) {
+        _media_src->addPart(msn, part, std::make_shared<BufferString>(std::move(data)));
+    }
+}
+
+void HlsMakerImp::onDelPart(uint64_t msn) {
+    if (_media_src) {
+        _media_src->delPart(msn);
+    }
+}
+
+void HlsMakerImp::onWriteLowLatencyHls(const std::string &data) {
+    // LL-HLS的m3u8每个part都会更新，只保存在内存中
+    if (_media_src) {
+        _media_src->setIndexFile(data);
     }
-    return ret;
 }
 
 void HlsMakerImp::setMediaSource(const MediaTuple& tuple) {
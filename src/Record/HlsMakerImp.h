@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include "HlsMaker.h"
 #include "HlsMediaSource.h"
+#include "DiskWriter.h"
 
 namespace mediakit {
 
@@ -47,24 +48,38 @@ protected:
     void onWriteInitSegment(const char *data, size_t len) override;
     void onWriteSegment(const char *data, size_t len) override;
     void onWriteHls(const std::string &data, bool include_delay) override;
-    void onFlushLastSegment(uint64_t duration_ms) override;
+    bool onFlushLastSegment(uint64_t duration_ms) override;
+    std::string getPartUri(uint64_t msn, uint32_t part) override;
+    void onWritePart(uint64_t msn, uint32_t part, std::string data) override;
+    void onDelPart(uint64_t msn) override;
+    void onWriteLowLatencyHls(const std::string &data) override;
 
 private:
-    std::shared_ptr<FILE> makeFile(const std::string &file,bool setbuf = false);
     void clearCache(bool immediately, bool eof);
+    void updateSegmentState();
+    void trimMemory();
 
 private:
     int _buf_size;
     std::string _params;
     std::string _path_hls;
     std::string _path_hls_delay;
+    // 内存hls模式下延时m3u8的文件名
+    std::string _name_hls_delay;
     std::string _path_init;
     std::string _path_prefix;
+    uint64_t _last_part_msn = 0;
+    // 内存hls模式，直播切片只保存在HlsMediaSource中
+    bool _in_memory = false;
+    uint32_t _seg_number = 0;
+    toolkit::BufferLikeString _segment_buf;
     RecordInfo _info;
-    std::shared_ptr<FILE> _file;
-    std::shared_ptr<char> _file_buf;
+    AsyncFile::Ptr _file;
+    // 本流所有文件操作在同一个io线程按顺序执行
+    DiskWriteQueue::Ptr _disk_queue;
     HlsMediaSource::Ptr _media_src;
     toolkit::EventPoller::Ptr _poller;
+    // 内存hls模式下保存的是切片文件名
     std::map<uint64_t/*index*/,std::string/*file_path*/> _segment_file_paths;
 };
 
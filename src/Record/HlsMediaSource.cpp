@@ -8,6 +8,9 @@
  * may be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
 #include "HlsMediaSource.h"
 #include "Common/config.h"
 
@@ -15,6 +18,14 @@ using namespace toolkit;
 
 namespace mediakit {
 
+// 本进程所有内存hls切片占用的字节数
+static std::atomic<size_t> s_segment_bytes { 0 };
+// 内存hls切片的加入序号
+static std::atomic<uint64_t> s_segment_seq { 0 };
+// 所有HlsMediaSource，用于全局淘汰内存hls切片
+static std::mutex s_mtx_sources;
+static std::unordered_set<HlsMediaSource *> s_sources;
+
 HlsCookieData::HlsCookieData(const MediaInfo &info, const std::shared_ptr<SockInfo> &sock_info) {
     _info = info;
     _sock_info = sock_info;
@@ -91,13 +102,229 @@ void HlsMediaSource::setIndexFile(std::string index_file)
     }
 
     //赋值m3u8索引文件内容
-    std::lock_guard<std::mutex> lck(_mtx_index);
+    std::unique_lock<std::mutex> lck(_mtx_index);
     _index_file = std::move(index_file);
 
     if (!_index_file.empty()) {
         _list_cb.for_each([&](const std::function<void(const std::string& str)>& cb) { cb(_index_file); });
         _list_cb.clear();
     }
+
+    if (_part_waiters.empty()) {
+        return;
+    }
+    // m3u8已经包含等待的part，在锁外回复挂起的请求
+    std::list<std::shared_ptr<std::function<void(bool)>>> ready_list;
+    for (auto it = _part_waiters.begin(); it != _part_waiters.end();) {
+        if (_index_file.empty() || !isPartReady_l(it->first.first, it->first.second)) {
+            ++it;
+            continue;
+        }
+        ready_list.emplace_back(std::move(it->second));
+        it = _part_waiters.erase(it);
+    }
+    lck.unlock();
+    for (auto &cb : ready_list) {
+        (*cb)(true);
+    }
+}
+
+std::string HlsMediaSource::getPartName(uint64_t msn, uint32_t part) {
+    return std::to_string(msn) + "_" + std::to_string(part) + ".m4s";
+}
+
+bool HlsMediaSource::parsePartName(const std::string &name, uint64_t &msn, uint32_t &part) {
+    unsigned long long msn_l = 0;
+    unsigned int part_l = 0;
+    char suffix[8] = { 0 };
+    if (3 != sscanf(name.data(), "%llu_%u.%4s", &msn_l, &part_l, suffix) || strcmp(suffix, "m4s")) {
+        return false;
+    }
+    msn = msn_l;
+    part = part_l;
+    return true;
+}
+
+void HlsMediaSource::addPart(uint64_t msn, uint32_t part, Buffer::Ptr data) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    _have_part = true;
+    _last_msn = msn;
+    _last_part = part;
+    _parts[std::make_pair(msn, part)] = std::move(data);
+}
+
+void HlsMediaSource::completeSegment(uint64_t msn) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    _complete_msn = MAX(_complete_msn, msn + 1);
+}
+
+void HlsMediaSource::delPart(uint64_t msn) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    _parts.erase(_parts.begin(), _parts.lower_bound(std::make_pair(msn, 0U)));
+    if (_parts.empty()) {
+        // 清空缓存时，重新开始计数
+        _have_part = false;
+        _complete_msn = 0;
+    }
+}
+
+Buffer::Ptr HlsMediaSource::getPart(uint64_t msn, uint32_t part) const {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    auto it = _parts.find(std::make_pair(msn, part));
+    return it == _parts.end() ? nullptr : it->second;
+}
+
+bool HlsMediaSource::isPartReady(uint64_t msn, int64_t part) const {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    return isPartReady_l(msn, part);
+}
+
+bool HlsMediaSource::isPartReady_l(uint64_t msn, int64_t part) const {
+    if (!_have_part) {
+        return false;
+    }
+    if (part < 0) {
+        return msn < _complete_msn;
+    }
+    return msn < _last_msn || (msn == _last_msn && part <= _last_part);
+}
+
+void HlsMediaSource::waitPart(uint64_t msn, int64_t part, uint64_t timeout_ms, std::function<void(bool ready)> cb) {
+    std::unique_lock<std::mutex> lck(_mtx_index);
+    if (!_index_file.empty() && isPartReady_l(msn, part)) {
+        lck.unlock();
+        cb(true);
+        return;
+    }
+    // 保证只回调一次
+    auto called = std::make_shared<std::atomic_flag>();
+    called->clear();
+    auto waiter = std::make_shared<std::function<void(bool)>>([cb, called](bool ready) {
+        if (!called->test_and_set()) {
+            cb(ready);
+        }
+    });
+    _part_waiters.emplace(std::make_pair(msn, part), waiter);
+    lck.unlock();
+
+    std::weak_ptr<std::function<void(bool)>> weak_waiter = waiter;
+    std::weak_ptr<HlsMediaSource> weak_self = std::static_pointer_cast<HlsMediaSource>(shared_from_this());
+    EventPollerPool::Instance().getPoller()->doDelayTask(timeout_ms, [weak_self, weak_waiter]() {
+        auto waiter = weak_waiter.lock();
+        if (!waiter) {
+            // 已经回复
+            return 0;
+        }
+        if (auto strong_self = weak_self.lock()) {
+            std::lock_guard<std::mutex> lck(strong_self->_mtx_index);
+            for (auto it = strong_self->_part_waiters.begin(); it != strong_self->_part_waiters.end(); ++it) {
+                if (it->second == waiter) {
+                    strong_self->_part_waiters.erase(it);
+                    break;
+                }
+            }
+        }
+        (*waiter)(false);
+        return 0;
+    });
+}
+
+HlsMediaSource::HlsMediaSource(const std::string &schema, const MediaTuple &tuple) : MediaSource(schema, tuple) {
+    std::lock_guard<std::mutex> lck(s_mtx_sources);
+    s_sources.emplace(this);
+}
+
+HlsMediaSource::~HlsMediaSource() {
+    {
+        // 等待正在进行的全局淘汰结束
+        std::lock_guard<std::mutex> lck(s_mtx_sources);
+        s_sources.erase(this);
+    }
+    s_segment_bytes -= _segment_bytes;
+}
+
+void HlsMediaSource::addSegment(const std::string &name, Buffer::Ptr data) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    auto &seg = _segments[name];
+    if (seg.data) {
+        _segment_bytes -= seg.data->size();
+        s_segment_bytes -= seg.data->size();
+    }
+    _segment_bytes += data->size();
+    s_segment_bytes += data->size();
+    seg.data = std::move(data);
+    seg.seq = ++s_segment_seq;
+    seg.state = kSegmentListed;
+}
+
+void HlsMediaSource::setSegmentState(const std::string &name, SegmentState state) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    auto it = _segments.find(name);
+    if (it != _segments.end()) {
+        it->second.state = state;
+    }
+}
+
+void HlsMediaSource::delSegment(const std::string &name) {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    auto it = _segments.find(name);
+    if (it == _segments.end()) {
+        return;
+    }
+    // 正在发送的切片由http连接持有，发送完毕后释放
+    _segment_bytes -= it->second.data->size();
+    s_segment_bytes -= it->second.data->size();
+    _segments.erase(it);
+}
+
+void HlsMediaSource::clearSegment() {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    s_segment_bytes -= _segment_bytes;
+    _segment_bytes = 0;
+    _segments.clear();
+}
+
+Buffer::Ptr HlsMediaSource::getSegment(const std::string &name) const {
+    std::lock_guard<std::mutex> lck(_mtx_index);
+    auto it = _segments.find(name);
+    return it == _segments.end() ? nullptr : it->second.data;
+}
+
+size_t HlsMediaSource::trimSegmentMemory(size_t max_bytes) {
+    if (s_segment_bytes <= max_bytes) {
+        return s_segment_bytes;
+    }
+    struct Candidate {
+        SegmentState state;
+        uint64_t seq;
+        HlsMediaSource *src;
+        std::string name;
+    };
+    std::vector<Candidate> candidates;
+    std::lock_guard<std::mutex> lck(s_mtx_sources);
+    for (auto src : s_sources) {
+        std::lock_guard<std::mutex> lck_src(src->_mtx_index);
+        for (auto &pr : src->_segments) {
+            if (pr.second.state != kSegmentListed) {
+                candidates.emplace_back(Candidate { pr.second.state, pr.second.seq, src, pr.first });
+            }
+        }
+    }
+    // 先淘汰已经移出所有m3u8的切片，再淘汰只在延时m3u8中的切片，同一状态下先淘汰旧的
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.state != b.state ? a.state < b.state : a.seq < b.seq;
+    });
+    for (auto &candidate : candidates) {
+        if (s_segment_bytes <= max_bytes) {
+            break;
+        }
+        candidate.src->delSegment(candidate.name);
+    }
+    return s_segment_bytes;
+}
+
+size_t HlsMediaSource::getSegmentMemory() {
+    return s_segment_bytes.load();
 }
 
 void HlsMediaSource::getIndexFile(std::function<void(const std::string& str)> cb)
@@ -14,6 +14,8 @@
 #include "Common/MediaSource.h"
 #include "Util/TimeTicker.h"
 #include "Util/RingBuffer.h"
+#include <map>
+#include <unordered_map>
 #include <atomic>
 
 namespace mediakit {
@@ -25,7 +27,20 @@ public:
     using RingType = toolkit::RingBuffer<std::string>;
     using Ptr = std::shared_ptr<HlsMediaSource>;
 
-    HlsMediaSource(const std::string &schema, const MediaTuple &tuple) : MediaSource(schema, tuple) {}
+    /**
+     * 内存hls切片的引用状态，内存超限时按状态和新旧淘汰
+     */
+    enum SegmentState {
+        // 已经移出所有m3u8，只是为了正在下载的播放器而保留，最先淘汰
+        kSegmentRetained = 0,
+        // 已经移出直播m3u8，只在延时m3u8中
+        kSegmentDelayed = 1,
+        // 在直播m3u8中(以及init.mp4、延时m3u8文件本身)，不能淘汰
+        kSegmentListed = 2
+    };
+
+    HlsMediaSource(const std::string &schema, const MediaTuple &tuple);
+    ~HlsMediaSource() override;
 
     /**
      * 	获取媒体源的环形缓冲
@@ -57,16 +72,124 @@ public:
 
     void onSegmentSize(size_t bytes) { _speed[TrackVideo] += bytes; }
 
+    /**
+     * 获取LL-HLS part文件名
+     */
+    static std::string getPartName(uint64_t msn, uint32_t part);
+
+    /**
+     * 解析LL-HLS part文件名
+     * @return 是否为part文件名
+     */
+    static bool parsePartName(const std::string &name, uint64_t &msn, uint32_t &part);
+
+    /**
+     * 添加LL-HLS part，part只保存在内存中
+     * 需要在其后调用setIndexFile更新m3u8，等待该part的请求将在m3u8更新后回复
+     */
+    void addPart(uint64_t msn, uint32_t part, toolkit::Buffer::Ptr data);
+
+    /**
+     * 切片的所有part已经生成完毕
+     */
+    void completeSegment(uint64_t msn);
+
+    /**
+     * 删除序号小于msn的切片的所有part
+     */
+    void delPart(uint64_t msn);
+
+    /**
+     * 获取LL-HLS part
+     * @return part不存在时返回空
+     */
+    toolkit::Buffer::Ptr getPart(uint64_t msn, uint32_t part) const;
+
+    /**
+     * LL-HLS part是否已经生成(或者已经过期删除)
+     * @param part 为-1时判断整个切片是否生成完毕
+     */
+    bool isPartReady(uint64_t msn, int64_t part) const;
+
+    /**
+     * 等待LL-HLS part生成，用于阻塞式m3u8刷新(_HLS_msn/_HLS_part)与预加载提示
+     * @param part 为-1时等待整个切片生成完毕
+     * @param timeout_ms 超时时间，超时后回调false
+     * @param cb 回调，可能在其他线程触发
+     */
+    void waitPart(uint64_t msn, int64_t part, uint64_t timeout_ms, std::function<void(bool ready)> cb);
+
+    /**
+     * 添加内存hls切片(或fmp4 init切片)，切片不落盘，由http服务器直接从内存回复
+     * 新加入的切片状态为kSegmentListed
+     * @param name 切片文件名(相对于m3u8所在目录)
+     */
+    void addSegment(const std::string &name, toolkit::Buffer::Ptr data);
+
+    /**
+     * 更新内存hls切片的引用状态，切片移出直播m3u8后才能被淘汰
+     */
+    void setSegmentState(const std::string &name, SegmentState state);
+
+    /**
+     * 删除内存hls切片
+     */
+    void delSegment(const std::string &name);
+
+    /**
+     * 清空所有内存hls切片
+     */
+    void clearSegment();
+
+    /**
+     * 获取内存hls切片
+     * @return 切片不存在时返回空
+     */
+    toolkit::Buffer::Ptr getSegment(const std::string &name) const;
+
+    /**
+     * 获取本进程所有内存hls切片占用的字节数
+     */
+    static size_t getSegmentMemory();
+
+    /**
+     * 本进程所有内存hls切片超过上限时，在所有流中按状态从旧到新淘汰未被直播m3u8引用的切片
+     * @param max_bytes 内存上限
+     * @return 淘汰后所有内存hls切片占用的字节数，仍然超过上限时说明直播m3u8中的切片已经超限
+     */
+    static size_t trimSegmentMemory(size_t max_bytes);
+
     void getPlayerList(const std::function<void(const std::list<toolkit::Any> &info_list)> &cb,
                        const std::function<toolkit::Any(toolkit::Any &&info)> &on_change) override {
         _ring->getInfoList(cb, on_change);
     }
 
+private:
+    bool isPartReady_l(uint64_t msn, int64_t part) const;
+
 private:
     RingType::Ptr _ring;
     std::string _index_file;
     mutable std::mutex _mtx_index;
     toolkit::List<std::function<void(const std::string &)>> _list_cb;
+
+    // 最新生成的part序号，以及序号小于_complete_msn的切片已经生成完毕
+    bool _have_part = false;
+    uint64_t _last_msn = 0;
+    uint32_t _last_part = 0;
+    uint64_t _complete_msn = 0;
+    std::map<std::pair<uint64_t, uint32_t>, toolkit::Buffer::Ptr> _parts;
+    std::multimap<std::pair<uint64_t, int64_t>, std::shared_ptr<std::function<void(bool)>>> _part_waiters;
+
+    // 内存hls切片
+    struct Segment {
+        toolkit::Buffer::Ptr data;
+        // 本进程内的加入顺序，用于全局按新旧淘汰
+        uint64_t seq = 0;
+        SegmentState state = kSegmentListed;
+    };
+    size_t _segment_bytes = 0;
+    std::unordered_map<std::string, Segment> _segments;
 };
 
 class HlsCookieData {
@@ -29,6 +29,11 @@ public:
 
         _option = option;
         _hls = std::make_shared<HlsMakerImp>(is_fmp4, m3u8_file, params, hlsBufSize, hlsDuration, hlsNum, hlsKeep);
+        if (is_fmp4) {
+            GET_CONFIG(float, hlsPartDuration, Hls::kPartDuration);
+            GET_CONFIG(uint32_t, hlsPartWindow, Hls::kPartWindow);
+            _hls->enableLowLatency(hlsPartDuration, hlsPartWindow);
+        }
         // 清空上次的残余文件
         _hls->clearCache();
     }
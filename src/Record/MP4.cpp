@@ -80,14 +80,19 @@ MP4FileIO::Reader MP4FileIO::createReader(){
 #endif
 
 void MP4FileDisk::openFile(const char *file, const char *mode) {
+    GET_CONFIG(uint32_t,mp4BufSize,Record::kFileBufSize);
+    if (mode[0] == 'w') {
+        //录制写文件，在io线程异步写盘
+        _async_file = std::make_shared<AsyncFile>(std::make_shared<DiskWriteQueue>(), file, mode, mp4BufSize);
+        return;
+    }
+
     //创建文件
     auto fp = File::create_file(file, mode);
     if(!fp){
         throw std::runtime_error(string("打开文件失败:") + file);
     }
 
-    GET_CONFIG(uint32_t,mp4BufSize,Record::kFileBufSize);
-
     //新建文件io缓存
     std::shared_ptr<char> file_buf(new char[mp4BufSize],[](char *ptr){
         if(ptr){
@@ -107,11 +112,20 @@ void MP4FileDisk::openFile(const char *file, const char *mode) {
     });
 }
 
-void MP4FileDisk::closeFile() {
+bool MP4FileDisk::closeFile() {
+    bool ret = true;
+    if (_async_file) {
+        ret = _async_file->sync();
+        _async_file = nullptr;
+    }
     _file = nullptr;
+    return ret;
 }
 
 int MP4FileDisk::onRead(void *data, size_t bytes) {
+    if (_async_file) {
+        return bytes == _async_file->read(data, bytes) ? 0 : -1;
+    }
     if (bytes == fread(data, 1, bytes, _file.get())){
         return 0;
     }
@@ -119,14 +133,25 @@ int MP4FileDisk::onRead(void *data, size_t bytes) {
 }
 
 int MP4FileDisk::onWrite(const void *data, size_t bytes) {
+    if (_async_file) {
+        _async_file->write((const char *)data, bytes);
+        return _async_file->failed() ? -1 : 0;
+    }
     return bytes == fwrite(data, 1, bytes, _file.get()) ? 0 : ferror(_file.get());
 }
 
 int MP4FileDisk::onSeek(uint64_t offset) {
+    if (_async_file) {
+        _async_file->seek(offset);
+        return 0;
+    }
     return fseek64(_file.get(), offset, SEEK_SET);
 }
 
 uint64_t MP4FileDisk::onTell() {
+    if (_async_file) {
+        return _async_file->tell();
+    }
     return ftell64(_file.get());
 }
 
@@ -23,6 +23,7 @@
 #include "mpeg4-aac.h"
 #include "mov-buffer.h"
 #include "mov-format.h"
+#include "DiskWriter.h"
 
 namespace mediakit {
 
@@ -91,9 +92,10 @@ public:
     void openFile(const char *file, const char *mode);
 
     /**
-     * 关闭磁盘文件
+     * 关闭磁盘文件，写模式下会等待数据全部写盘
+     * @return 数据是否全部写入成功
      */
-    void closeFile();
+    bool closeFile();
 
 protected:
     uint64_t onTell() override;
@@ -103,6 +105,8 @@ protected:
 
 private:
     std::shared_ptr<FILE> _file;
+    // 写模式下在io线程异步写盘
+    AsyncFile::Ptr _async_file;
 };
 
 class MP4FileMemory : public MP4FileIO{
@@ -35,9 +35,14 @@ MP4FileIO::Writer MP4Muxer::createWriter() {
     return _mp4_file->createWriter(mp4FastStart ? MOV_FLAG_FASTSTART : 0, recordEnableFmp4);
 }
 
-void MP4Muxer::closeMP4() {
+bool MP4Muxer::closeMP4() {
     MP4MuxerInterface::resetTracks();
-    _mp4_file = nullptr;
+    bool ret = true;
+    if (_mp4_file) {
+        ret = _mp4_file->closeFile();
+        _mp4_file = nullptr;
+    }
+    return ret;
 }
 
 void MP4Muxer::resetTracks() {
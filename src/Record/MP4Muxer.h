@@ -102,9 +102,10 @@ public:
     void openMP4(const std::string &file);
 
     /**
-     * 手动关闭文件(对象析构时会自动关闭)
+     * 手动关闭文件(对象析构时会自动关闭)，会等待数据全部写盘
+     * @return 数据是否全部写入成功
      */
-    void closeMP4();
+    bool closeMP4();
 
 protected:
     MP4FileIO::Writer createWriter() override;
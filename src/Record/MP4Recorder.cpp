@@ -79,7 +79,12 @@ void MP4Recorder::asyncClose() {
         info.time_len = muxer->getDuration() / 1000.0f;
         // 关闭mp4可能非常耗时，所以要放在后台线程执行
         TraceL << "Closing tmp mp4 file: " << full_path_tmp;
-        muxer->closeMP4();
+        if (!muxer->closeMP4()) {
+            // 写盘失败或者写盘队列已满丢弃了数据，文件不完整
+            WarnL << "Write tmp mp4 file failed, delete it: " << full_path_tmp;
+            File::delete_file(full_path_tmp);
+            return;
+        }
         TraceL << "Closed tmp mp4 file: " << full_path_tmp;
         if (!full_path_tmp.empty()) {
             // 获取文件大小
@@ -171,6 +171,11 @@ FCI_NACK::FCI_NACK(uint16_t pid_h, const vector<bool> &type) {
     pid = htons(pid_h);
 }
 
+FCI_NACK::FCI_NACK(uint16_t pid_h, uint16_t blp_h) {
+    blp = htons(blp_h);
+    pid = htons(pid_h);
+}
+
 void FCI_NACK::check(size_t size) {
     CHECK(size >= kSize);
 }
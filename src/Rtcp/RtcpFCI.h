@@ -251,6 +251,8 @@ public:
     static constexpr size_t kBitSize = 16;
 
     FCI_NACK(uint16_t pid_h, const std::vector<bool> &type);
+    // blp_h第i位对应pid_h + i + 1的丢包状态
+    FCI_NACK(uint16_t pid_h, uint16_t blp_h);
 
     void check(size_t size);
     uint16_t getPid() const;
@@ -60,12 +60,22 @@ void FlvMuxer::start(const EventPoller::Ptr &poller, const RtmpMediaSource::Ptr
     });
 
     bool check = start_pts > 0;
+    // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+    LatencyStat::ReplayScope replay_scope;
     _ring_reader->setReadCB([weak_self, start_pts, check](const RtmpMediaSource::RingDataType &pkt) mutable {
         auto strong_self = weak_self.lock();
         if (!strong_self) {
             return;
         }
 
+        GET_CONFIG(bool, shared_flv_tags, Rtmp::kSharedFlvTags);
+        if (shared_flv_tags && !check) {
+            //直接发送共享的flv tag，不再逐包序列化
+            strong_self->onWriteFlvTags(pkt);
+            LatencyStat::onSend(LatencyStat::kRingToFlv, *pkt);
+            return;
+        }
+
         size_t i = 0;
         auto size = pkt->size();
         pkt->for_each([&](const RtmpPacket::Ptr &rtmp) {
@@ -77,6 +87,7 @@ void FlvMuxer::start(const EventPoller::Ptr &poller, const RtmpMediaSource::Ptr
             }
             strong_self->onWriteRtmp(rtmp, ++i == size);
         });
+        LatencyStat::onSend(LatencyStat::kRingToFlv, *pkt);
     });
 }
 
@@ -146,6 +157,10 @@ void FlvMuxer::onWriteFlvTag(uint8_t type, const Buffer::Ptr &buffer, uint32_t t
     onWrite(obtainBuffer((char *) &size, 4), flush);
 }
 
+void FlvMuxer::onWriteFlvTags(const RtmpMediaSource::RingDataType &pkt) {
+    onWrite(pkt->getFlvTags(), true);
+}
+
 void FlvMuxer::onWriteRtmp(const RtmpPacket::Ptr &pkt, bool flush) {
     onWriteFlvTag(pkt, pkt->time_stamp, flush);
 }
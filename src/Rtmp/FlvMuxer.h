@@ -28,6 +28,11 @@ public:
 protected:
     void start(const toolkit::EventPoller::Ptr &poller, const RtmpMediaSource::Ptr &media, uint32_t start_pts = 0);
     virtual void onWrite(const toolkit::Buffer::Ptr &data, bool flush) = 0;
+    /**
+     * 输出一批rtmp包序列化后的flv tag，该数据在所有播放器间共享，请勿修改
+     * websocket等需要额外封装的子类可以重载
+     */
+    virtual void onWriteFlvTags(const RtmpMediaSource::RingDataType &pkt);
     virtual void onDetach() = 0;
     virtual std::shared_ptr<FlvMuxer> getSharedPtr() = 0;
 
@@ -9,8 +9,10 @@
  */
 
 #include "Rtmp.h"
+#include "utils.h"
 #include "Common/config.h"
 #include "Extension/Factory.h"
+#include "Http/WebSocketSplitter.h"
 
 namespace mediakit {
 
@@ -132,17 +134,49 @@ void Metadata::addTrack(AMFValue &metadata, const Track::Ptr &track) {
 }
 
 RtmpPacket::Ptr RtmpPacket::create() {
-#if 0
-    static ResourcePool<RtmpPacket> packet_pool;
-    static onceToken token([]() {
-        packet_pool.setSize(1024);
+    // 对象与控制块从线程缓存内存池分配
+    return makePooledShared(new RtmpPacket);
+}
+
+const toolkit::Buffer::Ptr &RtmpPacketList::getFlvTags() const {
+    // 不同线程的播放器可能同时读取该列表
+    std::call_once(_flv_flag, [this]() {
+        size_t size = 0;
+        for_each([&](const RtmpPacket::Ptr &pkt) { size += sizeof(RtmpTagHeader) + pkt->size() + 4; });
+        auto buffer = toolkit::BufferRaw::create();
+        buffer->setCapacity(size + 1);
+        auto ptr = buffer->data();
+        for_each([&](const RtmpPacket::Ptr &pkt) {
+            RtmpTagHeader header;
+            header.type = pkt->type_id;
+            set_be24(header.data_size, (uint32_t)pkt->size());
+            header.timestamp_ex = (pkt->time_stamp >> 24) & 0xff;
+            set_be24(header.timestamp, pkt->time_stamp & 0xFFFFFF);
+            memcpy(ptr, &header, sizeof(header));
+            ptr += sizeof(header);
+            memcpy(ptr, pkt->data(), pkt->size());
+            ptr += pkt->size();
+            // PreviousTagSize
+            uint32_t tag_size = htonl((uint32_t)(pkt->size() + sizeof(header)));
+            memcpy(ptr, &tag_size, 4);
+            ptr += 4;
+        });
+        buffer->setSize(size);
+        _flv_tags = std::move(buffer);
+    });
+    return _flv_tags;
+}
+
+const toolkit::Buffer::Ptr &RtmpPacketList::getWebSocketHeader() const {
+    std::call_once(_ws_flag, [this]() {
+        WebSocketHeader header;
+        header._fin = true;
+        header._reserved = 0;
+        header._opcode = WebSocketHeader::BINARY;
+        header._mask_flag = false;
+        _ws_header = std::make_shared<toolkit::BufferString>(WebSocketSplitter::encodeHeader(header, getFlvTags()->size()));
     });
-    auto ret = packet_pool.obtain2();
-    ret->clear();
-    return ret;
-#else
-    return Ptr(new RtmpPacket);
-#endif
+    return _ws_header;
 }
 
 void RtmpPacket::clear() {
@@ -151,6 +185,76 @@ void RtmpPacket::clear() {
     ts_field = 0;
     body_size = 0;
     buffer.clear();
+    std::lock_guard<std::mutex> lck(_chunks_mtx);
+    _chunks.clear();
+}
+
+RtmpChunkList *RtmpPacket::getChunks(uint32_t stream_index, size_t chunk_size) const {
+    // 不同线程的播放器可能同时发送该包
+    std::lock_guard<std::mutex> lck(_chunks_mtx);
+    for (auto &chunks : _chunks) {
+        if (chunks.match(buffer.data(), buffer.size(), type_id, stream_index, time_stamp, chunk_id, chunk_size)) {
+            return &chunks;
+        }
+    }
+    if (_chunks.size() >= kMaxChunkCache) {
+        return nullptr;
+    }
+    // 切片不持有本包，避免循环引用
+    _chunks.emplace_back(buffer.data(), buffer.size(), type_id, stream_index, time_stamp, chunk_id, chunk_size);
+    return &_chunks.back();
+}
+
+RtmpChunkList::RtmpChunkList(const char *data, size_t size, uint8_t type, uint32_t stream_index, uint32_t stamp, int chunk_id, size_t chunk_size,
+                             toolkit::Buffer::Ptr owner) {
+    _type = type;
+    _chunk_id = chunk_id;
+    _stream_index = stream_index;
+    _stamp = stamp;
+    _chunk_size = chunk_size = MAX(chunk_size, (size_t)1);
+    _data = data;
+    _size = size;
+    _owner = std::move(owner);
+
+    //是否有扩展时间戳
+    bool ext_stamp = stamp >= 0xFFFFFF;
+    size_t ext_size = ext_stamp ? 4 : 0;
+
+    //对rtmp头赋值，如果使用整形赋值，在arm android上可能由于数据对齐导致总线错误的问题
+    auto header = (RtmpHeader *)_headers;
+    header->fmt = 0;
+    header->chunk_id = chunk_id;
+    header->type_id = type;
+    set_be24(header->time_stamp, ext_stamp ? 0xFFFFFF : stamp);
+    set_be24(header->body_size, (uint32_t)size);
+    set_le32(header->stream_index, stream_index);
+    if (ext_stamp) {
+        set_be32(_headers + sizeof(RtmpHeader), stamp);
+    }
+    _first_header.assign(_headers, sizeof(RtmpHeader) + ext_size);
+
+    //后续chunk使用一个字节的fmt3块头，标明是什么chunkId
+    auto flags = _headers + sizeof(RtmpHeader) + 4;
+    header = (RtmpHeader *)flags;
+    header->fmt = 3;
+    header->chunk_id = chunk_id;
+    if (ext_stamp) {
+        set_be32(flags + 1, stamp);
+    }
+    _header.assign(flags, 1 + ext_size);
+
+    _count = (size + chunk_size - 1) / chunk_size;
+    _payloads.reset(new Slice[_count]);
+    for (size_t i = 0; i < _count; ++i) {
+        auto offset = i * chunk_size;
+        _payloads[i].assign(data + offset, MIN(chunk_size, size - offset));
+    }
+    _total_size = _first_header.size() + size + (_count ? (_count - 1) * _header.size() : 0);
+}
+
+bool RtmpChunkList::match(const char *data, size_t size, uint8_t type, uint32_t stream_index, uint32_t stamp, int chunk_id, size_t chunk_size) const {
+    return _data == data && _size == size && _type == type && _stream_index == stream_index && _stamp == stamp && _chunk_id == chunk_id
+        && _chunk_size == MAX(chunk_size, (size_t)1);
 }
 
 bool RtmpPacket::isVideoKeyFrame() const {
@@ -11,11 +11,16 @@
 #ifndef __rtmp_h
 #define __rtmp_h
 
+#include <list>
+#include <mutex>
 #include <memory>
 #include <string>
 #include <cstdlib>
 #include "amf.h"
+#include "Util/List.h"
 #include "Network/Buffer.h"
+#include "Common/LatencyStat.h"
+#include "Common/PacketPool.h"
 #include "Extension/Track.h"
 
 #define DEFAULT_CHUNK_LEN	128
@@ -160,7 +165,81 @@ struct RtmpVideoHeaderClassic {
 
 #pragma pack(pop)
 
-class RtmpPacket : public toolkit::Buffer{
+/**
+ * 按照chunk size分块后的rtmp消息
+ * 所有块头(含扩展时间戳)存放在同一个数组中，负载切片直接引用消息体，不拷贝
+ * fmt3块头对每个后续chunk都相同，只保存一份
+ */
+class RtmpChunkList : public toolkit::noncopyable {
+public:
+    using Ptr = std::shared_ptr<RtmpChunkList>;
+
+    /**
+     * @param data 消息体
+     * @param size 消息体长度
+     * @param owner 持有消息体，为空时由调用者保证消息体在本对象销毁前有效
+     */
+    RtmpChunkList(const char *data, size_t size, uint8_t type, uint32_t stream_index, uint32_t stamp, int chunk_id, size_t chunk_size,
+                  toolkit::Buffer::Ptr owner = nullptr);
+
+    /**
+     * 是否为同一个消息以相同参数分块的结果
+     */
+    bool match(const char *data, size_t size, uint8_t type, uint32_t stream_index, uint32_t stamp, int chunk_id, size_t chunk_size) const;
+
+    /**
+     * 分块后的总字节数(含块头)
+     */
+    size_t totalSize() const { return _total_size; }
+
+    /**
+     * 按照发送顺序遍历块头与负载切片
+     */
+    template <typename FUNC>
+    void for_each(FUNC &&func) {
+        func(_first_header);
+        for (size_t i = 0; i < _count; ++i) {
+            if (i) {
+                func(_header);
+            }
+            func(_payloads[i]);
+        }
+    }
+
+private:
+    class Slice : public toolkit::Buffer {
+    public:
+        void assign(const char *data, size_t size) {
+            _data = (char *)data;
+            _size = size;
+        }
+        char *data() const override { return _data; }
+        size_t size() const override { return _size; }
+
+    private:
+        char *_data = nullptr;
+        size_t _size = 0;
+    };
+
+private:
+    uint8_t _type;
+    int _chunk_id;
+    uint32_t _stream_index;
+    uint32_t _stamp;
+    size_t _chunk_size;
+    const char *_data;
+    size_t _size;
+    size_t _count;
+    size_t _total_size;
+    // fmt0块头与fmt3块头，各自带有可选的扩展时间戳
+    char _headers[sizeof(RtmpHeader) + 4 + 1 + 4];
+    Slice _first_header;
+    Slice _header;
+    std::unique_ptr<Slice[]> _payloads;
+    toolkit::Buffer::Ptr _owner;
+};
+
+class RtmpPacket : public toolkit::Buffer, public PacketPoolObject {
 public:
     friend class RtmpProtocol;
     using Ptr = std::shared_ptr<RtmpPacket>;
@@ -198,6 +277,13 @@ public:
     int getAudioSampleBit() const;
     int getAudioChannel() const;
 
+    /**
+     * 获取按照chunk_size分块后的数据，每种分块参数只生成一次并缓存在本包中
+     * 同一个包发送给多个播放器时不再重复分块，线程安全
+     * 返回的对象与本包生命周期一致，缓存已满时返回nullptr
+     */
+    RtmpChunkList *getChunks(uint32_t stream_index, size_t chunk_size) const;
+
 private:
     friend class toolkit::ResourcePool_l<RtmpPacket>;
     RtmpPacket(){
@@ -207,10 +293,40 @@ private:
     RtmpPacket &operator=(const RtmpPacket &that);
 
 private:
+    // 每个包最多缓存的分块结果个数
+    static constexpr size_t kMaxChunkCache = 4;
+    mutable std::mutex _chunks_mtx;
+    mutable std::list<RtmpChunkList> _chunks;
     //对象个数统计
     toolkit::ObjectStatistic<RtmpPacket> _statistic;
 };
 
+/**
+ * 合并写的rtmp包列表
+ * 同一批rtmp包序列化后的flv tag在所有http-flv/ws-flv播放器间共享，每个包只序列化一次
+ */
+class RtmpPacketList : public LatencyList<RtmpPacket::Ptr> {
+public:
+    using Ptr = std::shared_ptr<RtmpPacketList>;
+
+    /**
+     * 获取序列化后的flv tag(tag header + tag data + PreviousTagSize)
+     * 首次调用时生成，之后直接返回，线程安全
+     */
+    const toolkit::Buffer::Ptr &getFlvTags() const;
+
+    /**
+     * 获取承载getFlvTags()的websocket二进制帧头(fin=1，无掩码)
+     */
+    const toolkit::Buffer::Ptr &getWebSocketHeader() const;
+
+private:
+    mutable std::once_flag _flv_flag;
+    mutable std::once_flag _ws_flag;
+    mutable toolkit::Buffer::Ptr _flv_tags;
+    mutable toolkit::Buffer::Ptr _ws_header;
+};
+
 /**
  * rtmp metadata基类，用于描述rtmp格式信息
  */
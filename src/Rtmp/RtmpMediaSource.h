@@ -33,10 +33,10 @@ namespace mediakit {
  * 只要生成了这三要素，那么要实现rtmp推流、rtmp服务器就很简单了
  * rtmp推拉流协议中，先传递metadata，然后传递config帧，然后一直传递普通帧
  */
-class RtmpMediaSource : public MediaSource, public toolkit::RingDelegate<RtmpPacket::Ptr>, private PacketCache<RtmpPacket>{
+class RtmpMediaSource : public MediaSource, public toolkit::RingDelegate<RtmpPacket::Ptr>, private PacketCache<RtmpPacket, FlushPolicy, RtmpPacketList> {
 public:
     using Ptr = std::shared_ptr<RtmpMediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<RtmpPacket::Ptr> >;
+    using RingDataType = RtmpPacketList::Ptr;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     /**
@@ -70,6 +70,10 @@ public:
         return _ring ? _ring->readerCount() : 0;
     }
 
+    const LatencyHistogram *getIngestLatency() const override {
+        return &PacketCache<RtmpPacket, FlushPolicy, RtmpPacketList>::getIngestLatency();
+    }
+
     /**
      * 获取metadata
      */
@@ -108,8 +112,15 @@ public:
      */
     uint32_t getTimeStamp(TrackType trackType) override;
 
+    /**
+     * 设置是否缓存gop，由共享gop缓存提供首次播放数据时，环形缓存只保留最新的数据
+     */
+    void setKeepGop(bool keep_gop) {
+        _keep_gop = keep_gop;
+    }
+
     void clearCache() override{
-        PacketCache<RtmpPacket>::clearCache();
+        PacketCache<RtmpPacket, FlushPolicy, RtmpPacketList>::clearCache();
         _ring->clearCache();
     }
 
@@ -127,13 +138,14 @@ private:
     * @param rtmp_list rtmp包列表
     * @param key_pos 是否包含关键帧
     */
-    void onFlush(std::shared_ptr<toolkit::List<RtmpPacket::Ptr> > rtmp_list, bool key_pos) override {
+    void onFlush(RtmpPacketList::Ptr rtmp_list, bool key_pos) override {
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以is_key一直为true确保一直清空GOP缓存
-        _ring->write(std::move(rtmp_list), _have_video ? key_pos : true);
+        _ring->write(std::move(rtmp_list), _have_video && _keep_gop ? key_pos : true);
     }
 
 private:
     bool _have_video = false;
+    bool _keep_gop = true;
     bool _have_audio = false;
     int _ring_size;
     uint32_t _track_stamps[TrackMax] = {0};
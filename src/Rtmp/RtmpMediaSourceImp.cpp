@@ -82,7 +82,7 @@ void RtmpMediaSource::onWrite(RtmpPacket::Ptr pkt, bool /*= true*/) {
     }
     bool key = pkt->isVideoKeyFrame();
     auto stamp = pkt->time_stamp;
-    PacketCache<RtmpPacket>::inputPacket(stamp, is_video, std::move(pkt), key);
+    PacketCache<RtmpPacket, FlushPolicy, RtmpPacketList>::inputPacket(stamp, is_video, std::move(pkt), key);
 }
 
 RtmpMediaSourceImp::RtmpMediaSourceImp(const MediaTuple &tuple, int ringSize)
@@ -13,17 +13,18 @@
 
 #include "RtmpMuxer.h"
 #include "Rtmp/RtmpMediaSource.h"
+#include "Common/FrameGopCache.h"
 
 namespace mediakit {
 
-class RtmpMediaSourceMuxer final : public RtmpMuxer, public MediaSourceEventInterceptor,
+class RtmpMediaSourceMuxer final : public RtmpMuxer, public MediaSourceEventInterceptor, public FrameGopReplayer,
                                    public std::enable_shared_from_this<RtmpMediaSourceMuxer> {
 public:
     using Ptr = std::shared_ptr<RtmpMediaSourceMuxer>;
 
     RtmpMediaSourceMuxer(const MediaTuple& tuple,
                          const ProtocolOption &option,
-                         const TitleMeta::Ptr &title = nullptr) : RtmpMuxer(title) {
+                         const TitleMeta::Ptr &title = nullptr) : RtmpMuxer(title), FrameGopReplayer(option.rtmp_demand) {
         _option = option;
         _media_src = std::make_shared<RtmpMediaSource>(tuple);
         getRtmpRing()->setDelegate(_media_src);
@@ -68,13 +69,22 @@ public:
         if (_clear_cache && _option.rtmp_demand) {
             _clear_cache = false;
             _media_src->clearCache();
+            resetGopIndex();
         }
         if (_enabled || !_option.rtmp_demand) {
+            replayGop([this](const Frame::Ptr &frame) { RtmpMuxer::inputFrame(frame); });
             return RtmpMuxer::inputFrame(frame);
         }
         return false;
     }
 
+    /**
+     * 设置共享gop缓存，按需转协议时用于首次播放，此时协议环形缓存不再缓存gop
+     */
+    void setGopCache(const FrameGopCache::Ptr &gop_cache) {
+        _media_src->setKeepGop(!FrameGopReplayer::setGopCache(gop_cache));
+    }
+
     bool isEnabled() {
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.rtmp_demand ? (_clear_cache ? true : _enabled) : true;
@@ -136,7 +136,7 @@ void RtmpPlayer::onPlayResult_l(const SockException &ex, bool handshake_done) {
             return true;
         };
         //创建rtmp数据接收超时检测定时器
-        _rtmp_recv_timer = std::make_shared<Timer>(timeout_ms / 2000.0f, lam, getPoller());
+        _rtmp_recv_timer = std::make_shared<WheelTimer>(timeout_ms / 2000.0f, lam, getPoller());
     } else {
         shutdown(SockException(Err_shutdown,"teardown"));
     }
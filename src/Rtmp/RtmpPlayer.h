@@ -21,6 +21,7 @@
 #include "Util/TimeTicker.h"
 #include "Network/Socket.h"
 #include "Network/TcpClient.h"
+#include "Common/TimerWheel.h"
 
 namespace mediakit {
 
@@ -101,7 +102,7 @@ private:
     //播放超时定时器
     std::shared_ptr<toolkit::Timer> _play_timer;
     //rtmp接收超时定时器
-    std::shared_ptr<toolkit::Timer> _rtmp_recv_timer;
+    WheelTimer::Ptr _rtmp_recv_timer;
 };
 
 } /* namespace mediakit */
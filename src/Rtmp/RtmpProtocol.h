@@ -61,9 +61,14 @@ protected:
     void sendResponse(int type, const std::string &str);
     void sendRtmp(uint8_t type, uint32_t stream_index, const std::string &buffer, uint32_t stamp, int chunk_id);
     void sendRtmp(uint8_t type, uint32_t stream_index, const toolkit::Buffer::Ptr &buffer, uint32_t stamp, int chunk_id);
+    /**
+     * 发送媒体包，分块结果缓存在包中，多个播放器共享
+     */
+    void sendRtmp(const RtmpPacket::Ptr &pkt, uint32_t stream_index);
     toolkit::BufferRaw::Ptr obtainBuffer(const void *data = nullptr, size_t len = 0);
 
 private:
+    void sendRtmpChunks(const std::shared_ptr<void> &owner, RtmpChunkList &chunks, int chunk_id);
     void handle_C1_simple(const char *data);
 #ifdef ENABLE_OPENSSL
     void handle_C1_complex(const char *data);
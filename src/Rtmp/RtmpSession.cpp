@@ -67,6 +67,7 @@ void RtmpSession::onManager() {
 void RtmpSession::onRecv(const Buffer::Ptr &buf) {
     _ticker.resetTime();
     _total_bytes += buf->size();
+    Metrics::add(Metrics::kRtmpBytesIn, buf->size());
     onParseRtmp(buf->data(), buf->size());
 }
 
@@ -309,6 +310,8 @@ void RtmpSession::sendPlayResponse(const string &err, const RtmpMediaSource::Ptr
         ret.set(static_pointer_cast<SockInfo>(weak_self.lock()));
         return ret;
     });
+    // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+    LatencyStat::ReplayScope replay_scope;
     _ring_reader->setReadCB([weak_self](const RtmpMediaSource::RingDataType &pkt) {
         auto strong_self = weak_self.lock();
         if (!strong_self) {
@@ -323,6 +326,7 @@ void RtmpSession::sendPlayResponse(const string &err, const RtmpMediaSource::Ptr
             }
             strong_self->onSendMedia(rtmp);
         });
+        LatencyStat::onSend(LatencyStat::kRingToRtmp, *pkt);
     });
     _ring_reader->setDetachCB([weak_self]() {
         auto strong_self = weak_self.lock();
@@ -585,7 +589,7 @@ void RtmpSession::onCmd_seek(AMFDecoder &dec) {
 }
 
 void RtmpSession::onSendMedia(const RtmpPacket::Ptr &pkt) {
-    sendRtmp(pkt->type_id, pkt->stream_index, pkt, pkt->time_stamp, pkt->chunk_id);
+    sendRtmp(pkt, pkt->stream_index);
 }
 
 bool RtmpSession::close(MediaSource &sender) {
@@ -15,6 +15,7 @@
 #include "amf.h"
 #include "Rtmp.h"
 #include "utils.h"
+#include "Common/Metrics.h"
 #include "RtmpProtocol.h"
 #include "RtmpMediaSourceImp.h"
 #include "Util/TimeTicker.h"
@@ -54,6 +55,7 @@ private:
     void onSendMedia(const RtmpPacket::Ptr &pkt);
     void onSendRawData(toolkit::Buffer::Ptr buffer) override{
         _total_bytes += buffer->size();
+        Metrics::add(Metrics::kRtmpBytesOut, buffer->size());
         send(std::move(buffer));
     }
     void onRtmpChunk(RtmpPacket::Ptr chunk_data) override;
@@ -28,6 +28,10 @@ void Decoder::setOnDecode(Decoder::onDecode cb) {
 void Decoder::setOnStream(Decoder::onStream cb) {
     _on_stream = std::move(cb);
 }
+
+void Decoder::setOnDecodeBuffer(Decoder::onDecodeBuffer cb) {
+    _on_decode_buffer = std::move(cb);
+}
     
 static Decoder::Ptr createDecoder_l(DecoderImp::Type type) {
     switch (type){
@@ -62,6 +66,7 @@ DecoderImp::Ptr DecoderImp::createDecoder(Type type, MediaSinkInterface *sink){
 }
 
 void DecoderImp::flush() {
+    _decoder->flush();
     for (auto &pr : _tracks) {
         pr.second.second.flush();
     }
@@ -71,6 +76,14 @@ ssize_t DecoderImp::input(const uint8_t *data, size_t bytes){
     return _decoder->input(data, bytes);
 }
 
+ssize_t DecoderImp::input(const Buffer::Ptr &buffer, const uint8_t *data, size_t bytes) {
+    return _decoder->input(buffer, data, bytes);
+}
+
+void DecoderImp::reset() {
+    _decoder->reset();
+}
+
 DecoderImp::DecoderImp(const Decoder::Ptr &decoder, MediaSinkInterface *sink){
     _decoder = decoder;
     _sink = sink;
@@ -80,6 +93,9 @@ DecoderImp::DecoderImp(const Decoder::Ptr &decoder, MediaSinkInterface *sink){
     _decoder->setOnStream([this](int stream, int codecid, const void *extra, size_t bytes, int finish) {
         onStream(stream, codecid, extra, bytes, finish);
     });
+    _decoder->setOnDecodeBuffer([this](int stream, int codecid, int flags, int64_t pts, int64_t dts, const Buffer::Ptr &buffer) {
+        onDecodeBuffer(stream, codecid, flags, pts, dts, buffer);
+    });
 }
 
 #if defined(ENABLE_RTPPROXY) || defined(ENABLE_HLS)
@@ -98,13 +114,9 @@ void DecoderImp::onStream(int stream, int codecid, const void *extra, size_t byt
     }
 }
 
-void DecoderImp::onDecode(int stream, int codecid, int flags, int64_t pts, int64_t dts, const void *data, size_t bytes) {
-    pts /= 90;
-    dts /= 90;
-
-    auto codec = getCodecByMpegId(codecid);
+bool DecoderImp::checkTrack(int stream, CodecId codec) {
     if (codec == CodecInvalid) {
-        return;
+        return false;
     }
     auto &ref = _tracks[stream];
     if (!ref.first) {
@@ -112,8 +124,20 @@ void DecoderImp::onDecode(int stream, int codecid, int flags, int64_t pts, int64
     }
     if (!ref.first) {
         WarnL << "Unsupported codec :" << getCodecName(codec);
+        return false;
+    }
+    return true;
+}
+
+void DecoderImp::onDecode(int stream, int codecid, int flags, int64_t pts, int64_t dts, const void *data, size_t bytes) {
+    pts /= 90;
+    dts /= 90;
+
+    auto codec = getCodecByMpegId(codecid);
+    if (!checkTrack(stream, codec)) {
         return;
     }
+    auto &ref = _tracks[stream];
     auto frame = Factory::getFrameFromPtr(codec, (char *)data, bytes, dts, pts);
     if (getTrackType(codec) != TrackVideo) {
         onFrame(stream, frame);
@@ -123,8 +147,18 @@ void DecoderImp::onDecode(int stream, int codecid, int flags, int64_t pts, int64
         onFrame(stream, Factory::getFrameFromBuffer(codec, buffer, dts, pts));
     });
 }
+
+void DecoderImp::onDecodeBuffer(int stream, int codecid, int flags, int64_t pts, int64_t dts, const Buffer::Ptr &buffer) {
+    auto codec = getCodecByMpegId(codecid);
+    if (!checkTrack(stream, codec)) {
+        return;
+    }
+    // 解复用器已经按照时间戳合并为完整的帧，不需要再经过FrameMerger拷贝
+    onFrame(stream, Factory::getFrameFromBuffer(codec, buffer, dts / 90, pts / 90));
+}
 #else
 void DecoderImp::onDecode(int stream,int codecid,int flags,int64_t pts,int64_t dts,const void *data,size_t bytes) {}
+void DecoderImp::onDecodeBuffer(int stream,int codecid,int flags,int64_t pts,int64_t dts,const Buffer::Ptr &buffer) {}
 void DecoderImp::onStream(int stream,int codecid,const void *extra,size_t bytes,int finish) {}
 #endif
 
@@ -23,10 +23,33 @@ public:
     using Ptr = std::shared_ptr<Decoder>;
     using onDecode = std::function<void(int stream, int codecid, int flags, int64_t pts, int64_t dts, const void *data, size_t bytes)>;
     using onStream = std::function<void(int stream, int codecid, const void *extra, size_t bytes, int finish)>;
+    // 输出的buffer可以被直接持有，不需要再拷贝
+    using onDecodeBuffer = std::function<void(int stream, int codecid, int flags, int64_t pts, int64_t dts, const toolkit::Buffer::Ptr &buffer)>;
 
     virtual ssize_t input(const uint8_t *data, size_t bytes) = 0;
+
+    /**
+     * 输入数据，解复用器可以持有buffer以引用data，避免拷贝
+     * 默认不支持引用，按普通数据输入
+     * @param buffer data所属的buffer
+     * @param data 数据指针，位于buffer内
+     * @param bytes 数据长度
+     */
+    virtual ssize_t input(const toolkit::Buffer::Ptr &buffer, const uint8_t *data, size_t bytes) { return input(data, bytes); }
+
+    /**
+     * 输入数据不连续(例如rtp丢包)，丢弃未完成的帧并重新同步
+     */
+    virtual void reset() {}
+
+    /**
+     * 输出所有缓存的帧
+     */
+    virtual void flush() {}
+
     void setOnDecode(onDecode cb);
     void setOnStream(onStream cb);
+    void setOnDecodeBuffer(onDecodeBuffer cb);
 
 protected:
     Decoder() = default;
@@ -35,6 +58,7 @@ protected:
 protected:
     onDecode _on_decode;
     onStream _on_stream;
+    onDecodeBuffer _on_decode_buffer;
 };
 
 class DecoderImp {
@@ -45,6 +69,8 @@ public:
 
     static Ptr createDecoder(Type type, MediaSinkInterface *sink);
     ssize_t input(const uint8_t *data, size_t bytes);
+    ssize_t input(const toolkit::Buffer::Ptr &buffer, const uint8_t *data, size_t bytes);
+    void reset();
     void flush();
 
 protected:
@@ -54,7 +80,9 @@ protected:
 private:
     DecoderImp(const Decoder::Ptr &decoder, MediaSinkInterface *sink);
     void onDecode(int stream, int codecid, int flags, int64_t pts, int64_t dts, const void *data, size_t bytes);
+    void onDecodeBuffer(int stream, int codecid, int flags, int64_t pts, int64_t dts, const toolkit::Buffer::Ptr &buffer);
     void onStream(int stream, int codecid, const void *extra, size_t bytes, int finish);
+    bool checkTrack(int stream, CodecId codec);
 
 private:
     bool _have_video = false;
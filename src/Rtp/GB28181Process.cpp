@@ -10,7 +10,6 @@
 
 #if defined(ENABLE_RTPPROXY)
 #include "GB28181Process.h"
-#include "Extension/CommonRtp.h"
 #include "Extension/Factory.h"
 #include "Http/HttpTSPlayer.h"
 #include "Util/File.h"
@@ -57,7 +56,13 @@ GB28181Process::GB28181Process(const MediaInfo &media_info, MediaSinkInterface *
 }
 
 void GB28181Process::onRtpSorted(RtpPacket::Ptr rtp) {
-    _rtp_decoder[rtp->getHeader()->pt]->inputRtp(rtp, false);
+    auto &decoder = _rtp_decoder[rtp->getHeader()->pt];
+    if (decoder) {
+        decoder->inputRtp(rtp, false);
+        return;
+    }
+    // ts或ps负载，直接输入解复用器
+    onRtpPayload(rtp);
 }
 
 void GB28181Process::flush() {
@@ -132,8 +137,8 @@ bool GB28181Process::inputRtp(bool, const char *data, size_t data_len) {
                         WarnL << "Unknown rtp payload type(" << (int)pt << "), decode it as mpeg-ps or mpeg-ts";
                     }
                     ref = std::make_shared<RtpReceiverImp>(90000, [this](RtpPacket::Ptr rtp) { onRtpSorted(std::move(rtp)); });
-                    // ts或ps负载
-                    _rtp_decoder[pt] = std::make_shared<CommonRtpDecoder>(CodecInvalid, 32 * 1024);
+                    // ts或ps负载，不需要先合并rtp负载，解复用器直接引用rtp包
+                    _rtp_decoder[pt] = nullptr;
                     // 设置dump目录
                     GET_CONFIG(string, dump_dir, RtpProxy::kDumpDir);
                     if (!dump_dir.empty()) {
@@ -148,32 +153,41 @@ bool GB28181Process::inputRtp(bool, const char *data, size_t data_len) {
                 break;
             }
         }
-        // 设置frame回调
-        _rtp_decoder[pt]->addDelegate([this, pt](const Frame::Ptr &frame) {
-            frame->setIndex(pt);
-            onRtpDecode(frame);
-            return true;
-        });
+        auto &decoder = _rtp_decoder[pt];
+        if (decoder) {
+            // 设置frame回调
+            decoder->addDelegate([this, pt](const Frame::Ptr &frame) {
+                frame->setIndex(pt);
+                _interface->inputFrame(frame);
+                return true;
+            });
+        }
     }
 
     return ref->inputRtp(TrackVideo, (unsigned char *)data, data_len);
 }
 
-void GB28181Process::onRtpDecode(const Frame::Ptr &frame) {
-    if (frame->getCodecId() != CodecInvalid) {
-        // 这里不是ps或ts
-        _interface->inputFrame(frame);
+void GB28181Process::onRtpPayload(const RtpPacket::Ptr &rtp) {
+    auto payload = rtp->getPayload();
+    auto size = rtp->getPayloadSize();
+    if (!size) {
+        // 无实际负载
         return;
     }
+    auto seq = rtp->getSeq();
+    auto last_seq = _last_seq;
+    auto have_last_seq = _have_last_seq;
+    _last_seq = seq;
+    _have_last_seq = true;
 
     // 这是TS或PS
     if (_save_file_ps) {
-        fwrite(frame->data(), frame->size(), 1, _save_file_ps.get());
+        fwrite(payload, size, 1, _save_file_ps.get());
     }
 
     if (!_decoder) {
         // 创建解码器
-        if (checkTS((uint8_t *)frame->data(), frame->size())) {
+        if (checkTS(payload, size)) {
             // 猜测是ts负载
             InfoL << _media_info.stream << " judged to be TS";
             _decoder = DecoderImp::createDecoder(DecoderImp::decoder_ts, _interface);
@@ -185,7 +199,12 @@ void GB28181Process::onRtpDecode(const Frame::Ptr &frame) {
     }
 
     if (_decoder) {
-        _decoder->input(reinterpret_cast<const uint8_t *>(frame->data()), frame->size());
+        if (have_last_seq && (uint16_t)(last_seq + 1) != seq) {
+            // rtp丢包了，丢弃未完成的帧
+            WarnL << "rtp丢包:" << last_seq << " -> " << seq;
+            _decoder->reset();
+        }
+        _decoder->input(rtp, payload, size);
     }
 }
 
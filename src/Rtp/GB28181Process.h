@@ -45,9 +45,12 @@ protected:
     void onRtpSorted(RtpPacket::Ptr rtp);
 
 private:
-    void onRtpDecode(const Frame::Ptr &frame);
+    void onRtpPayload(const RtpPacket::Ptr &rtp);
 
 private:
+    // 是否已收到过rtp，seq为0也是合法的序号，不能用来表示无上一个包
+    bool _have_last_seq = false;
+    uint16_t _last_seq = 0;
     MediaInfo _media_info;
     DecoderImp::Ptr _decoder;
     MediaSinkInterface *_interface;
@@ -11,64 +11,369 @@
 #if defined(ENABLE_RTPPROXY)
 
 #include "PSDecoder.h"
-#include "mpeg-ps.h"
+#include "Common/macros.h"
+#include "Common/PacketPool.h"
+#include "Extension/StartCode.h"
+#include "mpeg-proto.h"
 
 using namespace toolkit;
 
 namespace mediakit{
 
+static inline bool isPES(int id) {
+    // 0xBD为私有流(海康等用来承载私有数据，也可能承载音频)，0xC0~0xDF为音频，0xE0~0xEF为视频
+    return id == 0xBD || (id >= 0xC0 && id <= 0xEF);
+}
+
+static inline bool isVideo(int id, int codecid) {
+    if (codecid) {
+        return getTrackType(getCodecByMpegId(codecid)) == TrackVideo;
+    }
+    return (id & 0xF0) == 0xE0;
+}
+
+static inline int64_t readTimestamp(const uint8_t *ptr) {
+    // 33位时间戳，中间穿插marker bit
+    return ((int64_t)((ptr[0] >> 1) & 0x07) << 30) | (ptr[1] << 22) | ((ptr[2] >> 1) << 15) | (ptr[3] << 7) | (ptr[4] >> 1);
+}
+
 PSDecoder::PSDecoder() {
-    _ps_demuxer = ps_demuxer_create([](void* param,
-                                       int stream,
-                                       int codecid,
-                                       int flags,
-                                       int64_t pts,
-                                       int64_t dts,
-                                       const void* data,
-                                       size_t bytes){
-        PSDecoder *thiz = (PSDecoder *)param;
-        if(thiz->_on_decode){
-            thiz->_on_decode(stream, codecid, flags, pts, dts, data, bytes);
+    _header.reserve(64);
+}
+
+ssize_t PSDecoder::input(const uint8_t *data, size_t bytes) {
+    // 数据不属于任何buffer，只能先拷贝一份，解析出的帧再引用该buffer
+    auto buffer = PooledBuffer::create(bytes);
+    memcpy(buffer->data(), data, bytes);
+    buffer->setSize(bytes);
+    return input(buffer, (uint8_t *)buffer->data(), bytes);
+}
+
+ssize_t PSDecoder::input(const Buffer::Ptr &buffer, const uint8_t *data, size_t bytes) {
+    auto ptr = data;
+    auto end = data + bytes;
+    while (ptr < end) {
+        switch (_state) {
+            case kSync: {
+                // ps单元的stream id都不小于0xB9，而h264/h265的nal头首字节小于0x80，不会误判
+                auto pos = ptr;
+                while ((pos = (const uint8_t *)findStartCode((const char *)pos, (const char *)end)) && pos + 3 < end && pos[3] < 0xB9) {
+                    pos += 3;
+                }
+                _header.clear();
+                if (!pos) {
+                    // 本次数据中没有ps单元，全部丢弃
+                    ptr = end;
+                    break;
+                }
+                // 起始码后的stream id可能在下一个包中
+                _state = kHeader;
+                ptr = pos;
+                break;
+            }
+
+            case kHeader: {
+                size_t need;
+                while ((need = getHeaderSize()) > _header.size() && ptr < end) {
+                    auto size = MIN(need - _header.size(), (size_t)(end - ptr));
+                    _header.append((const char *)ptr, size);
+                    ptr += size;
+                }
+                if (!need) {
+                    // 不是合法的ps单元(一般是丢包导致)，重新查找起始码
+                    DebugL << "Invalid ps unit: " << hexdump(_header.data(), MIN(_header.size(), (size_t)32));
+                    _state = kSync;
+                    break;
+                }
+                if (_header.size() < need) {
+                    // 等待更多数据
+                    break;
+                }
+                onHeader();
+                break;
+            }
+
+            case kPayload: {
+                auto size = MIN(_remain, (size_t)(end - ptr));
+                auto &stream = _streams[_stream_id];
+                if (stream.resync && !stream.bytes && size >= 4 && isVideo(_stream_id, stream.codecid)) {
+                    stream.resync = false;
+                    auto pos = (const uint8_t *)findStartCode((const char *)ptr, (const char *)ptr + 4);
+                    if (pos != ptr && (pos != ptr + 1 || ptr[0])) {
+                        // 新帧的开头随丢包一起丢失了，继续丢弃直到下个时间戳
+                        stream.corrupt = true;
+                        _state = kSkip;
+                        break;
+                    }
+                }
+                if (stream.bytes > kMaxFrameSize) {
+                    WarnL << "Ps frame too large: " << stream.bytes << ", stream id: " << _stream_id;
+                    flushStream(_stream_id, stream);
+                }
+                stream.slices.push_back({ buffer, ptr, size });
+                stream.bytes += size;
+                ptr += size;
+                _remain -= size;
+                if (!_remain) {
+                    // 音频pes一般就是一个完整的帧，无需等待下个pes
+                    if (!isVideo(_stream_id, stream.codecid)) {
+                        flushStream(_stream_id, stream);
+                    }
+                    _state = kHeader;
+                }
+                break;
+            }
+
+            case kSkip: {
+                auto size = MIN(_remain, (size_t)(end - ptr));
+                ptr += size;
+                _remain -= size;
+                if (!_remain) {
+                    _state = kHeader;
+                }
+                break;
+            }
+
+            default: /*不可达*/ assert(0); return -1;
+        }
+    }
+    return bytes;
+}
+
+void PSDecoder::reset() {
+    // 无法确定丢失的数据属于哪个流(可能包含其他流的pes头)，丢弃所有流未完成的帧
+    for (auto &pr : _streams) {
+        pr.second.slices.clear();
+        pr.second.bytes = 0;
+        pr.second.corrupt = true;
+        pr.second.resync = false;
+    }
+    _state = kSync;
+    _remain = 0;
+    _header.clear();
+}
+
+void PSDecoder::flush() {
+    for (auto &pr : _streams) {
+        flushStream(pr.first, pr.second);
+    }
+}
+
+size_t PSDecoder::getHeaderSize() const {
+    if (_header.size() < 4) {
+        return 4;
+    }
+    auto ptr = (const uint8_t *)_header.data();
+    if (ptr[0] != 0x00 || ptr[1] != 0x00 || ptr[2] != 0x01 || ptr[3] < 0xB9) {
+        return 0;
+    }
+    switch (ptr[3]) {
+        case 0xB9: {
+            // program end
+            return 4;
+        }
+        case 0xBA: {
+            // pack header
+            if (_header.size() < 5) {
+                return 5;
+            }
+            if ((ptr[4] & 0xF0) == 0x20) {
+                // mpeg1
+                return 12;
+            }
+            if ((ptr[4] & 0xC0) != 0x40) {
+                return 0;
+            }
+            if (_header.size() < 14) {
+                return 14;
+            }
+            // pack_stuffing_length
+            return 14 + (ptr[13] & 0x07);
         }
+        default: break;
+    }
+
+    if (_header.size() < 6) {
+        return 6;
+    }
+    size_t total = 6 + ((ptr[4] << 8) | ptr[5]);
+    if (ptr[3] == 0xBC) {
+        // psm整个读取到头部中解析
+        return total;
+    }
+    if (!isPES(ptr[3])) {
+        // system header、padding等，跳过负载
+        return 6;
+    }
+    if (total < 9) {
         return 0;
-    },this);
+    }
+    if (_header.size() < 9) {
+        return 9;
+    }
+    if ((ptr[6] & 0xC0) != 0x80) {
+        // mpeg1 pes，不支持，跳过负载
+        return 9;
+    }
+    auto size = 9 + ptr[8];
+    return size <= total ? size : 0;
+}
 
-    ps_demuxer_notify_t notify = {
-            [](void *param, int stream, int codecid, const void *extra, int bytes, int finish) {
-                PSDecoder *thiz = (PSDecoder *) param;
-                if (thiz->_on_stream) {
-                    thiz->_on_stream(stream, codecid, extra, bytes, finish);
-                }
+void PSDecoder::onHeader() {
+    auto ptr = (const uint8_t *)_header.data();
+    auto size = _header.size();
+    _state = kHeader;
+    switch (ptr[3]) {
+        case 0xB9:
+        case 0xBA: {
+            // 不需要scr，直接解析下个单元
+            break;
+        }
+        case 0xBC: {
+            onPSM(ptr, size);
+            break;
+        }
+        default: {
+            size_t total = 6 + ((ptr[4] << 8) | ptr[5]);
+            _remain = total - size;
+            if (!isPES(ptr[3]) || (ptr[6] & 0xC0) != 0x80) {
+                _state = _remain ? kSkip : kHeader;
+                break;
             }
-    };
-    ps_demuxer_set_notify((struct ps_demuxer_t *) _ps_demuxer, &notify, this);
+            onPES(ptr, size);
+            break;
+        }
+    }
+    _header.clear();
+}
+
+void PSDecoder::onPSM(const uint8_t *ptr, size_t size) {
+    // 6字节头、2字节版本等、2字节program_stream_info_length、2字节elementary_stream_map_length、4字节crc
+    if (size < 16) {
+        return;
+    }
+    size_t info_length = (ptr[8] << 8) | ptr[9];
+    size_t offset = 10 + info_length;
+    if (offset + 2 > size - 4) {
+        return;
+    }
+    size_t map_end = MIN(offset + 2 + ((ptr[offset] << 8) | ptr[offset + 1]), size - 4);
+    offset += 2;
+
+    std::vector<int> changed;
+    while (offset + 4 <= map_end) {
+        int codecid = ptr[offset];
+        int id = ptr[offset + 1];
+        offset += 4 + ((ptr[offset + 2] << 8) | ptr[offset + 3]);
+        auto &stream = _streams[id];
+        if (stream.codecid == codecid) {
+            continue;
+        }
+        // 编码格式变了，之前缓存的数据按照老的编码格式输出
+        flushStream(id, stream);
+        stream.codecid = codecid;
+        changed.emplace_back(id);
+    }
+
+    if (!_on_stream) {
+        return;
+    }
+    for (size_t i = 0; i < changed.size(); ++i) {
+        _on_stream(changed[i], _streams[changed[i]].codecid, nullptr, 0, i + 1 == changed.size());
+    }
 }
 
-PSDecoder::~PSDecoder() {
-    ps_demuxer_destroy((struct ps_demuxer_t*)_ps_demuxer);
+void PSDecoder::onPES(const uint8_t *ptr, size_t size) {
+    int id = ptr[3];
+    auto &stream = _streams[id];
+    if (stream.codecid ? getCodecByMpegId(stream.codecid) == CodecInvalid : !isVideo(id, 0)) {
+        // 不支持的编码格式或私有数据，无需缓存负载
+        _state = _remain ? kSkip : kHeader;
+        return;
+    }
+
+    auto flags = ptr[7] >> 6;
+    if ((flags & 0x02) && size >= 14) {
+        auto pts = readTimestamp(ptr + 9);
+        auto dts = (flags == 0x03 && size >= 19) ? readTimestamp(ptr + 14) : pts;
+        if (stream.corrupt && pts == stream.pts) {
+            // 部分设备每个pes都带时间戳，时间戳未变说明仍是残缺帧的后续数据
+            _state = _remain ? kSkip : kHeader;
+            return;
+        }
+        if (stream.bytes && pts != stream.pts) {
+            // 时间戳变了，说明上一帧已经完整
+            flushStream(id, stream);
+        }
+        if (!stream.bytes) {
+            stream.pts = pts;
+            stream.dts = dts;
+        }
+        stream.resync = stream.corrupt;
+        stream.corrupt = false;
+    }
+    if (stream.corrupt) {
+        // 丢包后的首个pes没有时间戳，是残缺帧的后续数据
+        _state = _remain ? kSkip : kHeader;
+        return;
+    }
+    // 无时间戳的pes为上一帧的后续数据，或者沿用上一帧的时间戳
+    _stream_id = id;
+    _state = _remain ? kPayload : kHeader;
 }
 
-ssize_t PSDecoder::input(const uint8_t *data, size_t bytes) {
-    HttpRequestSplitter::input(reinterpret_cast<const char *>(data), bytes);
-    return bytes;
+bool PSDecoder::guessCodec(Stream &stream, const char *ptr, size_t size) {
+    // 没有收到psm，根据负载中的vps/sps判断编码格式，在此之前的帧无法解码，直接丢弃
+    auto end = ptr + size;
+    while ((ptr = findStartCode(ptr, end)) && ptr + 4 < end) {
+        auto nal = (uint8_t)ptr[3];
+        if ((nal & 0x1F) == 7) {
+            // h264 sps
+            stream.codecid = PSI_STREAM_H264;
+        } else if (nal == 0x40 && ptr[4] == 0x01) {
+            // h265 vps，需要判断2字节nal头，否则会与h264 p帧(0x41)混淆
+            stream.codecid = PSI_STREAM_H265;
+        }
+        if (stream.codecid) {
+            InfoL << "Ps stream without psm, guess codec: " << getCodecName(getCodecByMpegId(stream.codecid));
+            return true;
+        }
+        ptr += 3;
+    }
+    return false;
 }
 
-const char *PSDecoder::onSearchPacketTail(const char *data, size_t len) {
-    try {
-        auto ret = ps_demuxer_input(static_cast<struct ps_demuxer_t *>(_ps_demuxer), reinterpret_cast<const uint8_t *>(data), len);
-        if (ret >= 0) {
-            //解析成功全部或部分
-            return data + ret;
+void PSDecoder::flushStream(int id, Stream &stream) {
+    if (!stream.bytes) {
+        return;
+    }
+
+    Buffer::Ptr buffer;
+    if (stream.slices.size() == 1) {
+        // 整帧在同一个输入buffer中，直接引用
+        auto &slice = stream.slices.front();
+        buffer = std::make_shared<BufferOffset<Buffer::Ptr> >(slice.buffer, slice.data - (const uint8_t *)slice.buffer->data(), slice.size);
+    } else {
+        // 跨包的帧，只拷贝一次
+        auto merged = PooledBuffer::create(stream.bytes);
+        auto dst = merged->data();
+        for (auto &slice : stream.slices) {
+            memcpy(dst, slice.data, slice.size);
+            dst += slice.size;
         }
+        merged->setSize(stream.bytes);
+        buffer = std::move(merged);
+    }
+    stream.slices.clear();
+    stream.bytes = 0;
 
-        //解析失败，丢弃所有数据
-        return data + len;
-    } catch (AssertFailedException &ex) {
-        InfoL << "解析 ps 异常: bytes=" << len
-              << ", exception=" << ex.what()
-              << ", hex=" << hexdump(data, MIN(len, 32));
-        //触发断言，解析失败，丢弃所有数据
-        return data + len;
+    if (!stream.codecid && !guessCodec(stream, buffer->data(), buffer->size())) {
+        return;
+    }
+    if (_on_decode_buffer) {
+        _on_decode_buffer(id, stream.codecid, 0, stream.pts, stream.dts, buffer);
+    } else if (_on_decode) {
+        _on_decode(id, stream.codecid, 0, stream.pts, stream.dts, buffer->data(), buffer->size());
     }
 }
 
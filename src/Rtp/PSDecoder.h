@@ -13,27 +13,79 @@
 
 #if defined(ENABLE_RTPPROXY)
 #include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include "Decoder.h"
-#include "Http/HttpRequestSplitter.h"
 
 namespace mediakit{
 
-//ps解析器
-class PSDecoder : public Decoder, private HttpRequestSplitter {
+/**
+ * ps解析器
+ * 直接在输入的数据(一般为rtp负载)上解析，跨包的pes负载只记录对输入buffer的引用，
+ * 一帧完整后只拷贝一次到内存池分配的buffer，整帧位于同一个输入buffer时直接引用不拷贝
+ */
+class PSDecoder : public Decoder {
 public:
+    // 单帧最大字节数，超过后强制输出，防止内存溢出
+    static constexpr size_t kMaxFrameSize = 16 * 1024 * 1024;
+
     PSDecoder();
-    ~PSDecoder();
+    ~PSDecoder() override = default;
 
-    ssize_t input(const uint8_t* data, size_t bytes) override;
+    ssize_t input(const uint8_t *data, size_t bytes) override;
+    ssize_t input(const toolkit::Buffer::Ptr &buffer, const uint8_t *data, size_t bytes) override;
+    void reset() override;
+    void flush() override;
 
-    // HttpRequestSplitter interface
 private:
-    using HttpRequestSplitter::input;
-    const char *onSearchPacketTail(const char *data, size_t len) override;
-    ssize_t onRecvHeader(const char *, size_t) override { return 0; };
+    // pes负载在输入buffer中的位置
+    struct Slice {
+        toolkit::Buffer::Ptr buffer;
+        const uint8_t *data;
+        size_t size;
+    };
+
+    struct Stream {
+        // psm中的stream_type，0表示未知
+        int codecid = 0;
+        int64_t pts = 0;
+        int64_t dts = 0;
+        size_t bytes = 0;
+        // 丢包后该流的数据不完整，丢弃负载直到下个带时间戳的pes(新帧的开始)
+        bool corrupt = false;
+        // 丢包后的首个新帧，需要校验视频负载以起始码开头，否则该帧的开头也已丢失
+        bool resync = false;
+        std::vector<Slice> slices;
+    };
+
+    enum State {
+        // 查找起始码
+        kSync,
+        // 读取ps单元头部
+        kHeader,
+        // 读取pes负载
+        kPayload,
+        // 跳过不需要的数据
+        kSkip
+    };
+
+    size_t getHeaderSize() const;
+    void onHeader();
+    void onPSM(const uint8_t *ptr, size_t size);
+    void onPES(const uint8_t *ptr, size_t size);
+    void flushStream(int id, Stream &stream);
+    bool guessCodec(Stream &stream, const char *ptr, size_t size);
 
 private:
-    void *_ps_demuxer = nullptr;
+    State _state = kSync;
+    // 当前pes所属的流
+    int _stream_id = -1;
+    // 当前pes负载或需要跳过的剩余字节数
+    size_t _remain = 0;
+    // ps单元头部，头部一般很短，跨包时拷贝到此处
+    std::string _header;
+    std::unordered_map<int, Stream> _streams;
 };
 
 }//namespace mediakit
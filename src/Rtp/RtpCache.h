@@ -32,7 +32,7 @@ protected:
     void input(uint64_t stamp, toolkit::Buffer::Ptr buffer,bool is_key = false);
 
 protected:
-    void onFlush(std::shared_ptr<toolkit::List<toolkit::Buffer::Ptr> > rtp_list, bool) override;
+    void onFlush(std::shared_ptr<LatencyList<toolkit::Buffer::Ptr> > rtp_list, bool) override;
 
 private:
     onFlushed _cb;
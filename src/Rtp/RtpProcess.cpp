@@ -13,6 +13,7 @@
 #include "RtpProcess.h"
 #include "Util/File.h"
 #include "Common/config.h"
+#include "Common/Metrics.h"
 
 using namespace std;
 using namespace toolkit;
@@ -87,7 +88,7 @@ void RtpProcess::onManager() {
 void RtpProcess::createTimer() {
     //创建超时管理定时器
     weak_ptr<RtpProcess> weakSelf = shared_from_this();
-    _timer = std::make_shared<Timer>(3.0f, [weakSelf] {
+    _timer = std::make_shared<WheelTimer>(3.0f, [weakSelf] {
         auto strongSelf = weakSelf.lock();
         if (!strongSelf) {
             return false;
@@ -116,6 +117,7 @@ bool RtpProcess::inputRtp(bool is_udp, const Socket::Ptr &sock, const char *data
     }
 
     _total_bytes += len;
+    Metrics::add(Metrics::kRtpBytesIn, len);
     if (_save_file_rtp) {
         uint16_t size = (uint16_t)len;
         size = htons(size);
@@ -15,6 +15,7 @@
 #include "ProcessInterface.h"
 #include "Rtcp/RtcpContext.h"
 #include "Common/MultiMediaSourceMuxer.h"
+#include "Common/TimerWheel.h"
 
 namespace mediakit {
 
@@ -114,7 +115,7 @@ private:
     ProcessInterface::Ptr _process;
     MultiMediaSourceMuxer::Ptr _muxer;
     std::atomic_bool _stop_rtp_check{false};
-    toolkit::Timer::Ptr _timer;
+    WheelTimer::Ptr _timer;
     toolkit::Ticker _last_check_alive;
     std::recursive_mutex _func_mtx;
     std::deque<std::function<void()> > _cached_func;
@@ -16,6 +16,7 @@
 #include "Util/uv_errno.h"
 #include "RtpCache.h"
 #include "Rtcp/RtcpContext.h"
+#include "Common/config.h"
 
 using namespace std;
 using namespace toolkit;
@@ -318,20 +319,56 @@ void RtpSender::onFlushRtpList(shared_ptr<List<Buffer::Ptr> > rtp_list) {
         return;
     }
 
+    if (_args.is_udp) {
+        GET_CONFIG(float, pacer_ratio, RtpProxy::kPacerRatio);
+        if (pacer_ratio <= 0 && (!_pacer || !_pacer->getCacheBytes())) {
+            // 未开启平滑发送，直接发送
+            _pacer = nullptr;
+            size_t i = 0;
+            auto size = rtp_list->size();
+            rtp_list->for_each([&](Buffer::Ptr &packet) { sendRtpUdp(std::move(packet), ++i == size); });
+            return;
+        }
+        if (!_pacer) {
+            weak_ptr<RtpSender> weak_self = shared_from_this();
+            _pacer = std::make_shared<PacketPacer<Buffer::Ptr> >([weak_self](Buffer::Ptr packet, bool flush) {
+                if (auto strong_self = weak_self.lock()) {
+                    strong_self->sendRtpUdp(std::move(packet), flush);
+                }
+            });
+        }
+        _pacer->setRatio(pacer_ratio);
+        rtp_list->for_each([&](Buffer::Ptr &packet) { _pacer->inputPacket(std::move(packet)); });
+        // 关键帧等突发数据按照码率平滑发送
+        _pacer->flush();
+        return;
+    }
+
     size_t i = 0;
     auto size = rtp_list->size();
     rtp_list->for_each([&](Buffer::Ptr &packet) {
-        if (_args.is_udp) {
-            onSendRtpUdp(packet, i == 0);
-            // udp模式，rtp over tcp前4个字节可以忽略
-            _socket_rtp->send(std::make_shared<BufferRtp>(std::move(packet), RtpPacket::kRtpTcpHeaderSize), nullptr, 0, ++i == size);
-        } else {
-            // tcp模式, rtp over tcp前2个字节可以忽略,只保留后续rtp长度的2个字节
-            _socket_rtp->send(std::make_shared<BufferRtp>(std::move(packet), 2), nullptr, 0, ++i == size);
-        }
+        // tcp模式, rtp over tcp前2个字节可以忽略,只保留后续rtp长度的2个字节
+        _socket_rtp->send(std::make_shared<BufferRtp>(std::move(packet), 2), nullptr, 0, ++i == size);
     });
 }
 
+void RtpSender::sendRtpUdp(Buffer::Ptr packet, bool flush) {
+    onSendRtpUdp(packet, _check_rtcp);
+    // 每批次的第一个包检查一次rtcp
+    _check_rtcp = flush;
+    // udp模式，rtp over tcp前4个字节可以忽略
+    auto buf = std::make_shared<BufferRtp>(std::move(packet), RtpPacket::kRtpTcpHeaderSize);
+    if (UdpBatchSender::isEnabled()) {
+        _batch_sender.inputPacket(std::move(buf));
+        if (flush) {
+            // 一次系统调用发送整批rtp
+            _batch_sender.flush(_socket_rtp);
+        }
+    } else {
+        _socket_rtp->send(std::move(buf), nullptr, 0, flush);
+    }
+}
+
 void RtpSender::onErr(const SockException &ex) {
     _is_connect = false;
     WarnL << "send rtp connection lost: " << ex;
@@ -16,6 +16,8 @@
 #include "Rtcp/RtcpContext.h"
 #include "Common/MediaSource.h"
 #include "Common/MediaSink.h"
+#include "Common/UdpBatchSender.h"
+#include "Common/PacketPacer.h"
 
 namespace mediakit{
 
@@ -75,6 +77,8 @@ private:
     void createRtcpSocket();
     void onRecvRtcp(RtcpHeader *rtcp);
     void onSendRtpUdp(const toolkit::Buffer::Ptr &buf, bool check);
+    //发送一个udp rtp，flush为本批次最后一个包
+    void sendRtpUdp(toolkit::Buffer::Ptr packet, bool flush);
     void onClose(const toolkit::SockException &ex);
 
 private:
@@ -82,6 +86,9 @@ private:
     MediaSourceEvent::SendRtpArgs _args;
     toolkit::Socket::Ptr _socket_rtp;
     toolkit::Socket::Ptr _socket_rtcp;
+    bool _check_rtcp = true;
+    UdpBatchSender _batch_sender;
+    PacketPacer<toolkit::Buffer::Ptr>::Ptr _pacer;
     toolkit::EventPoller::Ptr _poller;
     MediaSinkInterface::Ptr _interface;
     std::shared_ptr<RtcpContext> _rtcp_context;
@@ -14,6 +14,7 @@
 #include "RtpProcess.h"
 #include "Rtcp/RtcpContext.h"
 #include "Common/config.h"
+#include "Common/UdpBatchReceiver.h"
 
 using namespace std;
 using namespace toolkit;
@@ -146,6 +147,7 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
     //创建udp服务器
     UdpServer::Ptr udp_server;
     RtcpHelper::Ptr helper;
+    UdpBatchReceiver::Ptr batch_receiver;
     //增加了多路复用判断，如果多路复用为true，就走else逻辑，同时保留了原来stream_id为空走else逻辑
     if (!stream_id.empty() && !multiplex) {
         //指定了流id，那么一个端口一个流(不管是否包含多个ssrc的多个流，绑定rtp源后，会筛选掉ip端口不匹配的流)
@@ -155,7 +157,7 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
         bool bind_peer_addr = false;
         auto ssrc_ptr = std::make_shared<uint32_t>(ssrc);
         _ssrc = ssrc_ptr;
-        rtp_socket->setOnRead([rtp_socket, helper, ssrc_ptr, bind_peer_addr](const Buffer::Ptr &buf, struct sockaddr *addr, int addr_len) mutable {
+        auto on_read = [rtp_socket, helper, ssrc_ptr, bind_peer_addr](const Buffer::Ptr &buf, struct sockaddr *addr, int addr_len) mutable {
             RtpHeader *header = (RtpHeader *)buf->data();
             auto rtp_ssrc = ntohl(header->ssrc);
             auto ssrc = *ssrc_ptr;
@@ -169,7 +171,29 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
                 }
                 helper->onRecvRtp(rtp_socket, buf, addr);
             }
-        });
+        };
+
+        auto batch_size = UdpBatchReceiver::getBatchSize();
+        if (batch_size && tcp_mode != ACTIVE) {
+            // 批量接收，每次唤醒通过recvmmsg读取多个包(tcp主动模式下rtp_socket会被复用为tcp socket)
+            batch_receiver = std::make_shared<UdpBatchReceiver>(batch_size);
+            batch_receiver->setOnRead([on_read](Buffer::Ptr *buf, struct sockaddr_storage *addr, size_t count) mutable {
+                for (size_t i = 0; i < count; ++i) {
+                    auto addr_len = addr[i].ss_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+                    on_read(buf[i], (struct sockaddr *)(addr + i), (int)addr_len);
+                }
+            });
+            batch_receiver->setOnErr([stream_id](const SockException &err) {
+                // socket已关闭，不再收到rtp，rtp代理超时后释放
+                WarnL << "Rtp udp socket err, stream_id: " << stream_id << ", " << err;
+            });
+            if (!batch_receiver->attach(rtp_socket)) {
+                batch_receiver = nullptr;
+            }
+        }
+        if (!batch_receiver) {
+            rtp_socket->setOnRead(std::move(on_read));
+        }
     } else {
         //单端口多线程接收多个流，根据ssrc区分流
         udp_server = std::make_shared<UdpServer>();
@@ -198,11 +222,15 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
         }
     }
 
-    _on_cleanup = [rtp_socket, stream_id]() {
+    _on_cleanup = [rtp_socket, batch_receiver, stream_id]() {
         if (rtp_socket) {
             //去除循环引用
             rtp_socket->setOnRead(nullptr);
         }
+        if (batch_receiver) {
+            batch_receiver->setOnRead(nullptr);
+            batch_receiver->setOnErr(nullptr);
+        }
     };
 
     _tcp_server = tcp_server;
@@ -13,11 +13,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <memory>
 #include "Rtsp/Rtsp.h"
 #include "Extension/Frame.h"
 // for NtpStamp
 #include "Common/Stamp.h"
+#include "Common/Metrics.h"
 #include "Util/TimeTicker.h"
 
 namespace mediakit {
@@ -26,7 +28,8 @@ template<typename T, typename SEQ = uint16_t>
 class PacketSortor {
 public:
     static constexpr SEQ SEQ_MAX = (std::numeric_limits<SEQ>::max)();
-    using iterator = typename std::map<SEQ, T>::iterator;
+    // 连续收到多少个远远落后的包后认为seq发生跳变
+    static constexpr size_t kMaxFarBehindCount = 16;
 
     virtual ~PacketSortor() = default;
 
@@ -37,14 +40,21 @@ public:
      */
     void clear() {
         _started = false;
+        _far_behind_count = 0;
         _ticker.resetTime();
-        _pkt_sort_cache_map.clear();
+        if (_count) {
+            for (auto &slot : _slots) {
+                slot.used = false;
+                slot.packet = T();
+            }
+            _count = 0;
+        }
     }
 
     /**
      * 获取排序缓存长度
      */
-    size_t getJitterSize() const { return _pkt_sort_cache_map.size(); }
+    size_t getJitterSize() const { return _count; }
 
     /**
      * 输入并排序
@@ -58,115 +68,131 @@ public:
             _started = true;
             _last_seq_out = seq - 1;
         }
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        if (seq == next_seq) {
+        auto offset = distance(seq);
+        if (offset == 0) {
             // 收到下一个seq
+            _far_behind_count = 0;
             output(seq, std::move(packet));
             // 清空连续包列表
             flushPacket();
             return;
         }
 
-        if (seq < next_seq && !mayLooped(next_seq, seq)) {
-            // 无回环风险, 过滤seq回退包
+        if (offset > SEQ_MAX >> 1) {
+            // seq在next_seq之前(已经回环处理), 过滤seq回退包
+            if (static_cast<SEQ>(-offset) > _max_distance && ++_far_behind_count > kMaxFarBehindCount) {
+                // 连续收到大量远远落后的包，说明对端seq发生了跳变(例如推流端重启)，重新同步
+                flush();
+                _far_behind_count = 0;
+                _last_seq_out = seq - 1;
+                output(seq, std::move(packet));
+            }
             return;
         }
-        _pkt_sort_cache_map.emplace(seq, std::move(packet));
-
-        if (needForceFlush(seq)) {
-            forceFlush(next_seq);
-        }
+        _far_behind_count = 0;
+        cachePacket(seq, offset, std::move(packet));
     }
 
     void flush() {
-        if (!_pkt_sort_cache_map.empty()) {
-            forceFlush(static_cast<SEQ>(_last_seq_out + 1));
-            _pkt_sort_cache_map.clear();
+        while (_count) {
+            forceFlush();
         }
     }
 
     void setParams(size_t max_buffer_size, size_t max_buffer_ms, size_t max_distance) {
+        // 排序窗口大小变化前先输出已缓存的包
+        flush();
         _max_buffer_size = max_buffer_size;
         _max_buffer_ms = max_buffer_ms;
-        _max_distance = max_distance;
+        _max_distance = (std::min)(max_distance, (size_t)(SEQ_MAX >> 1));
+        // 环形数组长度取2的次幂，能容纳[next_seq, next_seq + max_distance]整个窗口
+        size_t capacity = 1;
+        while (capacity <= _max_distance) {
+            capacity <<= 1;
+        }
+        if (capacity != _mask + 1) {
+            _mask = capacity - 1;
+            _slots.clear();
+            _slots.shrink_to_fit();
+        }
     }
 
 private:
-    SEQ distance(SEQ seq) {
-        SEQ ret;
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        if (seq > next_seq) {
-            ret = seq - next_seq;
-        } else {
-            ret = next_seq - seq;
+    // 乱序包放入排序缓存，offset为seq相对next_seq的偏移
+    void cachePacket(SEQ seq, SEQ offset, T packet) {
+        if (offset > _max_distance) {
+            // seq跳跃太大，按序输出缓存直至新包落入排序窗口
+            while (_count && distance(seq) > _max_distance) {
+                forceFlush();
+            }
+            offset = distance(seq);
+            if (offset > _max_distance || offset == 0) {
+                // 缓存已经清空仍然无法落入排序窗口，丢包无法恢复，把这个包当做next_seq
+                output(seq, std::move(packet));
+                flushPacket();
+                return;
+            }
         }
-        if (ret > SEQ_MAX >> 1) {
-            return SEQ_MAX - ret;
+
+        if (_slots.empty()) {
+            // 按需分配，无乱序的流不占用排序缓存
+            _slots.resize(_mask + 1);
         }
-        return ret;
-    }
+        auto &slot = _slots[seq & _mask];
+        if (slot.used) {
+            // 重复包
+            return;
+        }
+        slot.used = true;
+        slot.packet = std::move(packet);
+        ++_count;
 
-    bool needForceFlush(SEQ seq) {
-        return !_pkt_sort_cache_map.empty() && (_pkt_sort_cache_map.size() > _max_buffer_size ||
-               distance(seq) > _max_distance || _ticker.elapsedTime() > _max_buffer_ms);
+        if (_count > _max_buffer_size || _ticker.elapsedTime() > _max_buffer_ms) {
+            forceFlush();
+        }
     }
 
-    //外部调用代码确保_pkt_sort_cache_map不为空
-    void forceFlush(SEQ next_seq) {
-        // 寻找距离比next_seq大的最近的seq
-        auto it = _pkt_sort_cache_map.lower_bound(next_seq);
-        if (it == _pkt_sort_cache_map.end()) {
-            // 没有比next_seq更大的seq，应该是回环时丢包导致
-            it = _pkt_sort_cache_map.begin();
+    // seq相对next_seq的偏移，大于SEQ_MAX / 2时说明seq在next_seq之前
+    SEQ distance(SEQ seq) const { return static_cast<SEQ>(seq - _last_seq_out - 1); }
+
+    //外部调用代码确保缓存不为空
+    void forceFlush() {
+        // 寻找距离next_seq最近的seq，丢包无法恢复，把这个包当做next_seq
+        auto seq = static_cast<SEQ>(_last_seq_out + 2);
+        while (!_slots[seq & _mask].used) {
+            ++seq;
         }
-        // 丢包无法恢复，把这个包当做next_seq
-        popIterator(it);
+        popSlot(seq);
         // 清空连续包列表
         flushPacket();
-        // 删除距离next_seq太大的包
-        for (auto it = _pkt_sort_cache_map.begin(); it != _pkt_sort_cache_map.end();) {
-            if (distance(it->first) > _max_distance) {
-                it = _pkt_sort_cache_map.erase(it);
-            } else {
-                ++it;
-            }
-        }
     }
 
-    bool mayLooped(SEQ last_seq, SEQ now_seq) { return last_seq > SEQ_MAX - _max_distance || now_seq < _max_distance; }
-
     void flushPacket() {
-        if (_pkt_sort_cache_map.empty()) {
-            return;
-        }
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        auto it = _pkt_sort_cache_map.lower_bound(next_seq);
-        if (!mayLooped(next_seq, next_seq)) {
-            // 无回环风险, 清空 < next_seq的值
-            it = _pkt_sort_cache_map.erase(_pkt_sort_cache_map.begin(), it);
-        }
-
-        while (it != _pkt_sort_cache_map.end()) {
+        while (_count) {
             // 找到下一个包
-            if (it->first == static_cast<SEQ>(_last_seq_out + 1)) {
-                it = popIterator(it);
-                continue;
+            auto seq = static_cast<SEQ>(_last_seq_out + 1);
+            if (!_slots[seq & _mask].used) {
+                break;
             }
-            break;
+            popSlot(seq);
         }
     }
 
-    iterator popIterator(iterator it) {
-        output(it->first, std::move(it->second));
-        return _pkt_sort_cache_map.erase(it);
+    void popSlot(SEQ seq) {
+        auto &slot = _slots[seq & _mask];
+        slot.used = false;
+        --_count;
+        output(seq, std::move(slot.packet));
+        slot.packet = T();
     }
 
     void output(SEQ seq, T packet) {
         auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
         if (seq != next_seq) {
+            mediakit::Metrics::add(mediakit::Metrics::kDropRtpSort, static_cast<SEQ>(seq - next_seq));
             WarnL << "packet dropped: " << next_seq << " -> " << static_cast<SEQ>(seq - 1)
                   << ", latest seq: " << _latest_seq
-                  << ", jitter buffer size: " << _pkt_sort_cache_map.size()
+                  << ", jitter buffer size: " << _count
                   << ", jitter buffer ms: " << _ticker.elapsedTime();
         }
         _last_seq_out = seq;
@@ -175,6 +201,11 @@ private:
     }
 
 private:
+    struct Slot {
+        bool used = false;
+        T packet {};
+    };
+
     bool _started = false;
     // 排序缓存最大保存数据长度，单位毫秒
     size_t _max_buffer_ms = 1000;
@@ -182,14 +213,20 @@ private:
     size_t _max_buffer_size = 1024;
     // seq最大跳跃距离
     size_t _max_distance = 256;
+    // 排序缓存中的包个数
+    size_t _count = 0;
+    // 连续收到远远落后的包的个数
+    size_t _far_behind_count = 0;
+    // 环形数组下标掩码，默认512个槽位
+    size_t _mask = 511;
     // 记录上次output至今的时间
     toolkit::Ticker _ticker;
     // 最近输入的seq
     SEQ _latest_seq = 0;
     // 下次应该输出的SEQ
     SEQ _last_seq_out = 0;
-    // pkt排序缓存，根据seq排序
-    std::map<SEQ, T> _pkt_sort_cache_map;
+    // pkt排序缓存，以seq & _mask为下标的环形数组
+    std::vector<Slot> _slots;
     // 回调
     std::function<void(SEQ seq, T packet)> _cb;
 };
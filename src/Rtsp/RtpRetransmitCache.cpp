@@ -0,0 +1,207 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "RtpRetransmitCache.h"
+
+using namespace std;
+
+namespace mediakit {
+
+// 缓存初始长度
+static constexpr size_t kMinCacheSize = 256;
+
+void RtpSeqCache::setParams(size_t max_size, uint32_t max_ms, uint32_t check_interval) {
+    _max_size = max_size;
+    _max_ms = max_ms;
+    _check_interval = check_interval;
+}
+
+void RtpSeqCache::pushBack(RtpPacket::Ptr rtp) {
+    if (_cache.empty()) {
+        _cache.resize(kMinCacheSize);
+    }
+    auto seq = rtp->getSeq();
+    if (_begin_seq == _end_seq) {
+        // 缓存为空
+        _begin_seq = _end_seq = seq;
+    }
+    uint16_t offset = seq - _begin_seq;
+    if (offset > (UINT16_MAX >> 1)) {
+        if ((uint16_t)(_end_seq - seq) <= MIN(_max_size, (size_t)(UINT16_MAX >> 1))) {
+            // 乱序的旧包，比缓存中最早的包还旧，忽略
+            return;
+        }
+        // seq大幅回退，不可能是乱序，说明seq重新开始了(推流端重启等)，
+        // 否则之后的包都会被当作旧包忽略，缓存将一直停留在回退前的seq
+        clear();
+        _begin_seq = _end_seq = seq;
+        offset = 0;
+    }
+    if (offset < (uint16_t)(_end_seq - _begin_seq)) {
+        // 在缓存范围内，覆盖之
+        getSlot(seq) = std::move(rtp);
+        return;
+    }
+
+    while ((uint16_t)(seq - _begin_seq) >= _cache.size()) {
+        if (_cache.size() < _max_size) {
+            growCache();
+            continue;
+        }
+        // 缓存已满，移除最早的包
+        popFront();
+        if (_begin_seq == _end_seq) {
+            _begin_seq = _end_seq = seq;
+        }
+    }
+    getSlot(seq) = std::move(rtp);
+    _end_seq = seq + 1;
+
+    if (++_cache_ms_check < _check_interval) {
+        return;
+    }
+    _cache_ms_check = 0;
+    while (getCacheMS() >= _max_ms) {
+        // 需要清除部分nack缓存
+        popFront();
+    }
+}
+
+void RtpSeqCache::pushFront(RtpPacket::Ptr rtp) {
+    if (_begin_seq == _end_seq) {
+        // 缓存为空
+        pushBack(std::move(rtp));
+        return;
+    }
+    auto seq = rtp->getSeq();
+    uint16_t offset = _begin_seq - seq;
+    if (!offset || offset > (UINT16_MAX >> 1)) {
+        // 不比缓存中最早的包旧，忽略
+        return;
+    }
+    while ((uint16_t)(_end_seq - seq) > _cache.size()) {
+        if (_cache.size() >= _max_size) {
+            // 缓存已满，更旧的包不再插入
+            return;
+        }
+        growCache();
+    }
+    getSlot(seq) = std::move(rtp);
+    _begin_seq = seq;
+}
+
+void RtpSeqCache::clear() {
+    for (auto seq = _begin_seq; seq != _end_seq; ++seq) {
+        getSlot(seq).reset();
+    }
+    _begin_seq = _end_seq = 0;
+    _cache_ms_check = 0;
+}
+
+void RtpSeqCache::popFront() {
+    if (_begin_seq == _end_seq) {
+        return;
+    }
+    getSlot(_begin_seq++).reset();
+    // 跳过未发送的seq，保证首个包总是存在
+    while (_begin_seq != _end_seq && !getSlot(_begin_seq)) {
+        ++_begin_seq;
+    }
+}
+
+void RtpSeqCache::growCache() {
+    std::vector<RtpPacket::Ptr> cache(_cache.size() * 2);
+    for (auto seq = _begin_seq; seq != _end_seq; ++seq) {
+        cache[seq & (cache.size() - 1)] = std::move(getSlot(seq));
+    }
+    _cache.swap(cache);
+}
+
+RtpPacket::Ptr *RtpSeqCache::getRtp(uint16_t seq) {
+    if ((uint16_t)(seq - _begin_seq) >= (uint16_t)(_end_seq - _begin_seq)) {
+        // 不在缓存范围内
+        return nullptr;
+    }
+    auto &ref = getSlot(seq);
+    return ref ? &ref : nullptr;
+}
+
+uint32_t RtpSeqCache::getCacheMS() {
+    if ((uint16_t)(_end_seq - _begin_seq) <= 2) {
+        return 0;
+    }
+    int64_t front_stamp = getSlot(_begin_seq)->getStampMS(false);
+    int64_t back_stamp = getSlot(_end_seq - 1)->getStampMS(false);
+    if (back_stamp >= front_stamp) {
+        return back_stamp - front_stamp;
+    }
+    // 很有可能回环了
+    return back_stamp + (UINT32_MAX - front_stamp);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RtpRetransmitCache::enable(size_t max_size, uint32_t max_ms, uint32_t check_interval) {
+    lock_guard<mutex> lck(_mtx);
+    for (auto &cache : _cache) {
+        cache.setParams(max_size, max_ms, check_interval);
+    }
+    ++_users;
+    _enabled = true;
+}
+
+void RtpRetransmitCache::disable() {
+    lock_guard<mutex> lck(_mtx);
+    if (!_users || --_users) {
+        return;
+    }
+    _enabled = false;
+    for (auto &cache : _cache) {
+        cache = RtpSeqCache();
+    }
+}
+
+void RtpRetransmitCache::input(const RtpPacketList &rtp_list) {
+    lock_guard<mutex> lck(_mtx);
+    if (!_users) {
+        // 检查enabled()后最后一个播放器离开了
+        return;
+    }
+    for (auto &rtp : rtp_list) {
+        if (rtp->type >= 0 && rtp->type < TrackMax) {
+            _cache[rtp->type].pushBack(rtp);
+        }
+    }
+}
+
+void RtpRetransmitCache::seed(const std::vector<RtpPacket::Ptr> &rtps) {
+    lock_guard<mutex> lck(_mtx);
+    if (!_users) {
+        return;
+    }
+    // 从新到旧插入到缓存头部
+    for (auto it = rtps.rbegin(); it != rtps.rend(); ++it) {
+        auto &rtp = *it;
+        if (rtp->type >= 0 && rtp->type < TrackMax) {
+            _cache[rtp->type].pushFront(rtp);
+        }
+    }
+}
+
+RtpPacket::Ptr RtpRetransmitCache::getRtp(TrackType type, uint16_t seq) {
+    if (type < 0 || type >= TrackMax) {
+        return nullptr;
+    }
+    lock_guard<mutex> lck(_mtx);
+    auto ptr = _cache[type].getRtp(seq);
+    return ptr ? *ptr : nullptr;
+}
+
+} // namespace mediakit
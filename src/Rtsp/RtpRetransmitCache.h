@@ -0,0 +1,112 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_RTPRETRANSMITCACHE_H
+#define ZLMEDIAKIT_RTPRETRANSMITCACHE_H
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include "Rtsp.h"
+
+namespace mediakit {
+
+/**
+ * 以seq为下标的rtp环形缓存，用于响应nack重传请求
+ * 缓存长度按需翻倍增长，达到max_size后丢弃最早的包；缓存时长超过max_ms后也会丢弃最早的包
+ * seq大幅回退(超出max_size，推流端重启等)时清空缓存，从新的seq重新开始缓存
+ */
+class RtpSeqCache {
+public:
+    /**
+     * 设置缓存参数
+     * @param max_size 最大缓存包个数(向上取整为2的次幂)
+     * @param max_ms 最大缓存时长，单位毫秒
+     * @param check_interval 每输入多少个包检查一次缓存时长
+     */
+    void setParams(size_t max_size, uint32_t max_ms, uint32_t check_interval);
+
+    void pushBack(RtpPacket::Ptr rtp);
+
+    /**
+     * 在缓存头部插入比最早的包更旧的rtp，缓存已满时忽略
+     * 需要按照seq从新到旧的顺序插入
+     */
+    void pushFront(RtpPacket::Ptr rtp);
+
+    /**
+     * 根据seq查找rtp，不存在时返回nullptr
+     */
+    RtpPacket::Ptr *getRtp(uint16_t seq);
+
+private:
+    void clear();
+    void popFront();
+    void growCache();
+    uint32_t getCacheMS();
+    RtpPacket::Ptr &getSlot(uint16_t seq) { return _cache[seq & (_cache.size() - 1)]; }
+
+private:
+    size_t _max_size = 8192;
+    uint32_t _max_ms = 5 * 1000;
+    uint32_t _check_interval = 100;
+    uint32_t _cache_ms_check = 0;
+    // 缓存的rtp seq范围为[_begin_seq, _end_seq)，首尾的包总是存在
+    uint16_t _begin_seq = 0;
+    uint16_t _end_seq = 0;
+    // 长度为2的次幂，不在缓存范围内的槽位为空
+    std::vector<RtpPacket::Ptr> _cache;
+};
+
+/**
+ * rtsp源的rtp重传缓存，同一个源的所有webrtc播放器共享，各track的seq分开缓存
+ * 在源的线程写入，在各播放器线程查找，所以需要加锁；写入以批量rtp为单位，每批只加锁一次
+ * 播放器发送的rtp seq与源一致(只修改ssrc/pt/rtp ext)，所以可以直接用nack中的seq查找
+ */
+class RtpRetransmitCache {
+public:
+    using Ptr = std::shared_ptr<RtpRetransmitCache>;
+
+    /**
+     * 增加一个使用者，首个需要重传的播放器开启后才开始缓存rtp
+     */
+    void enable(size_t max_size, uint32_t max_ms, uint32_t check_interval);
+
+    /**
+     * 减少一个使用者，最后一个使用者离开后停止缓存并释放内存
+     */
+    void disable();
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    void input(const RtpPacketList &rtp_list);
+
+    /**
+     * 使用播放器回放的gop填充缓存，补齐开启缓存前已经写入环形缓存的rtp
+     * 只插入比缓存中最早的包更旧的rtp
+     * @param rtps 按照发送顺序排列的rtp
+     */
+    void seed(const std::vector<RtpPacket::Ptr> &rtps);
+
+    /**
+     * 根据track类型与seq查找rtp，不存在时返回nullptr
+     */
+    RtpPacket::Ptr getRtp(TrackType type, uint16_t seq);
+
+private:
+    std::atomic<bool> _enabled { false };
+    size_t _users = 0;
+    std::mutex _mtx;
+    RtpSeqCache _cache[TrackMax];
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_RTPRETRANSMITCACHE_H
@@ -495,6 +495,24 @@ bool isRtcp(const char *buf, size_t size) {
     return ((header->pt >= 64) && (header->pt < 96));
 }
 
+const Buffer::Ptr &RtpPacketList::getTcpBuffer() const {
+    // 不同线程的播放器可能同时读取该列表
+    std::call_once(_tcp_flag, [this]() {
+        size_t size = 0;
+        for_each([&](const RtpPacket::Ptr &rtp) { size += rtp->size(); });
+        auto buffer = BufferRaw::create();
+        buffer->setCapacity(size + 1);
+        auto ptr = buffer->data();
+        for_each([&](const RtpPacket::Ptr &rtp) {
+            memcpy(ptr, rtp->data(), rtp->size());
+            ptr += rtp->size();
+        });
+        buffer->setSize(size);
+        _tcp_buffer = std::move(buffer);
+    });
+    return _tcp_buffer;
+}
+
 Buffer::Ptr makeRtpOverTcpPrefix(uint16_t size, uint8_t interleaved) {
     auto rtp_tcp = BufferRaw::create();
     rtp_tcp->setCapacity(RtpPacket::kRtpTcpHeaderSize);
@@ -630,17 +648,8 @@ size_t RtpPacket::getPayloadSize() const {
 }
 
 RtpPacket::Ptr RtpPacket::create() {
-#if 0
-    static ResourcePool<RtpPacket> packet_pool;
-    static onceToken token([]() {
-        packet_pool.setSize(1024);
-    });
-    auto ret = packet_pool.obtain2();
-    ret->setSize(0);
-    return ret;
-#else
-    return Ptr(new RtpPacket);
-#endif
+    // 对象、控制块与负载都从线程缓存内存池分配
+    return makePooledShared(new RtpPacket);
 }
 
 /**
@@ -14,6 +14,10 @@
 #include "Common/macros.h"
 #include "Extension/Frame.h"
 #include "Network/Socket.h"
+#include "Util/List.h"
+#include "Common/LatencyStat.h"
+#include "Common/PacketPool.h"
+#include <mutex>
 #include <memory>
 #include <string.h>
 #include <string>
@@ -135,7 +139,7 @@ private:
 #pragma pack(pop)
 
 // 此rtp为rtp over tcp形式，需要忽略前4个字节
-class RtpPacket : public toolkit::BufferRaw {
+class RtpPacket : public PooledBuffer {
 public:
     using Ptr = std::shared_ptr<RtpPacket>;
     enum { kRtpVersion = 2, kRtpHeaderSize = 12, kRtpTcpHeaderSize = 4 };
@@ -179,6 +183,33 @@ private:
     toolkit::ObjectStatistic<RtpPacket> _statistic;
 };
 
+/**
+ * 合并写的rtp包列表
+ * 由于rtsp播放时interleaved由服务器决定(2 * TrackType)，所有rtsp tcp播放器的interleaved映射都相同，
+ * 可以共享一个合并后的rtp over tcp缓存，每个播放器只需增加引用计数并发送一次
+ */
+class RtpPacketList : public LatencyList<RtpPacket::Ptr> {
+public:
+    using Ptr = std::shared_ptr<RtpPacketList>;
+
+    /**
+     * 获取合并后的rtp over tcp数据(每个包含4个字节的interleaved头)
+     * 首次调用时生成，之后直接返回，线程安全
+     */
+    const toolkit::Buffer::Ptr &getTcpBuffer() const;
+
+    /**
+     * 是否以视频关键帧开头，播放器可据此切换流
+     */
+    void setKeyPos(bool key_pos) { _key_pos = key_pos; }
+    bool isKeyPos() const { return _key_pos; }
+
+private:
+    bool _key_pos = false;
+    mutable std::once_flag _tcp_flag;
+    mutable toolkit::Buffer::Ptr _tcp_buffer;
+};
+
 class RtpPayload {
 public:
     static int getClockRate(int pt);
@@ -17,6 +17,7 @@
 #include <functional>
 #include "Common/MediaSource.h"
 #include "Common/PacketCache.h"
+#include "Rtsp/RtpRetransmitCache.h"
 #include "Util/RingBuffer.h"
 
 #define RTP_GOP_SIZE 512
@@ -29,10 +30,10 @@ namespace mediakit {
  * 只要生成了这两要素，那么要实现rtsp推流、rtsp服务器就很简单了
  * rtsp推拉流协议中，先传递sdp，然后再协商传输方式(tcp/udp/组播)，最后一直传递rtp
  */
-class RtspMediaSource : public MediaSource, public toolkit::RingDelegate<RtpPacket::Ptr>, private PacketCache<RtpPacket> {
+class RtspMediaSource : public MediaSource, public toolkit::RingDelegate<RtpPacket::Ptr>, private PacketCache<RtpPacket, FlushPolicy, RtpPacketList> {
 public:
     using Ptr = std::shared_ptr<RtspMediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<RtpPacket::Ptr> >;
+    using RingDataType = RtpPacketList::Ptr;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     /**
@@ -72,6 +73,17 @@ public:
         return _ring ? _ring->readerCount() : 0;
     }
 
+    /**
+     * 获取该源共享的rtp重传缓存，供webrtc播放器响应nack
+     */
+    const RtpRetransmitCache::Ptr &getRetransmitCache() const {
+        return _retransmit_cache;
+    }
+
+    const LatencyHistogram *getIngestLatency() const override {
+        return &PacketCache<RtpPacket, FlushPolicy, RtpPacketList>::getIngestLatency();
+    }
+
     /**
      * 获取该源的sdp
      */
@@ -129,8 +141,15 @@ public:
      */
     void onWrite(RtpPacket::Ptr rtp, bool keyPos) override;
 
+    /**
+     * 设置是否缓存gop，由共享gop缓存提供首次播放数据时，环形缓存只保留最新的数据
+     */
+    void setKeepGop(bool keep_gop) {
+        _keep_gop = keep_gop;
+    }
+
     void clearCache() override{
-        PacketCache<RtpPacket>::clearCache();
+        PacketCache<RtpPacket, FlushPolicy, RtpPacketList>::clearCache();
         _ring->clearCache();
     }
 
@@ -140,17 +159,24 @@ private:
      * @param rtp_list rtp包列表
      * @param key_pos 是否包含关键帧
      */
-    void onFlush(std::shared_ptr<toolkit::List<RtpPacket::Ptr> > rtp_list, bool key_pos) override {
+    void onFlush(RtpPacketList::Ptr rtp_list, bool key_pos) override {
+        rtp_list->setKeyPos(_have_video && key_pos);
+        if (_retransmit_cache->enabled()) {
+            // 有播放器需要nack重传，先加入重传缓存
+            _retransmit_cache->input(*rtp_list);
+        }
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以is_key一直为true确保一直清空GOP缓存
-        _ring->write(std::move(rtp_list), _have_video ? key_pos : true);
+        _ring->write(std::move(rtp_list), _have_video && _keep_gop ? key_pos : true);
     }
 
 private:
     bool _have_video = false;
+    bool _keep_gop = true;
     int _ring_size;
     std::string _sdp;
     RingType::Ptr _ring;
     SdpTrack::Ptr _tracks[TrackMax];
+    RtpRetransmitCache::Ptr _retransmit_cache = std::make_shared<RtpRetransmitCache>();
 };
 
 } /* namespace mediakit */
@@ -13,17 +13,18 @@
 
 #include "RtspMuxer.h"
 #include "Rtsp/RtspMediaSource.h"
+#include "Common/FrameGopCache.h"
 
 namespace mediakit {
 
-class RtspMediaSourceMuxer final : public RtspMuxer, public MediaSourceEventInterceptor,
+class RtspMediaSourceMuxer final : public RtspMuxer, public MediaSourceEventInterceptor, public FrameGopReplayer,
                                    public std::enable_shared_from_this<RtspMediaSourceMuxer> {
 public:
     using Ptr = std::shared_ptr<RtspMediaSourceMuxer>;
 
     RtspMediaSourceMuxer(const MediaTuple& tuple,
                          const ProtocolOption &option,
-                         const TitleSdp::Ptr &title = nullptr) : RtspMuxer(title) {
+                         const TitleSdp::Ptr &title = nullptr) : RtspMuxer(title), FrameGopReplayer(option.rtsp_demand) {
         _option = option;
         _media_src = std::make_shared<RtspMediaSource>(tuple);
         getRtpRing()->setDelegate(_media_src);
@@ -61,13 +62,22 @@ public:
         if (_clear_cache && _option.rtsp_demand) {
             _clear_cache = false;
             _media_src->clearCache();
+            resetGopIndex();
         }
         if (_enabled || !_option.rtsp_demand) {
+            replayGop([this](const Frame::Ptr &frame) { RtspMuxer::inputFrame(frame); });
             return RtspMuxer::inputFrame(frame);
         }
         return false;
     }
 
+    /**
+     * 设置共享gop缓存，按需转协议时用于首次播放，此时协议环形缓存不再缓存gop
+     */
+    void setGopCache(const FrameGopCache::Ptr &gop_cache) {
+        _media_src->setKeepGop(!FrameGopReplayer::setGopCache(gop_cache));
+    }
+
     bool isEnabled() {
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.rtsp_demand ? (_clear_cache ? true : _enabled) : true;
@@ -729,7 +729,7 @@ void RtspPlayer::onPlayResult_l(const SockException &ex, bool handshake_done) {
             return true;
         };
         // 创建rtp数据接收超时检测定时器
-        _rtp_check_timer = std::make_shared<Timer>(timeoutMS / 2000.0f, lam, getPoller());
+        _rtp_check_timer = std::make_shared<WheelTimer>(timeoutMS / 2000.0f, lam, getPoller());
     } else {
         sendTeardown();
     }
@@ -21,6 +21,7 @@
 #include "RtspSplitter.h"
 #include "RtpReceiver.h"
 #include "Rtcp/RtcpContext.h"
+#include "Common/TimerWheel.h"
 
 namespace mediakit {
 
@@ -143,7 +144,7 @@ private:
     //超时功能实现
     toolkit::Ticker _rtp_recv_ticker;
     std::shared_ptr<toolkit::Timer> _play_check_timer;
-    std::shared_ptr<toolkit::Timer> _rtp_check_timer;
+    WheelTimer::Ptr _rtp_check_timer;
     //服务器支持的命令
     std::set<std::string> _supported_cmd;
     ////////// rtcp ////////////////
@@ -11,6 +11,7 @@
 #include <atomic>
 #include <iomanip>
 #include "Common/config.h"
+#include "Common/Metrics.h"
 #include "UDPServer.h"
 #include "RtspSession.h"
 #include "Util/MD5.h"
@@ -117,6 +118,7 @@ void RtspSession::onManager() {
 void RtspSession::onRecv(const Buffer::Ptr &buf) {
     _alive_ticker.resetTime();
     _bytes_usage += buf->size();
+    Metrics::add(Metrics::kRtspBytesIn, buf->size());
     if (_on_recv) {
         //http poster的请求数据转发给http getter处理
         _on_recv(buf);
@@ -869,12 +871,15 @@ void RtspSession::handleReq_Play(const Parser &parser) {
             }
             strong_self->shutdown(SockException(Err_shutdown, "rtsp ring buffer detached"));
         });
+        // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+        LatencyStat::ReplayScope replay_scope;
         _play_reader->setReadCB([weak_self](const RtspMediaSource::RingDataType &pack) {
             auto strong_self = weak_self.lock();
             if (!strong_self) {
                 return;
             }
             strong_self->sendRtpPacket(pack);
+            LatencyStat::onSend(LatencyStat::kRingToRtsp, *pack);
         });
     }
 }
@@ -976,6 +981,7 @@ void RtspSession::onRtpSorted(RtpPacket::Ptr rtp, int track_idx) {
 void RtspSession::onRcvPeerUdpData(int interleaved, const Buffer::Ptr &buf, const struct sockaddr_storage &addr) {
     //这是rtcp心跳包，说明播放器还存活
     _alive_ticker.resetTime();
+    Metrics::add(Metrics::kRtspBytesIn, buf->size());
 
     if (interleaved % 2 == 0) {
         if (_push_src) {
@@ -1105,6 +1111,7 @@ ssize_t RtspSession::send(Buffer::Ptr pkt){
 //		DebugP(this) << pkt->data();
 //	}
     _bytes_usage += pkt->size();
+    Metrics::add(Metrics::kRtspBytesOut, pkt->size());
     return Session::send(std::move(pkt));
 }
 
@@ -1228,6 +1235,13 @@ void RtspSession::updateRtcpContext(const RtpPacket::Ptr &rtp){
 void RtspSession::sendRtpPacket(const RtspMediaSource::RingDataType &pkt) {
     switch (_rtp_type) {
         case Rtsp::RTP_TCP: {
+            GET_CONFIG(bool, shared_tcp_buffer, Rtsp::kSharedTcpBuffer);
+            if (shared_tcp_buffer && _target_play_track == TrackInvalid) {
+                //所有tcp播放器共享同一个合并后的rtp over tcp缓存，不再逐包发送
+                pkt->for_each([&](const RtpPacket::Ptr &rtp) { updateRtcpContext(rtp); });
+                send(pkt->getTcpBuffer());
+                break;
+            }
             setSendFlushFlag(false);
             pkt->for_each([&](const RtpPacket::Ptr &rtp) {
                 if (_target_play_track == TrackInvalid || _target_play_track == rtp->type) {
@@ -1240,27 +1254,40 @@ void RtspSession::sendRtpPacket(const RtspMediaSource::RingDataType &pkt) {
         }
             break;
         case Rtsp::RTP_UDP: {
-            //下标0表示视频，1表示音频
-            Socket::Ptr rtp_socks[2];
-            rtp_socks[TrackVideo] = _rtp_socks[getTrackIndexByTrackType(TrackVideo)];
-            rtp_socks[TrackAudio] = _rtp_socks[getTrackIndexByTrackType(TrackAudio)];
+            GET_CONFIG(float, pacer_ratio, Rtsp::kPacerRatio);
+            if (pacer_ratio <= 0 && (!_udp_pacer || !_udp_pacer->getCacheBytes())) {
+                // 未开启平滑发送，直接发送
+                _udp_pacer = nullptr;
+                RtpPacket::Ptr last;
+                pkt->for_each([&](const RtpPacket::Ptr &rtp) {
+                    if (_target_play_track == TrackInvalid || _target_play_track == rtp->type) {
+                        if (last) {
+                            sendRtpUdp(last, false);
+                        }
+                        last = rtp;
+                    }
+                });
+                if (last) {
+                    sendRtpUdp(last, true);
+                }
+                break;
+            }
+            if (!_udp_pacer) {
+                weak_ptr<RtspSession> weak_self = static_pointer_cast<RtspSession>(shared_from_this());
+                _udp_pacer = std::make_shared<PacketPacer<RtpPacket::Ptr> >([weak_self](RtpPacket::Ptr rtp, bool flush) {
+                    if (auto strong_self = weak_self.lock()) {
+                        strong_self->sendRtpUdp(rtp, flush);
+                    }
+                });
+            }
+            _udp_pacer->setRatio(pacer_ratio);
             pkt->for_each([&](const RtpPacket::Ptr &rtp) {
                 if (_target_play_track == TrackInvalid || _target_play_track == rtp->type) {
-                    updateRtcpContext(rtp);
-                    auto &sock = rtp_socks[rtp->type];
-                    if (!sock) {
-                        shutdown(SockException(Err_shutdown, "udp sock not opened yet"));
-                        return;
-                    }
-                    _bytes_usage += rtp->size() - RtpPacket::kRtpTcpHeaderSize;
-                    sock->send(std::make_shared<BufferRtp>(rtp, RtpPacket::kRtpTcpHeaderSize), nullptr, 0, false);
+                    _udp_pacer->inputPacket(rtp);
                 }
             });
-            for (auto &sock : rtp_socks) {
-                if (sock) {
-                    sock->flushAll();
-                }
-            }
+            // 关键帧等突发数据按照码率平滑发送
+            _udp_pacer->flush();
         }
             break;
         default:
@@ -1268,6 +1295,41 @@ void RtspSession::sendRtpPacket(const RtspMediaSource::RingDataType &pkt) {
     }
 }
 
+void RtspSession::sendRtpUdp(const RtpPacket::Ptr &rtp, bool flush) {
+    updateRtcpContext(rtp);
+    auto &sock = _rtp_socks[getTrackIndexByTrackType(rtp->type)];
+    if (!sock) {
+        shutdown(SockException(Err_shutdown, "udp sock not opened yet"));
+        return;
+    }
+    _bytes_usage += rtp->size() - RtpPacket::kRtpTcpHeaderSize;
+    Metrics::add(Metrics::kRtspBytesOut, rtp->size() - RtpPacket::kRtpTcpHeaderSize);
+    auto batch = UdpBatchSender::isEnabled();
+    auto buf = std::make_shared<BufferRtp>(rtp, RtpPacket::kRtpTcpHeaderSize);
+    if (batch) {
+        _rtp_batch_senders[rtp->type].inputPacket(std::move(buf));
+    } else {
+        sock->send(std::move(buf), nullptr, 0, false);
+    }
+    if (!flush) {
+        return;
+    }
+    //下标0表示视频，1表示音频
+    for (auto i = 0; i < 2; ++i) {
+        auto &rtp_sock = _rtp_socks[getTrackIndexByTrackType((TrackType)i)];
+        if (!rtp_sock) {
+            _rtp_batch_senders[i].clear();
+            continue;
+        }
+        if (batch) {
+            //一次系统调用发送该track的整批rtp
+            _rtp_batch_senders[i].flush(rtp_sock);
+        } else {
+            rtp_sock->flushAll();
+        }
+    }
+}
+
 void RtspSession::setSocketFlags(){
     GET_CONFIG(int, mergeWriteMS, General::kMergeWriteMS);
     if(mergeWriteMS > 0) {
@@ -21,6 +21,8 @@
 #include "RtspMediaSource.h"
 #include "RtspMediaSourceImp.h"
 #include "RtpMultiCaster.h"
+#include "Common/UdpBatchSender.h"
+#include "Common/PacketPacer.h"
 
 namespace mediakit {
 
@@ -143,6 +145,8 @@ private:
     void emitOnPlay();
     //发送rtp给客户端
     void sendRtpPacket(const RtspMediaSource::RingDataType &pkt);
+    //udp方式发送rtp给客户端，flush为本批次最后一个包
+    void sendRtpUdp(const RtpPacket::Ptr &rtp, bool flush);
     //触发rtcp发送
     void updateRtcpContext(const RtpPacket::Ptr &rtp);
     //回复客户端
@@ -188,6 +192,10 @@ private:
     ////////RTP over udp////////
     //RTP端口,trackid idx 为数组下标
     toolkit::Socket::Ptr _rtp_socks[2];
+    //udp批量发送器，下标0表示视频，1表示音频
+    UdpBatchSender _rtp_batch_senders[2];
+    //udp平滑发送器，开启rtsp.pacerRatio时才创建
+    PacketPacer<RtpPacket::Ptr>::Ptr _udp_pacer;
     //RTCP端口,trackid idx 为数组下标
     toolkit::Socket::Ptr _rtcp_socks[2];
     //标记是否收到播放的udp打洞包,收到播放的udp打洞包后才能知道其外网udp端口号
@@ -35,7 +35,7 @@ public:
 class TSMediaSource final : public MediaSource, public toolkit::RingDelegate<TSPacket::Ptr>, private PacketCache<TSPacket>{
 public:
     using Ptr = std::shared_ptr<TSMediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<TSPacket::Ptr> >;
+    using RingDataType = std::shared_ptr<LatencyList<TSPacket::Ptr> >;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     TSMediaSource(const MediaTuple& tuple, int ring_size = TS_GOP_SIZE): MediaSource(TS_SCHEMA, tuple), _ring_size(ring_size) {}
@@ -61,6 +61,10 @@ public:
         return _ring ? _ring->readerCount() : 0;
     }
 
+    const LatencyHistogram *getIngestLatency() const override {
+        return &PacketCache<TSPacket>::getIngestLatency();
+    }
+
     /**
      * 输入TS包
      * @param packet TS包
@@ -78,6 +82,13 @@ public:
         PacketCache<TSPacket>::inputPacket(stamp, true, std::move(packet), key);
     }
 
+    /**
+     * 设置是否缓存gop，由共享gop缓存提供首次播放数据时，环形缓存只保留最新的数据
+     */
+    void setKeepGop(bool keep_gop) {
+        _keep_gop = keep_gop;
+    }
+
     /**
      * 情况GOP缓存
      */
@@ -105,13 +116,14 @@ private:
      * @param packet_list 合并写缓存列队
      * @param key_pos 是否包含关键帧
      */
-    void onFlush(std::shared_ptr<toolkit::List<TSPacket::Ptr> > packet_list, bool key_pos) override {
+    void onFlush(std::shared_ptr<LatencyList<TSPacket::Ptr> > packet_list, bool key_pos) override {
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以确保一直清空GOP缓存
-        _ring->write(std::move(packet_list), _have_video ? key_pos : true);
+        _ring->write(std::move(packet_list), _have_video && _keep_gop ? key_pos : true);
     }
 
 private:
     bool _have_video = false;
+    bool _keep_gop = true;
     int _ring_size;
     RingType::Ptr _ring;
 };
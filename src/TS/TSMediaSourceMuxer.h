@@ -13,15 +13,16 @@
 
 #include "TSMediaSource.h"
 #include "Record/MPEG.h"
+#include "Common/FrameGopCache.h"
 
 namespace mediakit {
 
-class TSMediaSourceMuxer final : public MpegMuxer, public MediaSourceEventInterceptor,
+class TSMediaSourceMuxer final : public MpegMuxer, public MediaSourceEventInterceptor, public FrameGopReplayer,
                                  public std::enable_shared_from_this<TSMediaSourceMuxer> {
 public:
     using Ptr = std::shared_ptr<TSMediaSourceMuxer>;
 
-    TSMediaSourceMuxer(const MediaTuple& tuple, const ProtocolOption &option) : MpegMuxer(false) {
+    TSMediaSourceMuxer(const MediaTuple& tuple, const ProtocolOption &option) : MpegMuxer(false), FrameGopReplayer(option.ts_demand) {
         _option = option;
         _media_src = std::make_shared<TSMediaSource>(tuple);
     }
@@ -55,13 +56,22 @@ public:
         if (_clear_cache && _option.ts_demand) {
             _clear_cache = false;
             _media_src->clearCache();
+            resetGopIndex();
         }
         if (_enabled || !_option.ts_demand) {
+            replayGop([this](const Frame::Ptr &frame) { MpegMuxer::inputFrame(frame); });
             return MpegMuxer::inputFrame(frame);
         }
         return false;
     }
 
+    /**
+     * 设置共享gop缓存，按需转协议时用于首次播放，此时协议环形缓存不再缓存gop
+     */
+    void setGopCache(const FrameGopCache::Ptr &gop_cache) {
+        _media_src->setKeepGop(!FrameGopReplayer::setGopCache(gop_cache));
+    }
+
     bool isEnabled() {
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.ts_demand ? (_clear_cache ? true : _enabled) : true;
@@ -1,4 +1,5 @@
 ﻿#include "NackContext.hpp"
+#include "Common/Metrics.h"
 
 namespace SRT {
 void NackContext::update(TimePoint now, std::list<PacketQueue::LostPair> &lostlist) {
@@ -28,6 +29,7 @@ void NackContext::getLostList(
     if (tmp_list.empty()) {
         return;
     }
+    mediakit::Metrics::add(mediakit::Metrics::kSrtNack, tmp_list.size());
 
     uint32_t min = *tmp_list.begin();
     uint32_t max = *tmp_list.rbegin();
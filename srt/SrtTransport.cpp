@@ -7,6 +7,7 @@
 #include "Ack.hpp"
 #include "Packet.hpp"
 #include "SrtTransport.hpp"
+#include "Common/Metrics.h"
 
 namespace SRT {
 #define SRT_FIELD "srt."
@@ -72,7 +73,7 @@ void SrtTransport::switchToOtherTransport(uint8_t *buf, int len, uint32_t socket
 void SrtTransport::createTimerForCheckAlive(){
     std::weak_ptr<SrtTransport> weak_self = std::static_pointer_cast<SrtTransport>(shared_from_this());
     auto timeoutSec = getTimeOutSec();
-    _timer = std::make_shared<Timer>(
+    _timer = std::make_shared<WheelTimer>(
          timeoutSec/ 2,
         [weak_self,timeoutSec]() {
             auto strong_self = weak_self.lock();
@@ -209,7 +210,7 @@ void SrtTransport::handleHandshakeInduction(HandshakePacket &pkt, struct sockadd
 
     registerSelfHandshake();
     sendControlPacket(res, true);
-    _handleshake_timer = std::make_shared<Timer>(0.2,[this]()->bool{
+    _handleshake_timer = std::make_shared<WheelTimer>(0.2,[this]()->bool{
         sendControlPacket(_handleshake_res, true);
         return true;
     },getPoller());
@@ -382,7 +383,9 @@ void SrtTransport::handleNAK(uint8_t *buf, int len, struct sockaddr_storage *add
             sendPacket(pkt, flush);
             empty = false;
         }
+        mediakit::Metrics::add(mediakit::Metrics::kSrtRetransmit, re_list.size());
         if (empty) {
+            mediakit::Metrics::add(mediakit::Metrics::kSrtRetransmitMiss, it.second - it.first);
             sendMsgDropReq(it.first, it.second - 1);
         }
     }
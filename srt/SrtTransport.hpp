@@ -10,6 +10,7 @@
 #include "Poller/EventPoller.h"
 #include "Poller/Timer.h"
 #include "Common/Stamp.h"
+#include "Common/TimerWheel.h"
 #include "Common.hpp"
 #include "NackContext.hpp"
 #include "Packet.hpp"
@@ -149,12 +150,12 @@ private:
     // 保持发送的握手消息，防止丢失重发
     HandshakePacket::Ptr _handleshake_res;
 
-    Timer::Ptr _handleshake_timer;
+    WheelTimer::Ptr _handleshake_timer;
 
     ResourcePool<BufferRaw> _packet_pool;
 
     //检测超时的定时器
-    Timer::Ptr _timer;
+    WheelTimer::Ptr _timer;
     //刷新计时器
     Ticker _alive_ticker;
 
@@ -263,6 +263,8 @@ void SrtTransportImp::doPlay() {
                 }
                 strong_self->onShutdown(SockException(Err_shutdown));
             });
+            // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+            LatencyStat::ReplayScope replay_scope;
             strong_self->_ts_reader->setReadCB([weak_self](const TSMediaSource::RingDataType &ts_list) {
                 auto strong_self = weak_self.lock();
                 if (!strong_self) {
@@ -272,6 +274,7 @@ void SrtTransportImp::doPlay() {
                 size_t i = 0;
                 auto size = ts_list->size();
                 ts_list->for_each([&](const TSPacket::Ptr &ts) { strong_self->onSendTSData(ts, ++i == size); });
+                LatencyStat::onSend(LatencyStat::kRingToSrt, *ts_list);
             });
         }
     });
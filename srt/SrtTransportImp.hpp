@@ -2,6 +2,7 @@
 #define ZLMEDIAKIT_SRT_TRANSPORT_IMP_H
 
 #include "Common/MultiMediaSourceMuxer.h"
+#include "Common/Metrics.h"
 #include "Rtp/Decoder.h"
 #include "SrtTransport.hpp"
 #include "TS/TSMediaSource.h"
@@ -24,6 +25,7 @@ public:
     void inputSockData(uint8_t *buf, int len, struct sockaddr_storage *addr) override {
         SrtTransport::inputSockData(buf, len, addr);
         _total_bytes += len;
+        Metrics::add(Metrics::kSrtBytesIn, len);
     }
     void onSendTSData(const Buffer::Ptr &buffer, bool flush) override { SrtTransport::onSendTSData(buffer, flush); }
     /// SockInfo override
@@ -44,6 +46,7 @@ protected:
 
     void sendPacket(Buffer::Ptr pkt, bool flush = true) override {
         _total_bytes += pkt->size();
+        Metrics::add(Metrics::kSrtBytesOut, pkt->size());
         SrtTransport::sendPacket(pkt, flush);
     }
 
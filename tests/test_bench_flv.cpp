@@ -0,0 +1,195 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Util/ResourcePool.h"
+#include "Rtmp/Rtmp.h"
+#include "Rtmp/utils.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('v',/*该选项简称，如果是\x00则说明无简称*/
+                             "viewers",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "1000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "模拟的播放器个数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('b',/*该选项简称，如果是\x00则说明无简称*/
+                             "bitrate",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "2000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "视频码率,单位kbps",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('s',/*该选项简称，如果是\x00则说明无简称*/
+                             "seconds",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "10",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "模拟的流时长,单位秒",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+//模拟socket的发送队列，flush时清空
+class SendQueue {
+public:
+    void send(Buffer::Ptr buf) {
+        _bytes += buf->size();
+        _queue.emplace_back(std::move(buf));
+    }
+
+    void flush() { _queue.clear(); }
+
+    size_t bytes() const { return _bytes; }
+
+private:
+    size_t _bytes = 0;
+    vector<Buffer::Ptr> _queue;
+};
+
+//改造前的flv播放器：每个播放器为每个rtmp包单独生成tag header与PreviousTagSize
+class LegacyFlvViewer {
+public:
+    LegacyFlvViewer() { _packet_pool.setSize(64); }
+
+    void onRead(const RtmpPacketList::Ptr &pkt) {
+        pkt->for_each([&](const RtmpPacket::Ptr &rtmp) {
+            RtmpTagHeader header;
+            header.type = rtmp->type_id;
+            set_be24(header.data_size, (uint32_t)rtmp->size());
+            header.timestamp_ex = (rtmp->time_stamp >> 24) & 0xff;
+            set_be24(header.timestamp, rtmp->time_stamp & 0xFFFFFF);
+            _queue.send(obtainBuffer(&header, sizeof(header)));
+            _queue.send(rtmp);
+            uint32_t size = htonl((uint32_t)(rtmp->size() + sizeof(header)));
+            _queue.send(obtainBuffer(&size, 4));
+        });
+        _queue.flush();
+    }
+
+    size_t bytes() const { return _queue.bytes(); }
+
+private:
+    BufferRaw::Ptr obtainBuffer(const void *data, size_t len) {
+        auto buffer = _packet_pool.obtain2();
+        buffer->assign((const char *)data, len);
+        return buffer;
+    }
+
+private:
+    SendQueue _queue;
+    ResourcePool<BufferRaw> _packet_pool;
+};
+
+//改造后的flv播放器：共享序列化后的flv tag
+class SharedFlvViewer {
+public:
+    void onRead(const RtmpPacketList::Ptr &pkt) {
+        _queue.send(pkt->getFlvTags());
+        _queue.flush();
+    }
+
+    size_t bytes() const { return _queue.bytes(); }
+
+private:
+    SendQueue _queue;
+};
+
+static RtmpPacket::Ptr makePacket(uint8_t type, uint32_t stamp, size_t size) {
+    auto pkt = RtmpPacket::create();
+    pkt->type_id = type;
+    pkt->time_stamp = stamp;
+    pkt->buffer.assign(size, 'z');
+    pkt->body_size = size;
+    return pkt;
+}
+
+//生成与合并写一致的rtmp包列表：每个视频帧及其前的音频帧为一批
+static vector<RtmpPacketList::Ptr> makeStream(size_t seconds, size_t video_kbps) {
+    vector<RtmpPacketList::Ptr> ret;
+    auto video_size = video_kbps * 1000 / 8 / 25;
+    for (uint32_t stamp = 0; stamp < seconds * 1000; stamp += 40) {
+        auto list = std::make_shared<RtmpPacketList>();
+        //每40ms两个aac帧
+        list->emplace_back(makePacket(MSG_AUDIO, stamp, 300));
+        list->emplace_back(makePacket(MSG_AUDIO, stamp + 20, 300));
+        list->emplace_back(makePacket(MSG_VIDEO, stamp, video_size));
+        ret.emplace_back(std::move(list));
+    }
+    return ret;
+}
+
+template <typename Viewer>
+static void runBench(const char *name, size_t viewers, size_t seconds, size_t video_kbps) {
+    //每次重新生成流，确保共享flv tag需要重新序列化
+    auto stream = makeStream(seconds, video_kbps);
+    vector<Viewer> viewer_list(viewers);
+    Ticker ticker;
+    for (auto &pkt : stream) {
+        for (auto &viewer : viewer_list) {
+            viewer.onRead(pkt);
+        }
+    }
+    auto ms = MAX(ticker.elapsedTime(), (uint64_t)1);
+    size_t bytes = 0;
+    for (auto &viewer : viewer_list) {
+        bytes += viewer.bytes();
+    }
+    //单核每秒可以处理的流时长即为单核可以支撑的播放器个数(不含socket写耗时)
+    auto viewers_per_core = viewers * seconds * 1000.0 / ms;
+    cout << name << " 播放器:" << viewers << " 耗时:" << ms << "ms"
+         << " 输出:" << bytes / 1024 / 1024 << "MB"
+         << " 单核可支撑播放器数:" << (uint64_t)viewers_per_core << endl;
+}
+
+//此程序用于对比http-flv播放器逐包序列化与共享flv tag时的cpu开销
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    size_t viewers = MAX(cmd_main["viewers"].as<int>(), 1);
+    size_t video_kbps = MAX(cmd_main["bitrate"].as<int>(), 1);
+    size_t seconds = MAX(cmd_main["seconds"].as<int>(), 1);
+
+    //设置日志
+    Logger::Instance().add(std::make_shared<ConsoleChannel>());
+
+    runBench<LegacyFlvViewer>("逐包序列化", viewers, seconds, video_kbps);
+    runBench<SharedFlvViewer>("共享flv tag", viewers, seconds, video_kbps);
+    return 0;
+}
@@ -0,0 +1,220 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Thread/semaphore.h"
+#include "Poller/EventPoller.h"
+#include "Network/Socket.h"
+#include "Common/config.h"
+#include "Rtp/RtpProcess.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('l',/*该选项简称，如果是\x00则说明无简称*/
+                             "level",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             to_string(LWarn).data(),/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "日志等级,LTrace~LError(0~4)",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('i',/*该选项简称，如果是\x00则说明无简称*/
+                             "in",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             nullptr,/*该选项默认值*/
+                             true,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "ps over rtp文件，格式与rtp_proxy.dumpDir导出的.rtp文件相同(2字节大端长度+rtp)",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('t',/*该选项简称，如果是\x00则说明无简称*/
+                             "threads",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "1",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "测试线程数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('c',/*该选项简称，如果是\x00则说明无简称*/
+                             "count",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "50",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每个线程模拟的摄像头个数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('p',/*该选项简称，如果是\x00则说明无简称*/
+                             "protocol",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "0",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "是否开启协议转换，为0时只测试rtp排序与ps解复用",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+#if defined(ENABLE_RTPPROXY)
+static bool loadRtpFile(const string &path, vector<string> &packets, double &duration) {
+    std::shared_ptr<FILE> fp(fopen(path.data(), "rb"), [](FILE *fp) {
+        if (fp) {
+            fclose(fp);
+        }
+    });
+    if (!fp) {
+        return false;
+    }
+    uint16_t len;
+    bool first = true;
+    uint32_t last_stamp = 0;
+    uint64_t total_stamp = 0;
+    while (2 == fread(&len, 1, 2, fp.get())) {
+        len = ntohs(len);
+        string rtp(len, '\0');
+        if (len < RtpPacket::kRtpHeaderSize || len != fread((char *)rtp.data(), 1, len, fp.get())) {
+            break;
+        }
+        //根据rtp时间戳统计文件时长，时间戳回环时按照差值累加
+        auto stamp = ntohl(((RtpHeader *)rtp.data())->stamp);
+        if (!first) {
+            auto diff = stamp - last_stamp;
+            // 忽略乱序与跳变
+            total_stamp += diff < 90000 ? diff : 0;
+        }
+        first = false;
+        last_stamp = stamp;
+        packets.emplace_back(std::move(rtp));
+    }
+    duration = total_stamp / 90000.0;
+    return !packets.empty();
+}
+#endif // #if defined(ENABLE_RTPPROXY)
+
+//此程序用于测试单个cpu核心能够接入多少路ps over rtp(国标)摄像头
+//每个线程创建多个RtpProcess，交替输入文件中的rtp包，模拟多个摄像头同时推流
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    LogLevel logLevel = (LogLevel) cmd_main["level"].as<int>();
+    logLevel = MIN(MAX(logLevel, LTrace), LError);
+    size_t threads = MAX(cmd_main["threads"].as<int>(), 1);
+    size_t count = MAX(cmd_main["count"].as<int>(), 1);
+    bool protocol = cmd_main["protocol"].as<int>();
+
+    //设置日志
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", logLevel));
+
+#if defined(ENABLE_RTPPROXY)
+    vector<string> packets;
+    double duration = 0;
+    if (!loadRtpFile(cmd_main["in"], packets, duration) || duration <= 0) {
+        cout << "加载rtp文件失败:" << cmd_main["in"] << endl;
+        return -1;
+    }
+    size_t total_bytes = 0;
+    for (auto &pkt : packets) {
+        total_bytes += pkt.size();
+    }
+    cout << "rtp包个数:" << packets.size() << " 字节数:" << total_bytes << " 时长:" << duration << "s" << endl;
+
+    if (!protocol) {
+        //关闭所有协议转换，只测试接入与解复用
+        for (auto &key : { Protocol::kEnableHls, Protocol::kEnableHlsFmp4, Protocol::kEnableMP4, Protocol::kEnableRtsp,
+                           Protocol::kEnableRtmp, Protocol::kEnableTS, Protocol::kEnableFMP4 }) {
+            mINI::Instance()[key] = 0;
+        }
+    }
+
+    EventPollerPool::setPoolSize(threads);
+    vector<EventPoller::Ptr> pollers;
+    EventPollerPool::Instance().for_each([&](const TaskExecutor::Ptr &executor) {
+        pollers.emplace_back(dynamic_pointer_cast<EventPoller>(executor));
+    });
+
+    semaphore sem;
+    vector<uint64_t> elapsed(pollers.size());
+    for (size_t index = 0; index < pollers.size(); ++index) {
+        auto poller = pollers[index];
+        poller->async([&, index, poller]() {
+            struct sockaddr_storage addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.ss_family = AF_INET;
+            auto sock = Socket::createSocket(poller);
+
+            vector<RtpProcess::Ptr> process_list;
+            for (size_t i = 0; i < count; ++i) {
+                auto process = RtpProcess::createProcess("bench_" + to_string(index) + "_" + to_string(i));
+                //首个rtp触发推流鉴权，在本线程中鉴权成功后同步创建muxer，不计入耗时
+                process->inputRtp(true, sock, packets[0].data(), packets[0].size(), (struct sockaddr *)&addr);
+                process_list.emplace_back(std::move(process));
+            }
+
+            Ticker ticker;
+            uint64_t dts = 0;
+            for (size_t i = 1; i < packets.size(); ++i) {
+                auto &pkt = packets[i];
+                for (auto &process : process_list) {
+                    //传入dts_out，防止无人观看时直接丢弃数据
+                    process->inputRtp(true, sock, pkt.data(), pkt.size(), (struct sockaddr *)&addr, &dts);
+                }
+            }
+            for (auto &process : process_list) {
+                process->flush();
+            }
+            elapsed[index] = ticker.elapsedTime();
+            process_list.clear();
+            sem.post();
+        });
+    }
+    for (size_t i = 0; i < pollers.size(); ++i) {
+        sem.wait();
+    }
+
+    double total_cameras = 0;
+    for (size_t index = 0; index < pollers.size(); ++index) {
+        auto seconds = MAX(elapsed[index], (uint64_t)1) / 1000.0;
+        //线程满负荷运行，耗时即为单核cpu时间
+        auto cameras = duration * count / seconds;
+        total_cameras += cameras;
+        cout << "线程" << index << " 摄像头个数:" << count
+             << " 耗时:" << seconds << "s"
+             << " 码率:" << total_bytes * count * 8 / seconds / 1024 / 1024 << "Mbps"
+             << " 单核可接入摄像头个数:" << cameras << endl;
+    }
+    cout << "线程数:" << pollers.size() << " 协议转换:" << protocol
+         << " 平均单核可接入摄像头个数:" << total_cameras / pollers.size() << endl;
+#else
+    ErrorL << "please ENABLE_RTPPROXY and then test";
+#endif // #if defined(ENABLE_RTPPROXY)
+    return 0;
+}
@@ -0,0 +1,166 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <thread>
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Common/config.h"
+#include "Common/MediaSource.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class BenchMediaSource : public MediaSource {
+public:
+    using Ptr = std::shared_ptr<BenchMediaSource>;
+    using MediaSource::MediaSource;
+    using MediaSource::regist;
+
+    int readerCount() override { return 0; }
+};
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('l',/*该选项简称，如果是\x00则说明无简称*/
+                             "level",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             to_string(LWarn).data(),/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "日志等级,LTrace~LError(0~4)",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('t',/*该选项简称，如果是\x00则说明无简称*/
+                             "threads",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             to_string(thread::hardware_concurrency()).data(),/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "最大测试线程数,将依次测试1~N个线程",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('c',/*该选项简称，如果是\x00则说明无简称*/
+                             "count",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "5000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每个线程注册的流个数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('f',/*该选项简称，如果是\x00则说明无简称*/
+                             "find",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "200000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每个线程查找流的次数",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+static string makeStreamId(size_t thread_index, size_t index) {
+    return "stream_" + to_string(thread_index) + "_" + to_string(index);
+}
+
+template <typename FUNC>
+static uint64_t runThreads(size_t threads, FUNC &&func) {
+    vector<thread> thread_list;
+    Ticker ticker;
+    for (size_t i = 0; i < threads; ++i) {
+        thread_list.emplace_back([i, &func]() { func(i); });
+    }
+    for (auto &th : thread_list) {
+        th.join();
+    }
+    return ticker.elapsedTime();
+}
+
+static double opsPerSecond(uint64_t ops, uint64_t ms) {
+    return ops * 1000.0 / (ms ? ms : 1);
+}
+
+//此程序用于测试MediaSource注册表在多线程下的注册与查找性能
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    LogLevel logLevel = (LogLevel) cmd_main["level"].as<int>();
+    logLevel = MIN(MAX(logLevel, LTrace), LError);
+    size_t max_threads = MAX(cmd_main["threads"].as<int>(), 1);
+    size_t count = cmd_main["count"].as<int>();
+    size_t find_count = cmd_main["find"].as<int>();
+
+    //设置日志
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", logLevel));
+
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+        vector<vector<BenchMediaSource::Ptr> > src_list(threads);
+
+        //每个线程注册不同的流
+        auto regist_ms = runThreads(threads, [&](size_t thread_index) {
+            auto &list = src_list[thread_index];
+            list.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto src = std::make_shared<BenchMediaSource>(RTSP_SCHEMA, MediaTuple{DEFAULT_VHOST, "live", makeStreamId(thread_index, i), ""});
+                src->regist();
+                list.emplace_back(std::move(src));
+            }
+        });
+
+        //每个线程随机查找所有线程注册的流
+        atomic<size_t> found { 0 };
+        auto find_ms = runThreads(threads, [&](size_t thread_index) {
+            size_t hit = 0;
+            uint32_t seed = (uint32_t) thread_index * 2654435761U + 1;
+            for (size_t i = 0; i < find_count; ++i) {
+                seed = seed * 1103515245 + 12345;
+                auto stream = makeStreamId((seed >> 8) % threads, (seed >> 4) % count);
+                if (MediaSource::find(RTSP_SCHEMA, DEFAULT_VHOST, "live", stream)) {
+                    ++hit;
+                }
+            }
+            found += hit;
+        });
+
+        //遍历全部流，模拟getMediaList
+        size_t total = 0;
+        Ticker ticker;
+        MediaSource::for_each_media([&](const MediaSource::Ptr &src) { ++total; }, RTSP_SCHEMA);
+        auto list_ms = ticker.elapsedTime();
+
+        //析构时注销
+        auto unregist_ms = runThreads(threads, [&](size_t thread_index) { src_list[thread_index].clear(); });
+
+        cout << "线程数:" << threads
+             << " 注册:" << opsPerSecond(threads * count, regist_ms) << "/s"
+             << " 查找:" << opsPerSecond(threads * find_count, find_ms) << "/s"
+             << " 命中:" << found.load()
+             << " 遍历" << total << "个流耗时:" << list_ms << "ms"
+             << " 注销:" << opsPerSecond(threads * count, unregist_ms) << "/s" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+#include <iostream>
+#include <srtp2/srtp.h>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Common/config.h"
+#include "../webrtc/SrtpSession.hpp"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('c',/*该选项简称，如果是\x00则说明无简称*/
+                             "count",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "200000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每种加密套件加密的rtp个数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('s',/*该选项简称，如果是\x00则说明无简称*/
+                             "size",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "1200",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "rtp包长度",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('b',/*该选项简称，如果是\x00则说明无简称*/
+                             "batch",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "16",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "批量加密时每批rtp个数",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+struct SuiteInfo {
+    RTC::SrtpSession::CryptoSuite suite;
+    const char *name;
+    size_t key_len;
+};
+
+static std::shared_ptr<RTC::SrtpSession> createSession(const SuiteInfo &info) {
+    vector<uint8_t> key(info.key_len);
+    for (auto &ch : key) {
+        ch = (uint8_t) rand();
+    }
+    try {
+        return std::make_shared<RTC::SrtpSession>(RTC::SrtpSession::Type::OUTBOUND, info.suite, key.data(), key.size());
+    } catch (std::exception &ex) {
+        WarnL << info.name << " not supported: " << ex.what();
+        return nullptr;
+    }
+}
+
+static BufferRaw::Ptr makeRtp(const vector<char> &plain, uint16_t seq) {
+    auto pkt = BufferRaw::create();
+    pkt->setCapacity(plain.size() + SRTP_MAX_TRAILER_LEN + 2);
+    memcpy(pkt->data(), plain.data(), plain.size());
+    pkt->setSize(plain.size());
+    // rtp seq
+    pkt->data()[2] = seq >> 8;
+    pkt->data()[3] = seq & 0xFF;
+    return pkt;
+}
+
+static double kpps(size_t count, uint64_t ms) {
+    return count * 1.0 / (ms ? ms : 1);
+}
+
+//此程序用于测试不同srtp加密套件的单核加密性能，以及逐个加密与批量加密的差别
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    size_t count = cmd_main["count"].as<int>();
+    size_t size = MAX(cmd_main["size"].as<int>(), 12);
+    size_t batch = MAX(cmd_main["batch"].as<int>(), 1);
+
+    //设置日志
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    //rtp v2, pt 96, ssrc 0x12345678
+    vector<char> plain(size, 'a');
+    plain[0] = (char) 0x80;
+    plain[1] = 96;
+    plain[8] = 0x12;
+    plain[9] = 0x34;
+    plain[10] = 0x56;
+    plain[11] = 0x78;
+
+    SuiteInfo suites[] = {
+        { RTC::SrtpSession::CryptoSuite::AES_CM_128_HMAC_SHA1_80, "AES_CM_128_HMAC_SHA1_80", SRTP_AES_ICM_128_KEY_LEN_WSALT },
+        { RTC::SrtpSession::CryptoSuite::AES_CM_128_HMAC_SHA1_32, "AES_CM_128_HMAC_SHA1_32", SRTP_AES_ICM_128_KEY_LEN_WSALT },
+        { RTC::SrtpSession::CryptoSuite::AEAD_AES_128_GCM, "AEAD_AES_128_GCM", SRTP_AES_GCM_128_KEY_LEN_WSALT },
+        { RTC::SrtpSession::CryptoSuite::AEAD_AES_256_GCM, "AEAD_AES_256_GCM", SRTP_AES_GCM_256_KEY_LEN_WSALT },
+    };
+
+    for (auto &info : suites) {
+        auto single = createSession(info);
+        auto batched = createSession(info);
+        if (!single || !batched) {
+            continue;
+        }
+
+        //逐个加密
+        uint16_t seq = 0;
+        Ticker ticker;
+        for (size_t i = 0; i < count; ++i) {
+            auto pkt = makeRtp(plain, seq++);
+            int len = (int) pkt->size();
+            single->EncryptRtp((uint8_t *) pkt->data(), &len);
+        }
+        auto single_ms = ticker.elapsedTime();
+
+        //批量加密
+        seq = 0;
+        ticker.resetTime();
+        vector<BufferRaw::Ptr> pkt_list;
+        pkt_list.reserve(batch);
+        for (size_t i = 0; i < count; i += batch) {
+            for (size_t j = 0; j < batch; ++j) {
+                pkt_list.emplace_back(makeRtp(plain, seq++));
+            }
+            batched->EncryptRtpList(pkt_list);
+            pkt_list.clear();
+        }
+        auto batch_ms = ticker.elapsedTime();
+
+        cout << info.name << " 包长:" << size
+             << " 逐个加密:" << kpps(count, single_ms) << "k pps"
+             << " 批量加密(" << batch << "):" << kpps(count, batch_ms) << "k pps"
+             << " 吞吐量:" << kpps(count, batch_ms) * size * 8 / 1000 << "Mbps" << endl;
+    }
+    return 0;
+}
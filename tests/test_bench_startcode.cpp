@@ -0,0 +1,156 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <random>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Common/macros.h"
+#include "Extension/StartCode.h"
+#include "ext-codec/H264.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('s',/*该选项简称，如果是\x00则说明无简称*/
+                             "size",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "1048576",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "单个关键帧字节数，4K关键帧一般为几百KB到几MB",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('n',/*该选项简称，如果是\x00则说明无简称*/
+                             "slice",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "8",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每个关键帧的slice个数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('c',/*该选项简称，如果是\x00则说明无简称*/
+                             "count",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "2000",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "每种实现扫描关键帧的次数",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+//生成模拟的4K关键帧：sps、pps与多个idr slice，slice内容为随机数据并做防竞争处理
+static string makeIdrFrame(size_t size, size_t slices) {
+    mt19937 rng(1);
+    string frame;
+    frame.reserve(size + 64);
+    frame.append("\x00\x00\x00\x01\x67\x64\x00\x33\xac\x2c\xa4\x01\xe0\x01\x0f\xb0", 16);
+    frame.append("\x00\x00\x00\x01\x68\xeb\xe3\xcb\x22\xc0", 10);
+    auto slice_size = size / MAX(slices, (size_t)1);
+    for (size_t i = 0; i < slices; ++i) {
+        frame.append(i ? "\x00\x00\x01\x65" : "\x00\x00\x00\x01\x65", i ? 4 : 5);
+        size_t zeros = 0;
+        for (size_t j = 0; j < slice_size; ++j) {
+            // cabac数据中0字节比例较高
+            auto byte = rng() % 8 == 0 ? 0 : (char)(rng() & 0xFF);
+            if (zeros >= 2 && (uint8_t)byte <= 3) {
+                // 防竞争字节
+                frame.push_back(0x03);
+                zeros = 0;
+            }
+            frame.push_back(byte);
+            zeros = byte ? 0 : zeros + 1;
+        }
+        if (zeros) {
+            // slice不能以0结尾
+            frame.push_back(0x80);
+        }
+    }
+    return frame;
+}
+
+static size_t countNal(FindStartCodeFunc func, const string &frame) {
+    size_t count = 0;
+    auto ptr = frame.data();
+    auto end = ptr + frame.size();
+    while (ptr < end) {
+        auto pos = func(ptr, end);
+        if (!pos) {
+            break;
+        }
+        ++count;
+        ptr = pos + 3;
+    }
+    return count;
+}
+
+static void printSpeed(const string &name, size_t bytes, uint64_t ms, size_t nal) {
+    cout << name << " 速度:" << bytes / 1024.0 / 1024.0 / 1024.0 * 1000.0 / MAX(ms, (uint64_t)1) << "GB/s"
+         << " 耗时:" << ms << "ms"
+         << " nal个数:" << nal << endl;
+}
+
+//此程序用于测试h264/h265起始码查找在各种指令集下的速度
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    size_t size = MAX(cmd_main["size"].as<int>(), 1024);
+    size_t slices = MAX(cmd_main["slice"].as<int>(), 1);
+    size_t count = MAX(cmd_main["count"].as<int>(), 1);
+
+    Logger::Instance().add(std::make_shared<ConsoleChannel>());
+
+    auto frame = makeIdrFrame(size, slices);
+    auto total = frame.size() * count;
+    cout << "关键帧大小:" << frame.size() << " slice个数:" << slices << " 运行时选择:" << getStartCodeFinderName() << endl;
+
+    for (auto name : { "c", "sse2", "neon", "avx2" }) {
+        auto func = getStartCodeFinder(name);
+        if (!func) {
+            continue;
+        }
+        size_t nal = 0;
+        Ticker ticker;
+        for (size_t i = 0; i < count; ++i) {
+            nal = countNal(func, frame);
+        }
+        printSpeed(name, total, ticker.elapsedTime(), nal);
+    }
+
+    //splitH264包含4字节起始码判断与回调开销
+    size_t nal = 0;
+    Ticker ticker;
+    for (size_t i = 0; i < count; ++i) {
+        nal = 0;
+        splitH264(frame.data(), frame.size(), prefixSize(frame.data(), frame.size()), [&](const char *ptr, size_t len, size_t prefix) { ++nal; });
+    }
+    printSpeed("splitH264", total, ticker.elapsedTime(), nal);
+    return 0;
+}
@@ -0,0 +1,235 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <ctime>
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/CMD.h"
+#include "Util/TimeTicker.h"
+#include "Common/macros.h"
+#include "Common/config.h"
+#include "Codec/Compositor.h"
+#include "Codec/Transcode.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class CMD_main : public CMD {
+public:
+    CMD_main() {
+        _parser.reset(new OptionParser(nullptr));
+
+        (*_parser) << Option('l',/*该选项简称，如果是\x00则说明无简称*/
+                             "level",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             to_string(LWarn).data(),/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "日志等级,LTrace~LError(0~4)",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('c',/*该选项简称，如果是\x00则说明无简称*/
+                             "count",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "500",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "合成的帧数",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('n',/*该选项简称，如果是\x00则说明无简称*/
+                             "nv12",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "0",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "输入画面是否为nv12格式(需要拆分uv平面)",/*该选项说明文字*/
+                             nullptr);
+
+        (*_parser) << Option('t',/*该选项简称，如果是\x00则说明无简称*/
+                             "threads",/*该选项全称,每个选项必须有全称；不得为null或空字符串*/
+                             Option::ArgRequired,/*该选项后面必须跟值*/
+                             "0",/*该选项默认值*/
+                             false,/*该选项是否必须赋值，如果没有默认值且为ArgRequired时用户必须提供该参数否则将抛异常*/
+                             "合成线程数(含调用线程)，0为cpu核数，对应配置项general.compose_threads",/*该选项说明文字*/
+                             nullptr);
+    }
+
+    ~CMD_main() override {}
+
+    const char *description() const override {
+        return "主程序命令参数";
+    }
+};
+
+class BenchImage {
+public:
+    BenchImage(YuvImage::Format format, int width, int height) {
+        _img.format = format;
+        _img.width = width;
+        _img.height = height;
+        auto cw = (width + 1) / 2;
+        auto ch = (height + 1) / 2;
+        _img.linesize[0] = (width + 31) / 32 * 32;
+        if (format == YuvImage::NV12) {
+            _img.linesize[1] = (cw * 2 + 31) / 32 * 32;
+            _img.linesize[2] = 0;
+        } else {
+            _img.linesize[1] = _img.linesize[2] = (cw + 31) / 32 * 32;
+        }
+        _buf.resize(_img.linesize[0] * height + (_img.linesize[1] + _img.linesize[2]) * ch);
+        _img.data[0] = (uint8_t *)_buf.data();
+        _img.data[1] = _img.data[0] + _img.linesize[0] * height;
+        _img.data[2] = format == YuvImage::NV12 ? nullptr : _img.data[1] + _img.linesize[1] * ch;
+    }
+
+    const YuvImage &get() const { return _img; }
+
+private:
+    YuvImage _img;
+    string _buf;
+};
+
+#if defined(ENABLE_FFMPEG)
+static YuvImage toYuvImage(const FFmpegFrame::Ptr &frame) {
+    YuvImage img;
+    auto f = frame->get();
+    img.format = f->format == AV_PIX_FMT_NV12 ? YuvImage::NV12 : YuvImage::I420;
+    img.width = f->width;
+    img.height = f->height;
+    for (int i = 0; i < 3; i++) {
+        img.data[i] = f->data[i];
+        img.linesize[i] = f->linesize[i];
+    }
+    return img;
+}
+#endif
+
+static void runBench(const char *name, size_t frames, const std::function<void()> &compose) {
+    Ticker ticker;
+    auto cpu_start = std::clock();
+    for (size_t i = 0; i < frames; ++i) {
+        compose();
+    }
+    auto wall = ticker.elapsedTime() / 1000.0;
+    auto cpu = (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    wall = MAX(wall, 0.001);
+    cpu = MAX(cpu, 0.001);
+    cout << name << " 帧数:" << frames
+         << " 耗时:" << wall << "s"
+         << " 帧率:" << frames / wall << "fps"
+         << " cpu:" << cpu << "s"
+         << " 单核帧率:" << frames / cpu << "fps" << endl;
+}
+
+//此程序用于测试VideoStack 16路1080p合成(4x4宫格)的合成性能，包括每路画面的缩放与拷贝
+int main(int argc, char *argv[]) {
+    CMD_main cmd_main;
+    try {
+        cmd_main.operator()(argc, argv);
+    } catch (ExitException &) {
+        return 0;
+    } catch (std::exception &ex) {
+        cout << ex.what() << endl;
+        return -1;
+    }
+
+    LogLevel logLevel = (LogLevel) cmd_main["level"].as<int>();
+    logLevel = MIN(MAX(logLevel, LTrace), LError);
+    size_t frames = MAX(cmd_main["count"].as<int>(), 1);
+    auto format = cmd_main["nv12"].as<int>() ? YuvImage::NV12 : YuvImage::I420;
+
+    //设置日志
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", logLevel));
+    //须在TileScheduler创建前设置
+    mINI::Instance()[General::kComposeThreads] = cmd_main["threads"].as<int>();
+
+    static constexpr int kWidth = 1920;
+    static constexpr int kHeight = 1080;
+    static constexpr int kGrid = 4;
+    auto tile_w = kWidth / kGrid;
+    auto tile_h = kHeight / kGrid;
+
+    BenchImage canvas(YuvImage::I420, kWidth, kHeight);
+    fillYuv(canvas.get(), 16, 128, 128);
+
+    //单线程依次执行与多线程并行执行同一组任务
+    auto benchJobs = [&](const string &name, const std::function<vector<TileScheduler::Job>()> &makeJobs) {
+        runBench((name + "(单线程)").data(), frames, [&]() {
+            for (auto &job : makeJobs()) {
+                job();
+            }
+        });
+        runBench((name + "(多线程)").data(), frames, [&]() {
+            auto jobs = makeJobs();
+            TileScheduler::Instance().run(jobs);
+        });
+    };
+
+    cout << "输入格式:" << (format == YuvImage::NV12 ? "nv12" : "yuv420p")
+         << " 合成线程数:" << TileScheduler::Instance().getThreads() + 1 << endl;
+
+#if defined(ENABLE_FFMPEG)
+    //与VideoStack一致，每路1080p画面在任务中缩放到格子大小后拷贝到画布
+    auto pix_fmt = format == YuvImage::NV12 ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUV420P;
+    vector<FFmpegFrame::Ptr> sources;
+    vector<FFmpegSws::Ptr> scalers;
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        auto frame = std::make_shared<FFmpegFrame>();
+        frame->fillPicture(pix_fmt, kWidth, kHeight);
+        frame->get()->format = pix_fmt;
+        frame->get()->width = kWidth;
+        frame->get()->height = kHeight;
+        fillYuv(toYuvImage(frame), (uint8_t)(i * 13), (uint8_t)(i * 7), (uint8_t)(255 - i * 7));
+        sources.emplace_back(std::move(frame));
+        scalers.emplace_back(std::make_shared<FFmpegSws>(pix_fmt, tile_w, tile_h));
+    }
+
+    benchJobs("缩放+拷贝", [&]() {
+        vector<TileScheduler::Job> jobs;
+        for (int i = 0; i < kGrid * kGrid; ++i) {
+            auto &dst = canvas.get();
+            auto &src = sources[i];
+            auto &sws = scalers[i];
+            auto x = (i % kGrid) * tile_w;
+            auto y = (i / kGrid) * tile_h;
+            jobs.emplace_back([&dst, &src, &sws, x, y]() {
+                auto scaled = sws->inputFrame(src);
+                if (scaled) {
+                    blitYuv(dst, x, y, toYuvImage(scaled));
+                }
+            });
+        }
+        return jobs;
+    });
+#else
+    cout << "未开启ENABLE_FFMPEG，只测试已缩放画面的拷贝" << endl;
+#endif // defined(ENABLE_FFMPEG)
+
+    //每个格子一路已缩放好的画面，只测试拷贝
+    vector<std::shared_ptr<BenchImage> > tiles;
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        auto tile = std::make_shared<BenchImage>(format, tile_w, tile_h);
+        fillYuv(tile->get(), (uint8_t)(i * 13), (uint8_t)(i * 7), (uint8_t)(255 - i * 7));
+        tiles.emplace_back(std::move(tile));
+    }
+
+    benchJobs("仅拷贝", [&]() {
+        vector<TileScheduler::Job> jobs;
+        for (int i = 0; i < kGrid * kGrid; ++i) {
+            auto &dst = canvas.get();
+            auto &src = tiles[i]->get();
+            auto x = (i % kGrid) * tile_w;
+            auto y = (i / kGrid) * tile_h;
+            jobs.emplace_back([&dst, &src, x, y]() { blitYuv(dst, x, y, src); });
+        }
+        return jobs;
+    });
+    return 0;
+}
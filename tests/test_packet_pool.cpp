@@ -0,0 +1,116 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <thread>
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Common/PacketPool.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+#if defined(ENABLE_PACKET_POOL)
+
+static bool s_failed = false;
+
+#define TEST_CHECK(exp, msg) \
+    do { \
+        if (!(exp)) { \
+            ErrorL << "check failed: " << #exp << ", " << msg; \
+            s_failed = true; \
+        } \
+    } while (0)
+
+static constexpr size_t kBlockCount = 1000;
+static constexpr size_t kBlockSize = 1000;
+
+// 其他线程释放的块归还给分配它的线程，由该线程下次分配时回收
+static void testRemoteFree() {
+    auto remote_free = PacketPool::getRemoteFreeCount();
+    std::thread owner([]() {
+        vector<void *> blocks;
+        for (size_t i = 0; i < kBlockCount; ++i) {
+            blocks.emplace_back(PacketPool::allocate(kBlockSize));
+        }
+        std::thread other([&]() {
+            for (auto ptr : blocks) {
+                PacketPool::deallocate(ptr);
+            }
+        });
+        other.join();
+
+        auto hit = PacketPool::getHitCount();
+        for (size_t i = 0; i < kBlockCount; ++i) {
+            blocks[i] = PacketPool::allocate(kBlockSize);
+        }
+        TEST_CHECK(PacketPool::getHitCount() - hit == kBlockCount, "remote freed blocks not reused: " << PacketPool::getHitCount() - hit);
+        for (auto ptr : blocks) {
+            PacketPool::deallocate(ptr);
+        }
+    });
+    owner.join();
+    TEST_CHECK(PacketPool::getRemoteFreeCount() - remote_free == kBlockCount, "remote free count: " << PacketPool::getRemoteFreeCount() - remote_free);
+}
+
+// 线程退出时释放其缓存，之后归还给该线程的块直接释放
+static void testThreadExit() {
+    auto cache_bytes = PacketPool::getCacheBytes();
+    vector<void *> leftover;
+    std::thread worker([&]() {
+        vector<void *> blocks;
+        for (size_t i = 0; i < kBlockCount; ++i) {
+            blocks.emplace_back(PacketPool::allocate(kBlockSize));
+        }
+        // 一半在本线程释放，缓存在本线程
+        for (size_t i = 0; i < kBlockCount / 2; ++i) {
+            PacketPool::deallocate(blocks[i]);
+        }
+        TEST_CHECK(PacketPool::getCacheBytes() > cache_bytes, "blocks not cached");
+        // 另一半在线程退出后由其他线程释放
+        leftover.assign(blocks.begin() + kBlockCount / 2, blocks.end());
+    });
+    worker.join();
+    TEST_CHECK(PacketPool::getCacheBytes() == cache_bytes, "thread cache not released on exit: " << PacketPool::getCacheBytes() - cache_bytes);
+
+    for (auto ptr : leftover) {
+        PacketPool::deallocate(ptr);
+    }
+    TEST_CHECK(PacketPool::getCacheBytes() == cache_bytes, "blocks of exited thread cached: " << PacketPool::getCacheBytes() - cache_bytes);
+
+    // 退出线程分配的PooledBuffer在其他线程析构
+    PooledBuffer::Ptr buffer;
+    std::thread([&]() {
+        buffer = PooledBuffer::create(kBlockSize);
+        buffer->assign("packet pool", 11);
+    }).join();
+    TEST_CHECK(buffer->size() == 11, "buffer size: " << buffer->size());
+    buffer = nullptr;
+}
+
+#endif // defined(ENABLE_PACKET_POOL)
+
+// 此程序用于测试PacketPool：跨线程释放归还，以及线程退出时释放缓存
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>());
+#if defined(ENABLE_PACKET_POOL)
+    testRemoteFree();
+    testThreadExit();
+    if (s_failed) {
+        ErrorL << "test packet pool failed";
+        return -1;
+    }
+    InfoL << "test packet pool success";
+#else
+    ErrorL << "please ENABLE_PACKET_POOL and then test";
+#endif // defined(ENABLE_PACKET_POOL)
+    return 0;
+}
@@ -0,0 +1,241 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Common/macros.h"
+#if defined(ENABLE_RTPPROXY)
+#include "Rtp/PSDecoder.h"
+#include "mpeg-ps.h"
+#include "mpeg-proto.h"
+#endif
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+#if defined(ENABLE_RTPPROXY)
+
+struct TestFrame {
+    int codecid;
+    int64_t pts;
+    string data;
+};
+
+static bool s_failed = false;
+
+#define TEST_CHECK(exp, msg) \
+    do { \
+        if (!(exp)) { \
+            ErrorL << "check failed: " << #exp << ", " << msg; \
+            s_failed = true; \
+        } \
+    } while (0)
+
+// 生成确定的帧数据，负载不含0字节，避免出现伪起始码
+static string makeNal(uint32_t &seed, uint8_t nal_type, size_t size) {
+    string ret("\x00\x00\x00\x01", 4);
+    ret.push_back((char)nal_type);
+    for (size_t i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        ret.push_back((char)((seed >> 16) % 255 + 1));
+    }
+    return ret;
+}
+
+static vector<TestFrame> makeFrames(int codecid, int count, int64_t pts_start) {
+    uint32_t seed = codecid * 31 + count;
+    vector<TestFrame> frames;
+    for (int i = 0; i < count; ++i) {
+        string data;
+        if (codecid == PSI_STREAM_H264) {
+            // 带上aud，ps打包器不会再额外插入
+            data.append("\x00\x00\x00\x01\x09\xF0", 6);
+            data += i % 10 == 0 ? makeNal(seed, 0x67, 12) + makeNal(seed, 0x68, 4) + makeNal(seed, 0x65, 150000) : makeNal(seed, 0x41, 3000 + i * 100);
+        } else {
+            data.append("\x00\x00\x00\x01\x46\x01\x50", 7);
+            data += i % 10 == 0 ? makeNal(seed, 0x40, 24).insert(5, 1, '\x01') + makeNal(seed, 0x42, 40).insert(5, 1, '\x01') + makeNal(seed, 0x44, 8).insert(5, 1, '\x01') + makeNal(seed, 0x26, 150000).insert(5, 1, '\x01')
+                                : makeNal(seed, 0x02, 3000 + i * 100).insert(5, 1, '\x01');
+        }
+        frames.push_back({ codecid, pts_start + i * 3600, std::move(data) });
+    }
+    return frames;
+}
+
+// 使用media-server的ps打包器生成ps流
+static string muxPS(const vector<TestFrame> &frames) {
+    struct Context {
+        string out;
+        string packet;
+    } ctx;
+    ps_muxer_func_t func = {
+        [](void *param, size_t bytes) -> void * {
+            auto ctx = (Context *)param;
+            ctx->packet.resize(bytes);
+            return (void *)ctx->packet.data();
+        },
+        [](void *param, void *packet) {},
+        [](void *param, int stream, void *packet, size_t bytes) -> int {
+            ((Context *)param)->out.append((char *)packet, bytes);
+            return 0;
+        }
+    };
+    auto muxer = ps_muxer_create(&func, &ctx);
+    auto stream = ps_muxer_add_stream(muxer, frames.front().codecid, nullptr, 0);
+    for (auto &frame : frames) {
+        auto key = frame.data.size() > 100000;
+        ps_muxer_input(muxer, stream, key ? 0x0001 : 0, frame.pts, frame.pts, frame.data.data(), frame.data.size());
+    }
+    ps_muxer_destroy(muxer);
+    return ctx.out;
+}
+
+// 删除所有psm，模拟不发送psm的设备
+static string stripPSM(const string &ps) {
+    string ret;
+    size_t pos = 0;
+    while (true) {
+        auto psm = ps.find(string("\x00\x00\x01\xBC", 4), pos);
+        if (psm == string::npos || psm + 6 > ps.size()) {
+            break;
+        }
+        ret.append(ps, pos, psm - pos);
+        pos = psm + 6 + (((uint8_t)ps[psm + 4] << 8) | (uint8_t)ps[psm + 5]);
+    }
+    if (pos < ps.size()) {
+        ret.append(ps, pos, string::npos);
+    }
+    return ret;
+}
+
+// 按照不同的长度切分输入，使ps单元头部、pes头部跨包
+static vector<string> splitPackets(const string &ps, bool tiny) {
+    static const size_t kTinySizes[] = { 1, 2, 3, 5, 7, 11, 13, 17, 1400 };
+    vector<string> packets;
+    size_t i = 0;
+    for (size_t pos = 0; pos < ps.size(); ++i) {
+        auto size = MIN(tiny ? kTinySizes[i % (sizeof(kTinySizes) / sizeof(kTinySizes[0]))] : 1400, ps.size() - pos);
+        packets.emplace_back(ps.substr(pos, size));
+        pos += size;
+    }
+    return packets;
+}
+
+struct DecodeResult {
+    vector<TestFrame> frames;
+    vector<int> stream_codecs;
+};
+
+static DecodeResult demuxPS(const vector<string> &packets, size_t drop_index = (size_t)-1) {
+    DecodeResult ret;
+    PSDecoder decoder;
+    decoder.setOnStream([&](int stream, int codecid, const void *extra, size_t bytes, int finish) {
+        ret.stream_codecs.emplace_back(codecid);
+    });
+    decoder.setOnDecodeBuffer([&](int stream, int codecid, int flags, int64_t pts, int64_t dts, const Buffer::Ptr &buffer) {
+        ret.frames.push_back({ codecid, pts, string(buffer->data(), buffer->size()) });
+    });
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (i == drop_index) {
+            // 与GB28181Process一致，发现丢包后重置解析器
+            decoder.reset();
+            continue;
+        }
+        auto buffer = std::make_shared<BufferString>(packets[i]);
+        decoder.input(buffer, (const uint8_t *)buffer->data(), buffer->size());
+    }
+    decoder.flush();
+    return ret;
+}
+
+static bool sameFrame(const TestFrame &a, const TestFrame &b) {
+    return a.codecid == b.codecid && a.pts == b.pts && a.data == b.data;
+}
+
+static void checkFrames(const vector<TestFrame> &out, const vector<TestFrame> &in, const string &name) {
+    TEST_CHECK(out.size() == in.size(), name << " frame count: " << out.size() << " != " << in.size());
+    for (size_t i = 0; i < MIN(out.size(), in.size()); ++i) {
+        TEST_CHECK(sameFrame(out[i], in[i]), name << " frame " << i << " mismatch, size: " << out[i].data.size() << " != " << in[i].data.size());
+    }
+}
+
+// 头部跨包
+static void testSplitHeader() {
+    auto frames = makeFrames(PSI_STREAM_H264, 30, 90000);
+    auto ps = muxPS(frames);
+    checkFrames(demuxPS(splitPackets(ps, false)).frames, frames, "split 1400");
+    auto ret = demuxPS(splitPackets(ps, true));
+    checkFrames(ret.frames, frames, "split tiny");
+    TEST_CHECK(!ret.stream_codecs.empty() && ret.stream_codecs.front() == PSI_STREAM_H264, "stream callback missing");
+}
+
+// psm中的编码格式改变
+static void testPSMChange() {
+    auto h264 = makeFrames(PSI_STREAM_H264, 20, 90000);
+    auto h265 = makeFrames(PSI_STREAM_H265, 20, 90000 + 20 * 3600);
+    auto ret = demuxPS(splitPackets(muxPS(h264) + muxPS(h265), true));
+    auto frames = h264;
+    frames.insert(frames.end(), h265.begin(), h265.end());
+    checkFrames(ret.frames, frames, "psm change");
+    TEST_CHECK(ret.stream_codecs.size() == 2 && ret.stream_codecs.back() == PSI_STREAM_H265, "psm change not notified");
+}
+
+// 没有psm时根据负载猜测编码格式
+static void testMissingPSM() {
+    auto frames = makeFrames(PSI_STREAM_H264, 30, 90000);
+    auto ret = demuxPS(splitPackets(stripPSM(muxPS(frames)), true));
+    checkFrames(ret.frames, frames, "missing psm");
+    TEST_CHECK(ret.stream_codecs.empty(), "stream callback without psm");
+}
+
+// 丢包后不能输出残缺的帧，之后的帧需要正常输出
+static void testPacketLoss() {
+    auto frames = makeFrames(PSI_STREAM_H264, 30, 90000);
+    auto packets = splitPackets(muxPS(frames), false);
+    for (size_t drop = 1; drop < packets.size(); drop += 7) {
+        auto ret = demuxPS(packets, drop);
+        size_t matched = 0;
+        for (auto &out : ret.frames) {
+            bool found = false;
+            for (; matched < frames.size() && !found; ++matched) {
+                found = sameFrame(out, frames[matched]);
+            }
+            TEST_CHECK(found, "corrupt frame after dropping packet " << drop << ", pts: " << out.pts << ", size: " << out.data.size());
+            if (!found) {
+                break;
+            }
+        }
+        // 最多丢失丢包处的前后两帧
+        TEST_CHECK(ret.frames.size() + 2 >= frames.size(), "too many frames lost after dropping packet " << drop << ": " << ret.frames.size());
+    }
+}
+
+#endif // defined(ENABLE_RTPPROXY)
+
+// 此程序用于测试ps解析器：使用ps打包器生成数据后解析，校验头部跨包、psm变化、缺少psm、丢包等场景
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>());
+#if defined(ENABLE_RTPPROXY)
+    testSplitHeader();
+    testPSMChange();
+    testMissingPSM();
+    testPacketLoss();
+    if (s_failed) {
+        ErrorL << "test ps decoder failed";
+        return -1;
+    }
+    InfoL << "test ps decoder success";
+#else
+    ErrorL << "please ENABLE_RTPPROXY and then test";
+#endif // defined(ENABLE_RTPPROXY)
+    return 0;
+}
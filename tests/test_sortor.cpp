@@ -10,11 +10,14 @@
 
 #include <map>
 #include <list>
+#include <vector>
 #include <iostream>
 #include <functional>
 #include "Rtsp/RtpReceiver.h"
+#include "Util/TimeTicker.h"
 
 using namespace std;
+using namespace toolkit;
 using namespace mediakit;
 
 void test_real() {
@@ -269,7 +272,73 @@ void test_rand(){
 #endif
 }
 
-//该测试程序用于检验rtp排序算法的正确性
+//生成模拟的rtp seq序列，reorder_percent为乱序概率，loss_percent为丢包概率
+static vector<uint16_t> makeSeqList(size_t count, int reorder_percent, int loss_percent) {
+    vector<uint16_t> ret;
+    ret.reserve(count);
+    uint32_t seed = 12345;
+    auto rand_percent = [&]() {
+        seed = seed * 1103515245 + 12345;
+        return (int) ((seed >> 16) % 100);
+    };
+    //从回环点附近开始
+    uint16_t seq = 0xFFFF - 1000;
+    for (size_t i = 0; i < count; ++i, ++seq) {
+        if (rand_percent() < loss_percent) {
+            continue;
+        }
+        if (!ret.empty() && rand_percent() < reorder_percent) {
+            //与上一个包交换顺序，再随机往前挪几个位置
+            ret.emplace_back(ret.back());
+            ret[ret.size() - 2] = seq;
+            for (size_t j = ret.size() - 2, n = rand_percent() % 4; j > 0 && n > 0; --j, --n) {
+                swap(ret[j], ret[j - 1]);
+            }
+            continue;
+        }
+        ret.emplace_back(seq);
+    }
+    return ret;
+}
+
+static void bench_one(const char *name, const vector<uint16_t> &seq_list, size_t loops) {
+    //与RtpPacket::Ptr一样使用智能指针作为负载，提前分配好避免计入内存分配耗时
+    vector<shared_ptr<uint16_t> > pkt_list;
+    pkt_list.reserve(seq_list.size());
+    for (auto seq : seq_list) {
+        pkt_list.emplace_back(std::make_shared<uint16_t>(seq));
+    }
+
+    size_t out = 0;
+    PacketSortor<shared_ptr<uint16_t> > sortor;
+    sortor.setOnSort([&](uint16_t seq, shared_ptr<uint16_t> packet) { ++out; });
+
+    Ticker ticker;
+    for (size_t i = 0; i < loops; ++i) {
+        sortor.clear();
+        for (size_t j = 0; j < seq_list.size(); ++j) {
+            sortor.sortPacket(seq_list[j], pkt_list[j]);
+        }
+        sortor.flush();
+    }
+    auto ms = ticker.elapsedTime();
+    auto total = seq_list.size() * loops;
+    cout << name << " 输入:" << total << " 输出:" << out
+         << " 耗时:" << ms << "ms"
+         << " 速度:" << total / 1000.0 / (ms ? ms : 1) << "Mpps" << endl;
+}
+
+//测试排序缓存在顺序、乱序、丢包场景下的吞吐量
+void test_bench() {
+    static constexpr size_t kCount = 100000;
+    static constexpr size_t kLoops = 50;
+    bench_one("顺序      ", makeSeqList(kCount, 0, 0), kLoops);
+    bench_one("5%乱序    ", makeSeqList(kCount, 5, 0), kLoops);
+    bench_one("10%丢包   ", makeSeqList(kCount, 0, 10), kLoops);
+    bench_one("5%乱序+10%丢包", makeSeqList(kCount, 5, 10), kLoops);
+}
+
+//该测试程序用于检验rtp排序算法的正确性以及性能
 int main(int argc, char *argv[]) {
     //测试真实的rtp seq
     cout << "###### 真实的rtp seq #####" << endl;
@@ -278,5 +347,9 @@ int main(int argc, char *argv[]) {
     //模拟rtp乱序、回环、丢包、重复情况
     cout << "###### 模拟的rtp seq #####" << endl;
     test_rand();
+
+    //测试排序性能
+    cout << "###### 排序性能 #####" << endl;
+    test_bench();
     return 0;
 }
\ No newline at end of file
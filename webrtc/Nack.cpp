@@ -8,8 +8,10 @@
  * may be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <cstring>
 #include "Nack.h"
 #include "Common/config.h"
+#include "Common/Metrics.h"
 
 using namespace std;
 using namespace toolkit;
@@ -24,6 +26,8 @@ namespace Rtc {
 const string kMaxNackMS = RTC_FIELD "maxNackMS";
 // Nack包检查间隔(包数量)
 const string kRtpCacheCheckInterval = RTC_FIELD "rtpCacheCheckInterval";
+// Nack缓存包最大个数(向上取整为2的次幂)
+const string kMaxRtpCacheSize = RTC_FIELD "maxRtpCacheSize";
 //~ nack发送端
 //最大保留的rtp丢包状态个数
 const string kNackMaxSize = RTC_FIELD "nackMaxSize";
@@ -39,6 +43,7 @@ const string kNackRtpSize = RTC_FIELD "nackRtpSize";
 static onceToken token([]() {
     mINI::Instance()[kMaxNackMS] = 5 * 1000;
     mINI::Instance()[kRtpCacheCheckInterval] = 100;
+    mINI::Instance()[kMaxRtpCacheSize] = 8192;
     mINI::Instance()[kNackMaxSize] = 2048;
     mINI::Instance()[kNackMaxMS] = 3 * 1000;
     mINI::Instance()[kNackMaxCount] = 15;
@@ -48,81 +53,85 @@ static onceToken token([]() {
 
 } // namespace Rtc
 
+static size_t popCount(uint64_t bits) {
+    size_t ret = 0;
+    for (; bits; bits &= bits - 1) {
+        ++ret;
+    }
+    return ret;
+}
+
 void NackList::pushBack(RtpPacket::Ptr rtp) {
-    auto seq = rtp->getSeq();
-    _nack_cache_seq.emplace_back(seq);
-    _nack_cache_pkt.emplace(seq, std::move(rtp));
-    GET_CONFIG(uint32_t, rtpcache_checkinterval, Rtc::kRtpCacheCheckInterval);
-    if (++_cache_ms_check < rtpcache_checkinterval) {
+    if (_shared_cache) {
+        // rtsp源已经缓存了该rtp
         return;
     }
-    _cache_ms_check = 0;
+    GET_CONFIG(uint32_t, max_cache_size, Rtc::kMaxRtpCacheSize);
     GET_CONFIG(uint32_t, maxnackms, Rtc::kMaxNackMS);
-    while (getCacheMS() >= maxnackms) {
-        // 需要清除部分nack缓存
-        popFront();
-    }
+    GET_CONFIG(uint32_t, rtpcache_checkinterval, Rtc::kRtpCacheCheckInterval);
+    _cache.setParams(max_cache_size, maxnackms, rtpcache_checkinterval);
+    _cache.pushBack(std::move(rtp));
 }
 
-void NackList::forEach(const FCI_NACK &nack, const function<void(const RtpPacket::Ptr &rtp)> &func) {
-    auto seq = nack.getPid();
-    for (auto bit : nack.getBitArray()) {
-        if (bit) {
-            // 丢包
-            RtpPacket::Ptr *ptr = getRtp(seq);
-            if (ptr) {
-                func(*ptr);
-            }
-        }
-        ++seq;
+NackList::~NackList() {
+    if (_shared_cache) {
+        // 最后一个播放器离开后rtsp源停止缓存rtp
+        _shared_cache->disable();
     }
 }
 
-void NackList::popFront() {
-    if (_nack_cache_seq.empty()) {
+void NackList::setSharedCache(RtpRetransmitCache::Ptr cache, TrackType type) {
+    if (cache == _shared_cache) {
         return;
     }
-    _nack_cache_pkt.erase(_nack_cache_seq.front());
-    _nack_cache_seq.pop_front();
+    if (_shared_cache) {
+        _shared_cache->disable();
+    }
+    GET_CONFIG(uint32_t, max_cache_size, Rtc::kMaxRtpCacheSize);
+    GET_CONFIG(uint32_t, maxnackms, Rtc::kMaxNackMS);
+    GET_CONFIG(uint32_t, rtpcache_checkinterval, Rtc::kRtpCacheCheckInterval);
+    cache->enable(max_cache_size, maxnackms, rtpcache_checkinterval);
+    _shared_cache = std::move(cache);
+    _type = type;
+    // 释放本地缓存
+    _cache = RtpSeqCache();
 }
 
-RtpPacket::Ptr *NackList::getRtp(uint16_t seq) {
-    auto it = _nack_cache_pkt.find(seq);
-    if (it == _nack_cache_pkt.end()) {
-        return nullptr;
-    }
-    return &it->second;
+void NackList::setSeqOffset(uint16_t offset, uint16_t begin_seq) {
+    _rebased = true;
+    _seq_offset = offset;
+    _begin_seq = begin_seq;
+    // 本地缓存的都是切换前的rtp
+    _cache = RtpSeqCache();
 }
 
-uint32_t NackList::getCacheMS() {
-    while (_nack_cache_seq.size() > 2) {
-        auto back_stamp = getRtpStamp(_nack_cache_seq.back());
-        if (back_stamp == -1) {
-            _nack_cache_seq.pop_back();
+void NackList::forEach(const FCI_NACK &nack, const function<void(const RtpPacket::Ptr &rtp)> &func) {
+    // 转换为原始seq
+    uint16_t seq = nack.getPid() - _seq_offset;
+    // 第一个包必丢，后面16个包的丢包状态直接从blp位图中获取
+    uint32_t bits = ((uint32_t)nack.getBlp() << 1) | 1;
+    for (; bits; bits >>= 1, ++seq) {
+        if (!(bits & 1)) {
             continue;
         }
-
-        auto front_stamp = getRtpStamp(_nack_cache_seq.front());
-        if (front_stamp == -1) {
-            _nack_cache_seq.pop_front();
+        if (_rebased && (uint16_t)(seq - _begin_seq) >= 0x8000) {
+            // 切换rtp源之前的rtp，已经无法重传
+            Metrics::add(Metrics::kWebRtcRetransmitMiss);
             continue;
         }
-
-        if (back_stamp >= front_stamp) {
-            return back_stamp - front_stamp;
+        RtpPacket::Ptr rtp;
+        if (_shared_cache) {
+            rtp = _shared_cache->getRtp(_type, seq);
+        } else if (auto ptr = _cache.getRtp(seq)) {
+            rtp = *ptr;
+        }
+        if (rtp) {
+            Metrics::add(Metrics::kWebRtcRetransmit);
+            func(rtp);
+        } else {
+            Metrics::add(Metrics::kWebRtcRetransmitMiss);
         }
-        // 很有可能回环了
-        return back_stamp + (UINT32_MAX - front_stamp);
-    }
-    return 0;
-}
-
-int64_t NackList::getRtpStamp(uint16_t seq) {
-    auto it = _nack_cache_pkt.find(seq);
-    if (it == _nack_cache_pkt.end()) {
-        return -1;
     }
-    return it->second->getStampMS(false);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -131,6 +140,34 @@ NackContext::NackContext() {
     setOnNack(nullptr);
 }
 
+uint32_t NackContext::getReceived(uint16_t seq, size_t count) const {
+    static constexpr size_t kWords = kWindowSize / 64;
+    auto index = (seq & (kWindowSize - 1)) >> 6;
+    auto shift = seq & 63;
+    uint64_t bits = _received[index] >> shift;
+    if (shift + count > 64) {
+        // 跨越了两个word
+        bits |= _received[(index + 1) & (kWords - 1)] << (64 - shift);
+    }
+    return (uint32_t)(bits & ((1ULL << count) - 1));
+}
+
+size_t NackContext::clearReceived(uint16_t seq, size_t count) {
+    size_t ret = 0;
+    while (count) {
+        auto index = (seq & (kWindowSize - 1)) >> 6;
+        auto shift = seq & 63;
+        auto n = std::min<size_t>(count, 64 - shift);
+        uint64_t mask = (n == 64 ? ~0ULL : ((1ULL << n) - 1)) << shift;
+        auto &word = _received[index];
+        ret += popCount(word & mask);
+        word &= ~mask;
+        seq += n;
+        count -= n;
+    }
+    return ret;
+}
+
 void NackContext::received(uint16_t seq, bool is_rtx) {
     if (!_started) {
         // 记录第一个seq
@@ -138,69 +175,66 @@ void NackContext::received(uint16_t seq, bool is_rtx) {
         _nack_seq = seq - 1;
     }
 
-    if (seq < _nack_seq && _nack_seq != UINT16_MAX && seq < 1024 && _nack_seq > UINT16_MAX - 1024) {
-        // seq回环,清空回环前状态
-        makeNack(UINT16_MAX, true);
-        _seq.emplace(seq);
+    uint16_t offset = seq - (uint16_t)(_nack_seq + 1);
+    if (is_rtx || offset > (UINT16_MAX >> 1)) {
+        // seq回退包(已经回环处理)，猜测其为重传包，清空其nack状态
+        clearNackStatus(seq);
         return;
     }
 
-    if (is_rtx || (seq < _nack_seq && _nack_seq != UINT16_MAX)) {
-        // seq非回环回退包，猜测其为重传包，清空其nack状态
-        clearNackStatus(seq);
-        return;
+    if (offset >= kWindowSize) {
+        // seq跳跃超出丢包检测窗口，丢包无法恢复，重新开始统计
+        WarnL << "rtp seq jumped: " << _nack_seq << " -> " << seq;
+        memset(_received, 0, sizeof(_received));
+        _received_count = 0;
+        _nack_seq = seq - 1;
     }
 
-    auto pr = _seq.emplace(seq);
-    if (!pr.second) {
+    if (isReceived(seq)) {
         // seq重复, 忽略
         return;
     }
-
-    auto max_seq = *_seq.rbegin();
-    auto min_seq = *_seq.begin();
-    auto diff = max_seq - min_seq;
-    if (diff > (UINT16_MAX >> 1)) {
-        // 回环后，收到回环前的大值seq, 忽略掉
-        _seq.erase(max_seq);
-        return;
+    setReceived(seq);
+    if (!_received_count++ || (uint16_t)(seq - _max_seq) <= (UINT16_MAX >> 1)) {
+        _max_seq = seq;
     }
-    if (min_seq == (uint16_t)(_nack_seq + 1) && _seq.size() == (size_t)diff + 1) {
+
+    auto diff = (uint16_t)(_max_seq - (uint16_t)(_nack_seq + 1));
+    if (_received_count == (size_t)diff + 1) {
         // 都是连续的seq，未丢包
-        _seq.clear();
-        _nack_seq = max_seq;
+        clearReceived(_nack_seq + 1, _received_count);
+        _received_count = 0;
+        _nack_seq = _max_seq;
     } else {
         // seq不连续，有丢包
-        makeNack(max_seq, false);
+        makeNack(_max_seq);
     }
 }
 
-void NackContext::makeNack(uint16_t max_seq, bool flush) {
-    // 尝试移除前面部分连续的seq
-    eraseFrontSeq();
+void NackContext::makeNack(uint16_t max_seq) {
     // 最多生成5个nack包，防止seq大幅跳跃导致一直循环
     auto max_nack = 5u;
     GET_CONFIG(uint32_t, nack_rtpsize, Rtc::kNackRtpSize);
     // kNackRtpSize must between 0 and 16
     nack_rtpsize = std::min<uint32_t>(nack_rtpsize, FCI_NACK::kBitSize);
-    while (_nack_seq != max_seq && max_nack--) {
+    while (max_nack--) {
+        // 尝试移除前面部分连续的seq
+        eraseFrontSeq();
+        if (_nack_seq == max_seq) {
+            break;
+        }
         // 一次不能发送超过16+1个rtp的状态
         uint16_t nack_rtp_count = std::min<uint16_t>(FCI_NACK::kBitSize, max_seq - (uint16_t)(_nack_seq + 1));
-        if (!flush && nack_rtp_count < nack_rtpsize) {
-            // 非flush状态下，seq个数不足以发送一次nack
+        if (nack_rtp_count < nack_rtpsize) {
+            // seq个数不足以发送一次nack
             break;
         }
-        vector<bool> vec;
-        vec.resize(nack_rtp_count, false);
-        for (size_t i = 0; i < nack_rtp_count; ++i) {
-            vec[i] = _seq.find((uint16_t)(_nack_seq + i + 2)) == _seq.end();
-        }
-        doNack(FCI_NACK(_nack_seq + 1, vec), true);
+        // 直接由接收状态位图生成blp
+        auto lost = ~getReceived(_nack_seq + 2, nack_rtp_count) & ((1u << nack_rtp_count) - 1);
+        doNack(FCI_NACK(_nack_seq + 1, (uint16_t)lost), true);
+        // 移除 <=_nack_seq + nack_rtp_count + 1 的seq
+        _received_count -= clearReceived(_nack_seq + 1, nack_rtp_count + 1);
         _nack_seq += nack_rtp_count + 1;
-        // 返回第一个比_last_max_seq大的元素
-        auto it = _seq.upper_bound(_nack_seq);
-        // 移除 <=_last_max_seq 的seq
-        _seq.erase(_seq.begin(), it);
     }
 }
 
@@ -216,29 +250,31 @@ void NackContext::doNack(const FCI_NACK &nack, bool record_nack) {
     if (record_nack) {
         recordNack(nack);
     }
+    // 第一个包必丢
+    Metrics::add(Metrics::kWebRtcNack, 1 + popCount(nack.getBlp()));
     _cb(nack);
 }
 
 void NackContext::eraseFrontSeq() {
     // 前面部分seq是连续的，未丢包，移除之
-    for (auto it = _seq.begin(); it != _seq.end();) {
-        if (*it != (uint16_t)(_nack_seq + 1)) {
-            // seq不连续，丢包了
-            break;
-        }
-        _nack_seq = *it;
-        it = _seq.erase(it);
+    while (_received_count && isReceived(_nack_seq + 1)) {
+        clearReceived(++_nack_seq, 1);
+        --_received_count;
     }
 }
 
 void NackContext::clearNackStatus(uint16_t seq) {
-    auto it = _nack_send_status.find(seq);
-    if (it == _nack_send_status.end()) {
+    if ((uint16_t)(seq - _status_begin) >= (uint16_t)(_status_end - _status_begin)) {
+        return;
+    }
+    auto &ref = _nack_send_status[seq & (_nack_send_status.size() - 1)];
+    if (!ref.nack_count) {
         return;
     }
     //收到重传包与第一个nack包间的时间约等于rtt时间
-    auto rtt = getCurrentMillisecond() - it->second.first_stamp;
-    _nack_send_status.erase(it);
+    auto rtt = getCurrentMillisecond() - ref.first_stamp;
+    ref.nack_count = 0;
+    popNackStatus();
 
     // 限定rtt在合理有效范围内
     GET_CONFIG(uint32_t, nack_maxms, Rtc::kNackMaxMS);
@@ -246,80 +282,109 @@ void NackContext::clearNackStatus(uint16_t seq) {
     _rtt = max<int>(10, min<int>(rtt, nack_maxms / nack_maxcount));
 }
 
+void NackContext::popNackStatus() {
+    // 移除前面无效的nack状态
+    while (_status_begin != _status_end && !_nack_send_status[_status_begin & (_nack_send_status.size() - 1)].nack_count) {
+        ++_status_begin;
+    }
+}
+
 void NackContext::recordNack(const FCI_NACK &nack) {
+    if (_nack_send_status.empty()) {
+        GET_CONFIG(uint32_t, nack_maxsize, Rtc::kNackMaxSize);
+        size_t size = 64;
+        while (size < nack_maxsize && size < (UINT16_MAX >> 1)) {
+            size <<= 1;
+        }
+        _nack_send_status.resize(size);
+    }
+    auto mask = _nack_send_status.size() - 1;
     auto now = getCurrentMillisecond();
     auto i = nack.getPid();
-    for (auto flag : nack.getBitArray()) {
-        if (flag) {
-            auto &ref = _nack_send_status[i];
-            ref.first_stamp = now;
-            ref.update_stamp = now;
-            ref.nack_count = 1;
-        }
-        ++i;
+    if (_status_begin == _status_end) {
+        _status_begin = _status_end = i;
     }
-    // 记录太多了，移除一部分早期的记录
-    GET_CONFIG(uint32_t, nack_maxsize, Rtc::kNackMaxSize);
-    while (_nack_send_status.size() > nack_maxsize) {
-        _nack_send_status.erase(_nack_send_status.begin());
+    uint32_t bits = ((uint32_t)nack.getBlp() << 1) | 1;
+    for (; bits; bits >>= 1, ++i) {
+        if (!(bits & 1)) {
+            continue;
+        }
+        if ((uint16_t)(i - _status_begin) > (UINT16_MAX >> 1)) {
+            // 比最早的nack状态还旧，忽略
+            continue;
+        }
+        while ((uint16_t)(i - _status_begin) > mask) {
+            // 记录太多了，移除一部分早期的记录
+            _nack_send_status[_status_begin++ & mask].nack_count = 0;
+            popNackStatus();
+            if (_status_begin == _status_end) {
+                _status_begin = _status_end = i;
+            }
+        }
+        if ((uint16_t)(i - _status_begin) >= (uint16_t)(_status_end - _status_begin)) {
+            _status_end = i + 1;
+        }
+        auto &ref = _nack_send_status[i & mask];
+        ref.first_stamp = now;
+        ref.update_stamp = now;
+        ref.nack_count = 1;
     }
 }
 
 uint64_t NackContext::reSendNack() {
-    set<uint16_t> nack_rtp;
+    if (_status_begin == _status_end) {
+        return 0;
+    }
+    auto mask = _nack_send_status.size() - 1;
     auto now = getCurrentMillisecond();
     GET_CONFIG(uint32_t, nack_maxms, Rtc::kNackMaxMS);
     GET_CONFIG(uint32_t, nack_maxcount, Rtc::kNackMaxCount);
     GET_CONFIG(float, nack_intervalratio, Rtc::kNackIntervalRatio);
-    for (auto it = _nack_send_status.begin(); it != _nack_send_status.end();) {
-        if (now - it->second.first_stamp > nack_maxms) {
+
+    int pid = -1;
+    uint16_t blp = 0;
+    for (auto seq = _status_begin; seq != _status_end; ++seq) {
+        auto &ref = _nack_send_status[seq & mask];
+        if (!ref.nack_count) {
+            continue;
+        }
+        if (now - ref.first_stamp > nack_maxms) {
             // 该rtp丢失太久了，不再要求重传
-            it = _nack_send_status.erase(it);
+            ref.nack_count = 0;
             continue;
         }
-        if (now - it->second.update_stamp < nack_intervalratio * _rtt) {
+        if (now - ref.update_stamp < nack_intervalratio * _rtt) {
             // 距离上次nack不足2倍的rtt，不用再发送nack
-            ++it;
             continue;
         }
-        // 此rtp需要请求重传
-        nack_rtp.emplace(it->first);
         // 更新nack发送时间戳
-        it->second.update_stamp = now;
-        if (++(it->second.nack_count) == nack_maxcount) {
+        ref.update_stamp = now;
+        if (++ref.nack_count == (int)nack_maxcount) {
             // nack次数太多，移除之
-            it = _nack_send_status.erase(it);
-            continue;
+            ref.nack_count = 0;
         }
-        ++it;
-    }
 
-    int pid = -1;
-    vector<bool> vec;
-    for (auto it = nack_rtp.begin(); it != nack_rtp.end();) {
-        if (pid == -1) {
-            pid = *it;
-            vec.assign(FCI_NACK::kBitSize, false);
-            ++it;
-            continue;
-        }
-        auto inc = *it - pid;
-        if (inc > (ssize_t)FCI_NACK::kBitSize) {
+        // 此rtp需要请求重传
+        if (pid != -1) {
+            uint16_t inc = seq - (uint16_t)pid;
+            if (inc <= FCI_NACK::kBitSize) {
+                // 这个包丢了
+                blp |= 1 << (inc - 1);
+                continue;
+            }
             // 新的nack包
-            doNack(FCI_NACK(pid, vec), false);
-            pid = -1;
-            continue;
+            doNack(FCI_NACK(pid, blp), false);
         }
-        // 这个包丢了
-        vec[inc - 1] = true;
-        ++it;
+        pid = seq;
+        blp = 0;
     }
     if (pid != -1) {
-        doNack(FCI_NACK(pid, vec), false);
+        doNack(FCI_NACK(pid, blp), false);
     }
+    popNackStatus();
 
     // 没有任何包需要重传时返回0，否则返回下次重传间隔(不得低于5ms)
-    return _nack_send_status.empty() ? 0 : _rtt;
+    return _status_begin == _status_end ? 0 : _rtt;
 }
 
 } // namespace mediakit
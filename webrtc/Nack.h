@@ -11,30 +11,45 @@
 #ifndef ZLMEDIAKIT_NACK_H
 #define ZLMEDIAKIT_NACK_H
 
-#include <set>
-#include <map>
-#include <deque>
-#include <unordered_map>
+#include <vector>
+#include <functional>
 #include "Rtsp/Rtsp.h"
+#include "Rtsp/RtpRetransmitCache.h"
 #include "Rtcp/RtcpFCI.h"
 
 namespace mediakit {
 
 class NackList {
 public:
+    NackList() = default;
+    NackList(const NackList &) = delete;
+    NackList &operator=(const NackList &) = delete;
+    ~NackList();
+
     void pushBack(RtpPacket::Ptr rtp);
     void forEach(const FCI_NACK &nack, const std::function<void(const RtpPacket::Ptr &rtp)> &cb);
 
-private:
-    void popFront();
-    uint32_t getCacheMS();
-    int64_t getRtpStamp(uint16_t seq);
-    RtpPacket::Ptr *getRtp(uint16_t seq);
+    /**
+     * 使用rtsp源共享的重传缓存，此后不再单独缓存rtp；不再使用之前的共享缓存时减少其使用者
+     * @param cache 共享的重传缓存
+     * @param type 本track的类型
+     */
+    void setSharedCache(RtpRetransmitCache::Ptr cache, TrackType type);
+
+    /**
+     * 切换rtp源后，发送的rtp seq为原始seq加上偏移量，此后只能重传切换后的rtp
+     * @param offset seq偏移量
+     * @param begin_seq 切换后第一个rtp的原始seq
+     */
+    void setSeqOffset(uint16_t offset, uint16_t begin_seq);
 
 private:
-    uint32_t _cache_ms_check = 0;
-    std::deque<uint16_t> _nack_cache_seq;
-    std::unordered_map<uint16_t, RtpPacket::Ptr> _nack_cache_pkt;
+    bool _rebased = false;
+    uint16_t _seq_offset = 0;
+    uint16_t _begin_seq = 0;
+    TrackType _type = TrackInvalid;
+    RtpSeqCache _cache;
+    RtpRetransmitCache::Ptr _shared_cache;
 };
 
 class NackContext {
@@ -42,6 +57,9 @@ public:
     using Ptr = std::shared_ptr<NackContext>;
     using onNack = std::function<void(const FCI_NACK &nack)>;
 
+    // 丢包检测窗口大小(rtp个数)
+    static constexpr size_t kWindowSize = 2048;
+
     NackContext();
 
     void received(uint16_t seq, bool is_rtx = false);
@@ -53,22 +71,40 @@ private:
     void doNack(const FCI_NACK &nack, bool record_nack);
     void recordNack(const FCI_NACK &nack);
     void clearNackStatus(uint16_t seq);
-    void makeNack(uint16_t max, bool flush = false);
+    void makeNack(uint16_t max_seq);
+    void popNackStatus();
+
+    bool isReceived(uint16_t seq) const { return _received[(seq & (kWindowSize - 1)) >> 6] & (1ULL << (seq & 63)); }
+    void setReceived(uint16_t seq) { _received[(seq & (kWindowSize - 1)) >> 6] |= (1ULL << (seq & 63)); }
+    // 获取从seq开始count(不超过32)个rtp的接收状态，第i位对应seq + i
+    uint32_t getReceived(uint16_t seq, size_t count) const;
+    // 清除从seq开始count个rtp的接收状态, 返回其中已接收的个数
+    size_t clearReceived(uint16_t seq, size_t count);
 
 private:
     bool _started = false;
     int _rtt = 50;
     onNack _cb;
-    std::set<uint16_t> _seq;
     // 最新nack包中的rtp seq值
     uint16_t _nack_seq = 0;
+    // _nack_seq之后已接收的最大seq
+    uint16_t _max_seq = 0;
+    // _nack_seq之后已接收的rtp个数
+    size_t _received_count = 0;
+    // _nack_seq之后的rtp接收状态位图，以seq为下标的环形数组
+    uint64_t _received[kWindowSize / 64] = { 0 };
 
     struct NackStatus {
-        uint64_t first_stamp;
-        uint64_t update_stamp;
+        uint64_t first_stamp = 0;
+        uint64_t update_stamp = 0;
+        // 为0时表示该seq无nack状态
         int nack_count = 0;
     };
-    std::map<uint16_t /*seq*/, NackStatus> _nack_send_status;
+    // nack状态的seq范围为[_status_begin, _status_end)
+    uint16_t _status_begin = 0;
+    uint16_t _status_end = 0;
+    // nack发送状态，以seq为下标的环形数组，长度为2的次幂
+    std::vector<NackStatus> _nack_send_status;
 };
 
 } // namespace mediakit
@@ -361,6 +361,13 @@ uint16_t RtpExt::getTransportCCSeq() const {
     return ret;
 }
 
+void RtpExt::setTransportCCSeq(uint16_t seq) {
+    CHECK(_type == RtpExtType::transport_cc && size() >= 2);
+    auto ptr = (uint8_t *)_data;
+    ptr[0] = seq >> 8;
+    ptr[1] = seq & 0xFF;
+}
+
 //https://tools.ietf.org/html/draft-ietf-avtext-sdes-hdr-ext-07
 //    0                   1                   2                   3
 //    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
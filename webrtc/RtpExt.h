@@ -92,6 +92,8 @@ public:
     uint8_t getFramemarkingTID() const;
 
     void setExtId(uint8_t ext_id);
+    // 修改transport-cc扩展的seq，发送端统一分配
+    void setTransportCCSeq(uint16_t seq);
     void clearExt();
     operator bool () const;
 
@@ -0,0 +1,123 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include "SendSideBwe.h"
+#include "Rtcp/RtcpFCI.h"
+#include "Util/util.h"
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+// 未配置时的默认码率范围
+static constexpr uint32_t kDefaultMinBitrate = 50 * 1000;
+static constexpr uint32_t kDefaultMaxBitrate = 20 * 1000 * 1000;
+
+SendSideBwe::SendSideBwe() {
+    setParams(0, 0, 0);
+}
+
+void SendSideBwe::setParams(uint32_t start_bps, uint32_t min_bps, uint32_t max_bps) {
+    _min_bps = min_bps ? min_bps : kDefaultMinBitrate;
+    _max_bps = max_bps ? max_bps : kDefaultMaxBitrate;
+    _max_bps = MAX(_max_bps, _min_bps);
+    _start_bps = start_bps ? MIN(MAX(start_bps, _min_bps), _max_bps) : 0;
+    _estimate = _start_bps;
+}
+
+void SendSideBwe::onSendRtp(size_t bytes) {
+    _send_speed += bytes;
+}
+
+void SendSideBwe::onSendTwccRtp(uint16_t twcc_seq, size_t bytes) {
+    auto &info = _history[twcc_seq & (kHistorySize - 1)];
+    info.seq = twcc_seq;
+    info.bytes = (uint32_t)bytes;
+    info.lost = false;
+}
+
+void SendSideBwe::onTwcc(const FCI_TWCC &fci, size_t total_size) {
+    _last_twcc = getCurrentMillisecond();
+    for (auto &pr : fci.getPacketChunkList(total_size)) {
+        auto &info = _history[pr.first & (kHistorySize - 1)];
+        if (info.seq != pr.first || !info.bytes) {
+            // 不是本端发送的包，或者已经统计过了
+            continue;
+        }
+        if (pr.second.first == SymbolStatus::not_received) {
+            // 未收到的包可能在下次反馈中被确认收到，所以不清除发送记录，但只统计一次丢包
+            if (!info.lost) {
+                info.lost = true;
+                info.window = _window;
+                ++_total;
+                ++_lost;
+            }
+            continue;
+        }
+        if (!info.lost) {
+            ++_total;
+        } else if (info.window == _window) {
+            // 之前统计为丢包，实际是乱序晚到，撤销本窗口的丢包统计(之前窗口已计算过丢包率，不再修正)
+            --_lost;
+        }
+        info.bytes = 0;
+    }
+    if (_total >= kMinLossPackets) {
+        onLossRate((float)_lost / _total);
+        _lost = _total = 0;
+        ++_window;
+    }
+}
+
+void SendSideBwe::onRemb(uint32_t bitrate_bps) {
+    _remb_bps = bitrate_bps;
+    if (_estimate > _remb_bps) {
+        _estimate = MAX(_remb_bps, _min_bps);
+    }
+}
+
+void SendSideBwe::onReceiverReport(uint8_t fraction) {
+    if (getCurrentMillisecond() - _last_twcc < kTwccTimeoutMS) {
+        // twcc反馈更及时准确，优先使用
+        return;
+    }
+    onLossRate(fraction / 256.0f);
+}
+
+void SendSideBwe::onLossRate(float loss) {
+    _loss_rate = loss;
+    auto now = getCurrentMillisecond();
+    uint64_t estimate = _estimate;
+    if (!estimate) {
+        // 未设置初始码率，以当前发送码率作为初始值
+        estimate = (uint64_t)_send_speed.getSpeed() * 8;
+    }
+    if (loss < 0.02f) {
+        // 丢包率低于2%，每秒提升8%
+        if (now - _last_increase >= kIncreaseIntervalMS) {
+            _last_increase = now;
+            estimate = estimate * 108 / 100 + 1000;
+        }
+    } else if (loss > 0.1f) {
+        // 丢包率高于10%，按照丢包率降低码率
+        if (now - _last_decrease >= kDecreaseIntervalMS) {
+            _last_decrease = now;
+            estimate = (uint64_t)(estimate * (1 - 0.5f * loss));
+        }
+    }
+    if (_remb_bps) {
+        estimate = MIN(estimate, (uint64_t)_remb_bps);
+    }
+    _estimate = (uint32_t)MIN(MAX(estimate, (uint64_t)_min_bps), (uint64_t)_max_bps);
+}
+
+}// namespace mediakit
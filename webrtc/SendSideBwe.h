@@ -0,0 +1,114 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_SENDSIDEBWE_H
+#define ZLMEDIAKIT_SENDSIDEBWE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Util/SpeedStatistic.h"
+
+namespace mediakit {
+
+class FCI_TWCC;
+
+/**
+ * 发送端带宽估计(参考gcc的基于丢包的码率控制)
+ * 根据播放端的twcc反馈统计丢包率，没有twcc时使用rr中的丢包率，
+ * 同时不超过播放端remb反馈的码率
+ */
+class SendSideBwe {
+public:
+    // 记录发送历史的rtp个数
+    static constexpr size_t kHistorySize = 4096;
+    // 至少统计多少个rtp后才计算一次丢包率
+    static constexpr size_t kMinLossPackets = 20;
+    // 码率上升、下降的最小间隔，单位毫秒
+    static constexpr uint64_t kIncreaseIntervalMS = 1000;
+    static constexpr uint64_t kDecreaseIntervalMS = 300;
+    // 超过该时长未收到twcc反馈，则使用rr的丢包率，单位毫秒
+    static constexpr uint64_t kTwccTimeoutMS = 2000;
+
+    SendSideBwe();
+
+    /**
+     * 设置码率范围，单位bps，为0时使用默认值
+     * @param start_bps 初始码率，为0时以首次反馈时的发送码率作为初始值
+     */
+    void setParams(uint32_t start_bps, uint32_t min_bps, uint32_t max_bps);
+
+    /**
+     * 发送rtp(含重传)时调用，统计发送码率
+     */
+    void onSendRtp(size_t bytes);
+
+    /**
+     * 发送带transport-cc扩展的rtp时调用，记录发送历史
+     */
+    void onSendTwccRtp(uint16_t twcc_seq, size_t bytes);
+
+    /**
+     * 收到twcc反馈
+     * @param total_size fci总长度
+     */
+    void onTwcc(const FCI_TWCC &fci, size_t total_size);
+
+    /**
+     * 收到remb反馈
+     */
+    void onRemb(uint32_t bitrate_bps);
+
+    /**
+     * 收到rr，fraction为rfc3550定义的丢包比例(x/256)
+     */
+    void onReceiverReport(uint8_t fraction);
+
+    /**
+     * 获取估计的可用码率，单位bps，为0时表示尚无估计
+     */
+    uint32_t getEstimate() const { return _estimate; }
+
+    /**
+     * 获取最近一次统计的丢包率
+     */
+    float getLossRate() const { return _loss_rate; }
+
+private:
+    void onLossRate(float loss);
+
+private:
+    struct SendInfo {
+        uint16_t seq = 0;
+        uint32_t bytes = 0;
+        // 是否已经被twcc反馈统计为丢包
+        bool lost = false;
+        // 统计为丢包时所在的统计窗口
+        uint32_t window = 0;
+    };
+
+    uint32_t _start_bps = 0;
+    uint32_t _min_bps;
+    uint32_t _max_bps;
+    uint32_t _remb_bps = 0;
+    uint32_t _estimate = 0;
+    float _loss_rate = 0;
+    size_t _lost = 0;
+    size_t _total = 0;
+    // 当前丢包率统计窗口序号
+    uint32_t _window = 0;
+    uint64_t _last_increase = 0;
+    uint64_t _last_decrease = 0;
+    uint64_t _last_twcc = 0;
+    toolkit::BytesSpeed _send_speed;
+    SendInfo _history[kHistorySize];
+};
+
+}// namespace mediakit
+#endif //ZLMEDIAKIT_SENDSIDEBWE_H
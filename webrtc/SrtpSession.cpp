@@ -227,6 +227,7 @@ SrtpSession::~SrtpSession() {
 
 bool SrtpSession::EncryptRtp(uint8_t *data, int *len) {
     MS_TRACE();
+    std::lock_guard<std::mutex> lck(_mtx);
     srtp_err_status_t err = srtp_protect(this->session, static_cast<void *>(data), reinterpret_cast<int *>(len));
 
     if (DepLibSRTP::IsError(err)) {
@@ -237,6 +238,27 @@ bool SrtpSession::EncryptRtp(uint8_t *data, int *len) {
     return true;
 }
 
+size_t SrtpSession::EncryptRtpList(std::vector<toolkit::BufferRaw::Ptr> &pkt_list) {
+    MS_TRACE();
+    std::lock_guard<std::mutex> lck(_mtx);
+    size_t ok = 0;
+    for (auto &pkt : pkt_list) {
+        int len = (int)pkt->size();
+        srtp_err_status_t err = srtp_protect(this->session, static_cast<void *>(pkt->data()), &len);
+        if (DepLibSRTP::IsError(err)) {
+            WarnL << "srtp_protect() failed:" << DepLibSRTP::GetErrorString(err);
+            continue;
+        }
+        pkt->setSize(len);
+        if (&pkt_list[ok] != &pkt) {
+            pkt_list[ok] = std::move(pkt);
+        }
+        ++ok;
+    }
+    pkt_list.resize(ok);
+    return ok;
+}
+
 bool SrtpSession::DecryptSrtp(uint8_t *data, int *len) {
     MS_TRACE();
 
@@ -252,6 +274,7 @@ bool SrtpSession::DecryptSrtp(uint8_t *data, int *len) {
 
 bool SrtpSession::EncryptRtcp(uint8_t *data, int *len) {
     MS_TRACE();
+    std::lock_guard<std::mutex> lck(_mtx);
     srtp_err_status_t err = srtp_protect_rtcp(this->session, static_cast<void *>(data), reinterpret_cast<int *>(len));
 
     if (DepLibSRTP::IsError(err)) {
@@ -276,6 +299,7 @@ bool SrtpSession::DecryptSrtcp(uint8_t *data, int *len) {
 }
 
 void SrtpSession::RemoveStream(uint32_t ssrc) {
+    std::lock_guard<std::mutex> lck(_mtx);
     srtp_remove_stream(this->session, uint32_t { htonl(ssrc) });
 }
 
@@ -20,8 +20,11 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #define MS_RTC_SRTP_SESSION_HPP
 
 #include "Utils.hpp"
+#include "Network/Buffer.h"
 
+#include <mutex>
 #include <memory>
+#include <vector>
 
 typedef struct srtp_ctx_t_ *srtp_t;
 
@@ -48,6 +51,8 @@ public:
 
 public:
     bool EncryptRtp(uint8_t *data, int *len);
+    // 批量加密rtp(一次加锁)，buffer需预留SRTP_MAX_TRAILER_LEN，加密失败的包会被移除，返回成功个数
+    size_t EncryptRtpList(std::vector<toolkit::BufferRaw::Ptr> &pkt_list);
     bool DecryptSrtp(uint8_t *data, int *len);
     bool EncryptRtcp(uint8_t *data, int *len);
     bool DecryptSrtcp(uint8_t *data, int *len);
@@ -57,6 +62,8 @@ private:
     // Allocated by this.
     srtp_t session { nullptr };
     std::shared_ptr<DepLibSRTP> _env;
+    // 发送加密可能被转移到加密线程池执行，libsrtp的session不是线程安全的
+    std::mutex _mtx;
 };
 
 } // namespace RTC
@@ -8,6 +8,7 @@
  * may be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include "WebRtcPlayer.h"
 #include "Common/config.h"
 
@@ -15,6 +16,24 @@ using namespace std;
 
 namespace mediakit {
 
+// RTC配置项目
+namespace Rtc {
+#define RTC_FIELD "rtc."
+// webrtc推流开启simulcast时，是否根据播放端带宽估计自动切换simulcast层
+const string kSimulcastAutoSwitch = RTC_FIELD "simulcastAutoSwitch";
+// 平滑发送的码率为输入码率的倍数，置0关闭平滑发送
+const string kPacerRatio = RTC_FIELD "pacerRatio";
+
+static onceToken token([]() {
+    mINI::Instance()[kSimulcastAutoSwitch] = 1;
+    mINI::Instance()[kPacerRatio] = 0;
+});
+
+} // namespace Rtc
+
+// simulcast层切换检查间隔，单位毫秒
+static constexpr uint64_t kLayerCheckIntervalMS = 2000;
+
 WebRtcPlayer::Ptr WebRtcPlayer::create(const EventPoller::Ptr &poller,
                                        const RtspMediaSource::Ptr &src,
                                        const MediaInfo &info) {
@@ -43,49 +62,211 @@ void WebRtcPlayer::onStartWebRTC() {
     WebRtcTransportImp::onStartWebRTC();
     if (canSendRtp()) {
         playSrc->pause(false);
-        _reader = playSrc->getRing()->attach(getPoller(), true);
-        weak_ptr<WebRtcPlayer> weak_self = static_pointer_cast<WebRtcPlayer>(shared_from_this());
-        weak_ptr<Session> weak_session = static_pointer_cast<Session>(getSession());
-        _reader->setGetInfoCB([weak_session]() {
-            Any ret;
-            ret.set(static_pointer_cast<SockInfo>(weak_session.lock()));
-            return ret;
-        });
-        _reader->setReadCB([weak_self](const RtspMediaSource::RingDataType &pkt) {
-            auto strong_self = weak_self.lock();
-            if (!strong_self) {
+        // 同一个源的播放器共享rtp重传缓存
+        setRetransmitCache(playSrc->getRetransmitCache());
+        _reader = attachReader(playSrc, true);
+    }
+}
+
+RtspMediaSource::RingType::RingReader::Ptr WebRtcPlayer::attachReader(const RtspMediaSource::Ptr &src, bool use_cache) {
+    auto reader = src->getRing()->attach(getPoller(), use_cache);
+    auto reader_ptr = reader.get();
+    if (use_cache) {
+        // 首次播放的reader，设置回调时会同步回放gop缓存，需要先成为当前reader，否则gop会被丢弃
+        _reader = reader;
+    }
+    weak_ptr<WebRtcPlayer> weak_self = static_pointer_cast<WebRtcPlayer>(shared_from_this());
+    weak_ptr<Session> weak_session = static_pointer_cast<Session>(getSession());
+    reader->setGetInfoCB([weak_session]() {
+        Any ret;
+        ret.set(static_pointer_cast<SockInfo>(weak_session.lock()));
+        return ret;
+    });
+    // 设置回调时会同步回放gop缓存，回放数据的延时为gop的时长，不计入发送延时统计
+    LatencyStat::ReplayScope replay_scope;
+    // 回放的gop在开启重传缓存前已经写入环形缓存，收集后填充到重传缓存，以便首屏丢包也能重传
+    std::vector<RtpPacket::Ptr> gop_rtps;
+    _gop_rtps = use_cache ? &gop_rtps : nullptr;
+    reader->setReadCB([weak_self, reader_ptr](const RtspMediaSource::RingDataType &pkt) {
+        auto strong_self = weak_self.lock();
+        if (!strong_self) {
+            return;
+        }
+        if (strong_self->_reader.get() != reader_ptr) {
+            // 待切换的simulcast层，收到关键帧时才切换，否则播放端花屏
+            if (strong_self->_pending_reader.get() != reader_ptr || !pkt->isKeyPos() || !strong_self->switchLayer()) {
                 return;
             }
-            size_t i = 0;
-            pkt->for_each([&](const RtpPacket::Ptr &rtp) {
-                //TraceL<<"send track type:"<<rtp->type<<" ts:"<<rtp->getStamp()<<" ntp:"<<rtp->ntp_stamp<<" size:"<<rtp->getPayloadSize()<<" i:"<<i;
-                strong_self->onSendRtp(rtp, ++i == pkt->size());
-            });
+        }
+        if (strong_self->_gop_rtps) {
+            pkt->for_each([&](const RtpPacket::Ptr &rtp) { strong_self->_gop_rtps->emplace_back(rtp); });
+        }
+        strong_self->sendRtpList(pkt);
+    });
+    _gop_rtps = nullptr;
+    if (!gop_rtps.empty()) {
+        src->getRetransmitCache()->seed(gop_rtps);
+    }
+    reader->setDetachCB([weak_self, reader_ptr]() {
+        auto strong_self = weak_self.lock();
+        if (!strong_self) {
+            return;
+        }
+        if (strong_self->_reader.get() != reader_ptr) {
+            // 待切换的simulcast层已经注销，放弃切换
+            strong_self->_pending_src.reset();
+            return;
+        }
+        strong_self->onShutdown(SockException(Err_shutdown, "rtsp ring buffer detached"));
+    });
+
+    reader->setMessageCB([weak_self, reader_ptr] (const toolkit::Any &data) {
+        auto strong_self = weak_self.lock();
+        if (!strong_self || strong_self->_reader.get() != reader_ptr) {
+            return;
+        }
+        if (data.is<Buffer>()) {
+            auto &buffer = data.get<Buffer>();
+            // PPID 51: 文本string
+            // PPID 53: 二进制
+            strong_self->sendDatachannel(0, 51, buffer.data(), buffer.size());
+        } else {
+            WarnL << "Send unknown message type to webrtc player: " << data.type_name();
+        }
+    });
+    return reader;
+}
+
+void WebRtcPlayer::onBitrateEstimate(uint32_t bitrate) {
+    GET_CONFIG(bool, auto_switch, Rtc::kSimulcastAutoSwitch);
+    if (!auto_switch || !bitrate || !_reader || _layer_ticker.elapsedTime() < kLayerCheckIntervalMS) {
+        return;
+    }
+    _layer_ticker.resetTime();
+    auto play_src = _play_src.lock();
+    if (!play_src) {
+        return;
+    }
+    auto target = selectLayer(play_src, bitrate);
+    if (!target || target == play_src) {
+        // 不需要切换，取消等待中的切换
+        _pending_reader = nullptr;
+        _pending_src.reset();
+        return;
+    }
+    if (_pending_reader && _pending_src.lock() == target) {
+        // 正在等待该层的关键帧
+        return;
+    }
+    DebugL << "RTC播放器(" << _media_info.shortUrl() << ")带宽估计:" << bitrate << "bps, 准备切换到:" << target->getMediaTuple().shortUrl();
+    _pending_src = target;
+    _pending_reader = attachReader(target, false);
+}
+
+RtspMediaSource::Ptr WebRtcPlayer::selectLayer(const RtspMediaSource::Ptr &cur, uint32_t bitrate) const {
+    if (cur->getOriginType() != MediaOriginType::rtc_push) {
+        // 只有webrtc推流才有simulcast
+        return nullptr;
+    }
+    // 同一个webrtc推流产生的simulcast层，推流url相同
+    auto origin_url = cur->getOriginUrl();
+    auto &tuple = cur->getMediaTuple();
+    vector<pair<uint32_t /*bps*/, RtspMediaSource::Ptr> > layers;
+    MediaSource::for_each_media([&](const MediaSource::Ptr &src) {
+        auto rtsp_src = dynamic_pointer_cast<RtspMediaSource>(src);
+        if (!rtsp_src || src->getOriginType() != MediaOriginType::rtc_push || src->getOriginUrl() != origin_url) {
+            return;
+        }
+        auto layer_bitrate = (uint32_t)src->getBytesSpeed(TrackVideo) * 8;
+        if (layer_bitrate) {
+            layers.emplace_back(layer_bitrate, std::move(rtsp_src));
+        }
+    }, RTSP_SCHEMA, tuple.vhost, tuple.app);
+    if (layers.size() < 2) {
+        return nullptr;
+    }
+    sort(layers.begin(), layers.end(), [](const pair<uint32_t, RtspMediaSource::Ptr> &a, const pair<uint32_t, RtspMediaSource::Ptr> &b) {
+        return a.first < b.first;
+    });
+
+    auto cur_bitrate = (uint32_t)cur->getBytesSpeed(TrackVideo) * 8;
+    // 带宽都不够时使用码率最低的层
+    auto ret = layers.front().second;
+    for (auto &layer : layers) {
+        // 切换到更高的层时预留25%的余量，避免来回切换
+        uint64_t need = layer.first > cur_bitrate ? (uint64_t)layer.first * 5 / 4 : layer.first;
+        if (need <= bitrate) {
+            ret = layer.second;
+        }
+    }
+    return ret;
+}
+
+void WebRtcPlayer::sendRtpList(const RtspMediaSource::RingDataType &pkt) {
+    GET_CONFIG(float, pacer_ratio, Rtc::kPacerRatio);
+    if (pacer_ratio <= 0 && (!_pacer || !_pacer->getCacheBytes())) {
+        // 未开启平滑发送，直接发送
+        _pacer = nullptr;
+        _pacer_stamps.clear();
+        size_t i = 0;
+        auto size = pkt->size();
+        pkt->for_each([&](const RtpPacket::Ptr &rtp) {
+            //TraceL<<"send track type:"<<rtp->type<<" ts:"<<rtp->getStamp()<<" ntp:"<<rtp->ntp_stamp<<" size:"<<rtp->getPayloadSize();
+            onSendRtp(rtp, ++i == size);
         });
-        _reader->setDetachCB([weak_self]() {
-            auto strong_self = weak_self.lock();
-            if (!strong_self) {
-                return;
+        LatencyStat::onSend(LatencyStat::kRingToWebRtc, *pkt);
+        return;
+    }
+    if (!_pacer) {
+        weak_ptr<WebRtcPlayer> weak_self = static_pointer_cast<WebRtcPlayer>(shared_from_this());
+        _pacer = std::make_shared<PacketPacer<RtpPacket::Ptr> >([weak_self](RtpPacket::Ptr rtp, bool flush) {
+            if (auto strong_self = weak_self.lock()) {
+                strong_self->onSendRtp(rtp, flush);
+                strong_self->onPacerSent(rtp);
             }
-            strong_self->onShutdown(SockException(Err_shutdown, "rtsp ring buffer detached"));
         });
+    }
+    _pacer->setRatio(pacer_ratio);
+    pkt->for_each([&](const RtpPacket::Ptr &rtp) { _pacer->inputPacket(rtp); });
+    auto stamp = pkt->getRingStamp();
+    if (stamp && !pkt->empty() && !LatencyStat::isReplaying()) {
+        // 列表的最后一个包实际发出时才统计发送延时
+        _pacer_stamps.emplace_back(pkt->back(), stamp);
+    }
+    // 关键帧等突发数据平滑发送
+    _pacer->flush();
+}
 
-        _reader->setMessageCB([weak_self] (const toolkit::Any &data) {
-            auto strong_self = weak_self.lock();
-            if (!strong_self) {
-                return;
-            }
-            if (data.is<Buffer>()) {
-                auto &buffer = data.get<Buffer>();
-                // PPID 51: 文本string
-                // PPID 53: 二进制
-                strong_self->sendDatachannel(0, 51, buffer.data(), buffer.size());
-            } else {
-                WarnL << "Send unknown message type to webrtc player: " << data.type_name();
-            }
-        });
+void WebRtcPlayer::onPacerSent(const RtpPacket::Ptr &rtp) {
+    if (_pacer_stamps.empty() || _pacer_stamps.front().first != rtp) {
+        return;
     }
+    auto stamp = _pacer_stamps.front().second;
+    _pacer_stamps.pop_front();
+    auto now = LatencyStat::now();
+    LatencyStat::record(LatencyStat::kRingToWebRtc, now > stamp ? now - stamp : 0);
 }
+
+bool WebRtcPlayer::switchLayer() {
+    auto src = _pending_src.lock();
+    if (!src) {
+        return false;
+    }
+    InfoL << "RTC播放器(" << _media_info.shortUrl() << ")切换simulcast层:" << src->getMediaTuple().shortUrl();
+    _play_src = src;
+    _reader = std::move(_pending_reader);
+    _pending_src.reset();
+    _layer_ticker.resetTime();
+    // 先发送完平滑发送缓存中切换前的rtp，否则接续的seq和时间戳会以旧层的rtp为基准计算
+    if (_pacer) {
+        _pacer->sendAll();
+    }
+    // 重传缓存跟随rtp源切换，发送的视频rtp seq和时间戳接续切换前的rtp
+    setRetransmitCache(src->getRetransmitCache());
+    rebaseSendRtp(TrackVideo);
+    return true;
+}
+
 void WebRtcPlayer::onDestory() {
     auto duration = getDuration();
     auto bytes_usage = getBytesUsage();
@@ -13,6 +13,7 @@
 
 #include "WebRtcTransport.h"
 #include "Rtsp/RtspMediaSource.h"
+#include "Common/PacketPacer.h"
 
 namespace mediakit {
 
@@ -27,9 +28,15 @@ protected:
     void onStartWebRTC() override;
     void onDestory() override;
     void onRtcConfigure(RtcConfigure &configure) const override;
+    void onBitrateEstimate(uint32_t bitrate) override;
 
 private:
     WebRtcPlayer(const EventPoller::Ptr &poller, const RtspMediaSource::Ptr &src, const MediaInfo &info);
+    RtspMediaSource::RingType::RingReader::Ptr attachReader(const RtspMediaSource::Ptr &src, bool use_cache);
+    RtspMediaSource::Ptr selectLayer(const RtspMediaSource::Ptr &cur, uint32_t bitrate) const;
+    bool switchLayer();
+    void sendRtpList(const RtspMediaSource::RingDataType &pkt);
+    void onPacerSent(const RtpPacket::Ptr &rtp);
 
 private:
     //媒体相关元数据
@@ -38,6 +45,17 @@ private:
     std::weak_ptr<RtspMediaSource> _play_src;
     //播放rtsp源的reader对象
     RtspMediaSource::RingType::RingReader::Ptr _reader;
+    //首次播放时同步回放的gop，仅在设置reader回调期间有效
+    std::vector<RtpPacket::Ptr> *_gop_rtps = nullptr;
+    //平滑发送rtp，开启rtc.pacerRatio时才创建
+    PacketPacer<RtpPacket::Ptr>::Ptr _pacer;
+    //平滑发送时各rtp列表的最后一个包及其写入环形缓存的时间
+    std::deque<std::pair<RtpPacket::Ptr, uint64_t> > _pacer_stamps;
+    //待切换的simulcast层，收到关键帧后才切换
+    std::weak_ptr<RtspMediaSource> _pending_src;
+    RtspMediaSource::RingType::RingReader::Ptr _pending_reader;
+    //simulcast层切换检查计时器
+    Ticker _layer_ticker;
 };
 
 }// namespace mediakit
@@ -8,11 +8,14 @@
  * may be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <thread>
 #include <iostream>
 #include <srtp2/srtp.h>
 #include "Util/base64.h"
 #include "Network/sockutil.h"
+#include "Thread/ThreadPool.h"
 #include "Common/config.h"
+#include "Common/Metrics.h"
 #include "RtpExt.h"
 #include "Rtcp/Rtcp.h"
 #include "Rtcp/RtcpFCI.h"
@@ -60,6 +63,11 @@ const string kDataChannelEcho = RTC_FIELD "datachannel_echo";
 // rtp丢包状态最长保留时间
 const string kNackMaxMS = RTC_FIELD "nackMaxMS";
 
+// poller线程负载(百分比)达到该值时，把srtp加密转移到加密线程池，置0关闭
+const string kSrtpOffloadLoad = RTC_FIELD "srtpOffloadLoad";
+// srtp加密线程池线程数，置0时为cpu核数
+const string kSrtpWorkerThreads = RTC_FIELD "srtpWorkerThreads";
+
 static onceToken token([]() {
     mINI::Instance()[kTimeOutSec] = 15;
     mINI::Instance()[kExternIP] = "";
@@ -74,12 +82,36 @@ static onceToken token([]() {
     mINI::Instance()[kDataChannelEcho] = true;
 
     mINI::Instance()[kNackMaxMS] = 3 * 1000;
+
+    mINI::Instance()[kSrtpOffloadLoad] = 80;
+    mINI::Instance()[kSrtpWorkerThreads] = 0;
 });
 
 } // namespace RTC
 
 static atomic<uint64_t> s_key { 0 };
 
+// 一次批量加密的最大rtp个数
+static constexpr size_t kMaxRtpBatchSize = 64;
+
+/**
+ * srtp加密线程池，poller线程负载过高时把rtp加密转移到此线程池
+ */
+class SrtpWorkerPool : public TaskExecutorGetterImp {
+public:
+    static SrtpWorkerPool &Instance();
+
+    EventPoller::Ptr getPoller() { return static_pointer_cast<EventPoller>(getExecutor()); }
+
+private:
+    SrtpWorkerPool() {
+        GET_CONFIG(uint32_t, thread_num, Rtc::kSrtpWorkerThreads);
+        addPoller("srtp worker", thread_num ? thread_num : thread::hardware_concurrency(), ThreadPool::PRIORITY_HIGHEST, false);
+    }
+};
+
+INSTANCE_IMP(SrtpWorkerPool)
+
 static void translateIPFromEnv(std::vector<std::string> &v) {
     for (auto iter = v.begin(); iter != v.end();) {
         if (start_with(*iter, "$")) {
@@ -480,13 +512,56 @@ void WebRtcTransport::sendRtpPacket(const char *buf, int len, bool flush, void *
         pkt->setCapacity((size_t)len + SRTP_MAX_TRAILER_LEN + 2);
         memcpy(pkt->data(), buf, len);
         onBeforeEncryptRtp(pkt->data(), len, ctx);
-        if (_srtp_session_send->EncryptRtp(reinterpret_cast<uint8_t *>(pkt->data()), &len)) {
-            pkt->setSize(len);
-            onSendSockData(std::move(pkt), flush);
+        pkt->setSize(len);
+        // flush时再批量加密发送
+        _rtp_batch.emplace_back(std::move(pkt));
+        if (flush || _rtp_batch.size() >= kMaxRtpBatchSize) {
+            flushRtpBatch(flush);
         }
     }
 }
 
+void WebRtcTransport::flushRtpBatch(bool flush) {
+    GET_CONFIG(uint32_t, offload_load, Rtc::kSrtpOffloadLoad);
+    if (!_srtp_pending && (!offload_load || getPoller()->load() < (int)offload_load)) {
+        // poller负载不高，直接在本线程加密
+        _srtp_session_send->EncryptRtpList(_rtp_batch);
+        sendRtpBatch(_rtp_batch, flush);
+        _rtp_batch.clear();
+        return;
+    }
+
+    auto pkt_list = std::make_shared<std::vector<BufferRaw::Ptr> >(std::move(_rtp_batch));
+    _rtp_batch.clear();
+
+    // 转移到加密线程池；之前的批次未发送完毕时也必须转移，防止rtp乱序
+    if (!_srtp_worker) {
+        // 同一个transport固定使用一个加密线程，保证rtp顺序
+        _srtp_worker = SrtpWorkerPool::Instance().getPoller();
+    }
+    ++_srtp_pending;
+    weak_ptr<WebRtcTransport> weak_self = shared_from_this();
+    auto srtp = _srtp_session_send;
+    auto poller = getPoller();
+    _srtp_worker->async([weak_self, srtp, poller, pkt_list, flush]() {
+        srtp->EncryptRtpList(*pkt_list);
+        poller->async([weak_self, pkt_list, flush]() {
+            auto strong_self = weak_self.lock();
+            if (!strong_self) {
+                return;
+            }
+            --strong_self->_srtp_pending;
+            strong_self->sendRtpBatch(*pkt_list, flush);
+        }, false);
+    }, false);
+}
+
+void WebRtcTransport::sendRtpBatch(std::vector<BufferRaw::Ptr> &pkt_list, bool flush) {
+    for (size_t i = 0; i < pkt_list.size(); ++i) {
+        onSendSockData(std::move(pkt_list[i]), flush && i + 1 == pkt_list.size());
+    }
+}
+
 void WebRtcTransport::sendRtcpPacket(const char *buf, int len, bool flush, void *ctx) {
     if (_srtp_session_send) {
         auto pkt = _packet_pool.obtain2();
@@ -509,7 +584,7 @@ void WebRtcTransportImp::onCreate() {
 
     weak_ptr<WebRtcTransportImp> weak_self = static_pointer_cast<WebRtcTransportImp>(shared_from_this());
     GET_CONFIG(float, timeoutSec, Rtc::kTimeOutSec);
-    _timer = std::make_shared<Timer>(
+    _timer = std::make_shared<WheelTimer>(
         timeoutSec / 2,
         [weak_self]() {
             auto strong_self = weak_self.lock();
@@ -524,6 +599,12 @@ void WebRtcTransportImp::onCreate() {
         getPoller());
 
     _twcc_ctx.setOnSendTwccCB([this](uint32_t ssrc, string fci) { onSendTwcc(ssrc, fci); });
+
+    // 配置单位为kbps
+    GET_CONFIG(uint32_t, max_bitrate, Rtc::kMaxBitrate);
+    GET_CONFIG(uint32_t, min_bitrate, Rtc::kMinBitrate);
+    GET_CONFIG(uint32_t, start_bitrate, Rtc::kStartBitrate);
+    _bwe.setParams(start_bitrate * 1000, min_bitrate * 1000, max_bitrate * 1000);
 }
 
 void WebRtcTransportImp::OnDtlsTransportApplicationDataReceived(const RTC::DtlsTransport *dtlsTransport, const uint8_t *data, size_t len) {
@@ -557,6 +638,15 @@ void WebRtcTransportImp::onSendSockData(Buffer::Ptr buf, bool flush, RTC::Transp
         }
     }
 
+    if (tuple->getSock()->sockType() == SockNum::Sock_UDP && UdpBatchSender::isEnabled()) {
+        // udp批量发送，flush时一次系统调用发送一帧的rtp数据
+        _batch_sender.inputPacket(std::move(buf));
+        if (flush) {
+            _batch_sender.flush(tuple->getSock());
+        }
+        return;
+    }
+
     // 一次性发送一帧的rtp数据，提高网络io性能
     if (tuple->getSock()->sockType() == SockNum::Sock_TCP) {
         // 增加tcp两字节头
@@ -843,7 +933,7 @@ private:
             return;
         }
         weak_ptr<RtpChannel> weak_self = shared_from_this();
-        _delay_task = _poller->doDelayTask(10, [weak_self]() -> uint64_t {
+        _delay_task = TimerWheel::doDelayTask(_poller, 10, [weak_self]() -> uint64_t {
             auto strong_self = weak_self.lock();
             if (!strong_self) {
                 return 0;
@@ -865,7 +955,7 @@ private:
     NackContext _nack_ctx;
     RtcpContextForRecv _rtcp_context;
     EventPoller::Ptr _poller;
-    EventPoller::DelayTask::Ptr _delay_task;
+    TimerWheel::Task::Ptr _delay_task;
     function<void(const FCI_NACK &nack)> _on_nack;
 };
 
@@ -893,6 +983,7 @@ float WebRtcTransportImp::getLossRate(TrackType type) {
 
 void WebRtcTransportImp::onRtcp(const char *buf, size_t len) {
     _bytes_usage += len;
+    Metrics::add(Metrics::kWebRtcBytesIn, len);
     auto rtcps = RtcpHeader::loadFromBytes((char *)buf, len);
     for (auto rtcp : rtcps) {
         switch ((RtcpType)rtcp->pt) {
@@ -928,6 +1019,11 @@ void WebRtcTransportImp::onRtcp(const char *buf, size_t len) {
                     track->rtcp_context_send->onRtcp(rtcp);
                     auto sr = track->rtcp_context_send->createRtcpSR(track->answer_ssrc_rtp);
                     sendRtcpPacket(sr->data(), sr->size(), true);
+                    if (track->media->type == TrackVideo) {
+                        // 没有twcc反馈时，根据rr中的丢包率估计带宽
+                        _bwe.onReceiverReport(item->fraction);
+                        onBitrateEstimate(_bwe.getEstimate());
+                    }
                 } else {
                     WarnL << "未识别的rr rtcp包:" << rtcp->dumpString();
                 }
@@ -952,10 +1048,23 @@ void WebRtcTransportImp::onRtcp(const char *buf, size_t len) {
         case RtcpType::RTCP_PSFB:
         case RtcpType::RTCP_RTPFB: {
             if ((RtcpType)rtcp->pt == RtcpType::RTCP_PSFB) {
+                if ((PSFBType)rtcp->report_count == PSFBType::RTCP_PSFB_REMB) {
+                    // 播放端反馈的最大码率
+                    RtcpFB *fb = (RtcpFB *)rtcp;
+                    _bwe.onRemb(fb->getFci<FCI_REMB>().getBitRate());
+                    onBitrateEstimate(_bwe.getEstimate());
+                }
                 break;
             }
             // RTPFB
             switch ((RTPFBType)rtcp->report_count) {
+            case RTPFBType::RTCP_RTPFB_TWCC: {
+                // 播放端反馈的transport-cc接收情况
+                RtcpFB *fb = (RtcpFB *)rtcp;
+                _bwe.onTwcc(fb->getFci<FCI_TWCC>(), fb->getFciSize());
+                onBitrateEstimate(_bwe.getEstimate());
+                break;
+            }
             case RTPFBType::RTCP_RTPFB_NACK: {
                 RtcpFB *fb = (RtcpFB *)rtcp;
                 auto it = _ssrc_to_track.find(fb->ssrc_media);
@@ -1023,6 +1132,7 @@ void WebRtcTransportImp::updateTicker() {
 
 void WebRtcTransportImp::onRtp(const char *buf, size_t len, uint64_t stamp_ms) {
     _bytes_usage += len;
+    Metrics::add(Metrics::kWebRtcBytesIn, len);
     _alive_ticker.resetTime();
 
     RtpHeader *rtp = (RtpHeader *)buf;
@@ -1131,6 +1241,21 @@ void WebRtcTransportImp::onSortedRtp(MediaTrack &track, const string &rid, RtpPa
 
 ///////////////////////////////////////////////////////////////////
 
+void WebRtcTransportImp::setRetransmitCache(const RtpRetransmitCache::Ptr &cache) {
+    for (auto &track : _type_to_track) {
+        if (track) {
+            track->nack_list.setSharedCache(cache, track->media->type);
+        }
+    }
+}
+
+void WebRtcTransportImp::rebaseSendRtp(TrackType type) {
+    auto &track = _type_to_track[type];
+    if (track) {
+        track->rebase_send = true;
+    }
+}
+
 void WebRtcTransportImp::onSendRtp(const RtpPacket::Ptr &rtp, bool flush, bool rtx) {
     auto &track = _type_to_track[rtp->type];
     if (!track) {
@@ -1138,9 +1263,23 @@ void WebRtcTransportImp::onSendRtp(const RtpPacket::Ptr &rtp, bool flush, bool r
         return;
     }
     if (!rtx) {
+        if (track->rebase_send) {
+            // 切换了rtp源，新的seq接续上一个rtp，时间戳按照ntp时间差接续
+            track->rebase_send = false;
+            uint64_t delta_ms = 1;
+            if (track->last_send_ntp && rtp->ntp_stamp > track->last_send_ntp) {
+                delta_ms = rtp->ntp_stamp - track->last_send_ntp;
+            }
+            track->send_seq_offset = track->last_send_seq + 1 - rtp->getSeq();
+            track->send_stamp_offset = track->last_send_stamp + (uint32_t)(delta_ms * rtp->sample_rate / 1000) - rtp->getStamp();
+            track->nack_list.setSeqOffset(track->send_seq_offset, rtp->getSeq());
+        }
+        track->last_send_seq = rtp->getSeq() + track->send_seq_offset;
+        track->last_send_stamp = rtp->getStamp() + track->send_stamp_offset;
+        track->last_send_ntp = rtp->ntp_stamp;
         // 统计rtp发送情况，好做sr汇报
         track->rtcp_context_send->onRtp(
-            rtp->getSeq(), rtp->getStamp(), rtp->ntp_stamp, rtp->sample_rate,
+            track->last_send_seq, track->last_send_stamp, rtp->ntp_stamp, rtp->sample_rate,
             rtp->size() - RtpPacket::kRtpTcpHeaderSize);
         track->nack_list.pushBack(rtp);
 #if 0
@@ -1155,21 +1294,31 @@ void WebRtcTransportImp::onSendRtp(const RtpPacket::Ptr &rtp, bool flush, bool r
     }
     pair<bool /*rtx*/, MediaTrack *> ctx { rtx, track.get() };
     sendRtpPacket(rtp->data() + RtpPacket::kRtpTcpHeaderSize, rtp->size() - RtpPacket::kRtpTcpHeaderSize, flush, &ctx);
+    _bwe.onSendRtp(rtp->size() - RtpPacket::kRtpTcpHeaderSize);
     _bytes_usage += rtp->size() - RtpPacket::kRtpTcpHeaderSize;
+    Metrics::add(Metrics::kWebRtcBytesOut, rtp->size() - RtpPacket::kRtpTcpHeaderSize);
 }
 
 void WebRtcTransportImp::onBeforeEncryptRtp(const char *buf, int &len, void *ctx) {
     auto pr = (pair<bool /*rtx*/, MediaTrack *> *)ctx;
     auto header = (RtpHeader *)buf;
 
+    auto twcc_ext = pr->second->rtp_ext_ctx->changeRtpExtId(header, false, nullptr, RtpExtType::transport_cc);
+    if (twcc_ext) {
+        // transport-cc扩展seq由本端统一分配，并记录发送历史用于带宽估计
+        twcc_ext.setTransportCCSeq(_twcc_send_seq);
+        _bwe.onSendTwccRtp(_twcc_send_seq++, len);
+    }
+    // 切换rtp源后，保持seq和时间戳连续
+    header->seq = htons(ntohs(header->seq) + pr->second->send_seq_offset);
+    header->stamp = htonl(ntohl(header->stamp) + pr->second->send_stamp_offset);
+
     if (!pr->first || !pr->second->plan_rtx) {
         // 普通的rtp,或者不支持rtx, 修改目标pt和ssrc
-        pr->second->rtp_ext_ctx->changeRtpExtId(header, false);
         header->pt = pr->second->plan_rtp->pt;
         header->ssrc = htonl(pr->second->answer_ssrc_rtp);
     } else {
         // 重传的rtp, rtx
-        pr->second->rtp_ext_ctx->changeRtpExtId(header, false);
         header->pt = pr->second->plan_rtx->pt;
         if (pr->second->answer_ssrc_rtx) {
             // 有rtx单独的ssrc,有些情况下，浏览器支持rtx，但是未指定rtx单独的ssrc
@@ -23,8 +23,11 @@
 #include "Network/Session.h"
 #include "Nack.h"
 #include "TwccContext.h"
+#include "SendSideBwe.h"
 #include "SctpAssociation.hpp"
 #include "Rtcp/RtcpContext.h"
+#include "Common/UdpBatchSender.h"
+#include "Common/TimerWheel.h"
 
 namespace mediakit {
 
@@ -168,6 +171,8 @@ protected:
 private:
     void sendSockData(const char *buf, size_t len, RTC::TransportTuple *tuple);
     void setRemoteDtlsFingerprint(const RtcSession &remote);
+    void flushRtpBatch(bool flush);
+    void sendRtpBatch(std::vector<BufferRaw::Ptr> &pkt_list, bool flush);
 
 protected:
     RtcSession::Ptr _offer_sdp;
@@ -184,6 +189,12 @@ private:
     Ticker _ticker;
     // 循环池
     ResourcePool<BufferRaw> _packet_pool;
+    // 待批量加密的rtp
+    std::vector<BufferRaw::Ptr> _rtp_batch;
+    // 已经转移到加密线程池但尚未发送的批次数
+    size_t _srtp_pending = 0;
+    // 加密线程
+    EventPoller::Ptr _srtp_worker;
 
 #ifdef ENABLE_SCTP
     RTC::SctpAssociationImp::Ptr _sctp;
@@ -206,6 +217,13 @@ public:
     //for send rtp
     NackList nack_list;
     RtcpContext::Ptr rtcp_context_send;
+    //切换simulcast层后需要重新计算发送rtp的seq和时间戳偏移量，保证播放端收到的rtp连续
+    bool rebase_send = false;
+    uint16_t send_seq_offset = 0;
+    uint32_t send_stamp_offset = 0;
+    uint16_t last_send_seq = 0;
+    uint32_t last_send_stamp = 0;
+    uint64_t last_send_ntp = 0;
 
     //for recv rtp
     std::unordered_map<std::string/*rid*/, std::shared_ptr<RtpChannel> > rtp_channel;
@@ -276,6 +294,12 @@ protected:
     void updateTicker();
     float getLossRate(TrackType type);
     void onRtcpBye() override;
+    // 使用rtsp源共享的rtp重传缓存响应nack
+    void setRetransmitCache(const RtpRetransmitCache::Ptr &cache);
+    // 切换rtp源后调用，此后发送的rtp seq和时间戳接续之前的rtp
+    void rebaseSendRtp(TrackType type);
+    // 发送端带宽估计更新时触发，单位bps
+    virtual void onBitrateEstimate(uint32_t bitrate) {}
 
 private:
     void onSortedRtp(MediaTrack &track, const std::string &rid, RtpPacket::Ptr rtp);
@@ -295,13 +319,17 @@ private:
     //保持自我强引用
     Ptr _self;
     //检测超时的定时器
-    Timer::Ptr _timer;
+    WheelTimer::Ptr _timer;
     //刷新计时器
     Ticker _alive_ticker;
     //pli rtcp计时器
     Ticker _pli_ticker;
     //twcc rtcp发送上下文对象
     TwccContext _twcc_ctx;
+    //发送端带宽估计
+    SendSideBwe _bwe;
+    //发送rtp的transport-cc扩展seq
+    uint16_t _twcc_send_seq = 0;
     //根据发送rtp的track类型获取相关信息
     MediaTrack::Ptr _type_to_track[2];
     //根据rtcp的ssrc获取相关信息，收发rtp和rtx的ssrc都会记录
@@ -311,6 +339,8 @@ private:
     std::vector<SdpAttrCandidate> _cands;
     //http访问时的host ip
     std::string _local_ip;
+    //udp批量发送器
+    UdpBatchSender _batch_sender;
 };
 
 class WebRtcTransportManager {